@@ -278,6 +278,8 @@ class CombineModelsLogic(ScriptedLoadableModuleLogic):
     Called when the logic class is instantiated. Can be used for initializing member variables.
     """
     ScriptedLoadableModuleLogic.__init__(self)
+    self.progressiveFilter = None
+    self.progressiveTimer = None
 
   def setDefaultParameters(self, parameterNode):
     """
@@ -286,7 +288,7 @@ class CombineModelsLogic(ScriptedLoadableModuleLogic):
     if not parameterNode.GetParameter("Operation"):
       parameterNode.SetParameter("Operation", "union")
 
-  def process(self, inputModelA, inputModelB, outputModel, operation):
+  def process(self, inputModelA, inputModelB, outputModel, operation, preview=False, computeVolumes=False):
     """
     Run the processing algorithm.
     Can be used without GUI widget.
@@ -294,6 +296,9 @@ class CombineModelsLogic(ScriptedLoadableModuleLogic):
     :param inputModelB: second input model node
     :param outputModel: result model node, if empty then a new output node will be created
     :param operation: union, intersection, difference, difference2
+    :param preview: if True then a fast, voxel based approximation of the result is computed
+    :param computeVolumes: if True then the volume of the intersection of the inputs is computed and returned
+    :return: volume of the intersection of the inputs (removed volume for a difference), None for a preview or without computeVolumes
     """
 
     if not inputModelA or not inputModelB or not outputModel:
@@ -305,51 +310,214 @@ class CombineModelsLogic(ScriptedLoadableModuleLogic):
 
     import vtkSlicerCombineModelsModuleLogicPython as vtkbool
 
-    combine = vtkbool.vtkPolyDataBooleanFilter()
+    if preview:
+      combine = vtkbool.vtkBooleanPreviewFilter()
+    else:
+      combine = vtkbool.vtkPolyDataBooleanFilter()
+
+    self.setOperMode(combine, operation)
+
+    self.setInputConnection(combine, 0, inputModelA, outputModel)
+    self.setInputConnection(combine, 1, inputModelB, outputModel)
+
+    # These parameters might be useful to expose:
+    # combine.MergeRegsOn()  # default off
+    # combine.DecPolysOff()  # default on
+    if computeVolumes and not preview:
+      # volumes are computed while the result is assembled, no extra pass is needed
+      combine.ComputeVolumesOn()
+    combine.Update()
+
+    outputModel.SetAndObservePolyData(combine.GetOutput())
+    outputModel.CreateDefaultDisplayNodes()
+    # The filter creates a few scalars, don't show them by default, as they would be somewhat distracting
+    outputModel.GetDisplayNode().SetScalarVisibility(False)
+
+    stopTime = time.time()
+    logging.info('Processing completed in {0:.2f} seconds'.format(stopTime-startTime))
+
+    return combine.GetIntersectionVolume() if computeVolumes and not preview else None
+
+  def processProgressive(self, inputModelA, inputModelB, outputModel, operation):
+    """
+    Show a result computed on decimated inputs immediately and replace it by the
+    full resolution result when the background computation has finished.
+    The decimated inputs are kept, so that repeated runs on the same inputs are fast.
+    :param inputModelA: first input model node
+    :param inputModelB: second input model node
+    :param outputModel: result model node
+    :param operation: union, intersection, difference, difference2
+    """
+
+    if not inputModelA or not inputModelB or not outputModel:
+      raise ValueError("Input or output model nodes are invalid")
 
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    if not self.progressiveFilter:
+      self.progressiveFilter = vtkbool.vtkProgressiveBooleanFilter()
+      self.progressiveTimer = qt.QTimer()
+      self.progressiveTimer.setInterval(100)
+    else:
+      self.progressiveTimer.disconnect("timeout()")
+
+    combine = self.progressiveFilter
+    self.setOperMode(combine, operation)
+    self.setInputConnection(combine, 0, inputModelA, outputModel)
+    self.setInputConnection(combine, 1, inputModelB, outputModel)
+    combine.Update()
+
+    outputModel.SetAndObservePolyData(combine.GetOutput())
+    outputModel.CreateDefaultDisplayNodes()
+    outputModel.GetDisplayNode().SetScalarVisibility(False)
+
+    def onTimeout():
+      if combine.Poll():
+        combine.Update()
+        outputModel.SetAndObservePolyData(combine.GetOutput())
+      if combine.GetLevel() == 1:
+        self.progressiveTimer.stop()
+
+    self.progressiveTimer.connect("timeout()", onTimeout)
+    if combine.GetLevel() == 0:
+      self.progressiveTimer.start()
+
+  def subtractAtPoses(self, inputModel, toolModel, transformNodes, outputModel):
+    """
+    Subtract the tool model placed at each of the given poses from the input model in one pass.
+    Poses that do not touch the input are skipped, overlapping poses are united first.
+    :param inputModel: model to cut
+    :param toolModel: tool model, in the coordinate system of inputModel
+    :param transformNodes: linear transform nodes, one per pose
+    :param outputModel: result model node
+    """
+
+    if not inputModel or not toolModel or not outputModel:
+      raise ValueError("Input or output model nodes are invalid")
+
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    combine = vtkbool.vtkMultiPoseDifferenceFilter()
+    for transformNode in transformNodes:
+      matrix = vtk.vtkMatrix4x4()
+      transformNode.GetMatrixTransformToParent(matrix)
+      combine.AddPose(matrix)
+
+    self.setInputConnection(combine, 0, inputModel, outputModel)
+    self.setInputConnection(combine, 1, toolModel, outputModel)
+    combine.Update()
+
+    outputModel.SetAndObservePolyData(combine.GetOutput())
+    outputModel.CreateDefaultDisplayNodes()
+    outputModel.GetDisplayNode().SetScalarVisibility(False)
+
+  def setOperMode(self, algorithm, operation):
     if operation == 'union':
-      combine.SetOperModeToUnion()
+      algorithm.SetOperModeToUnion()
     elif operation == 'intersection':
-      combine.SetOperModeToIntersection()
+      algorithm.SetOperModeToIntersection()
     elif operation == 'difference':
-      combine.SetOperModeToDifference()
+      algorithm.SetOperModeToDifference()
     elif operation == 'difference2':
-      combine.SetOperModeToDifference2()
+      algorithm.SetOperModeToDifference2()
     else:
       raise ValueError("Invalid operation: "+operation)
 
-    if inputModelA.GetParentTransformNode() == outputModel.GetParentTransformNode():
-      combine.SetInputConnection(0, inputModelA.GetPolyDataConnection())
+  def setInputConnection(self, algorithm, port, inputModel, outputModel):
+    """
+    Connect the polydata of inputModel, transformed into the coordinate system of outputModel, to the given input port.
+    """
+    if inputModel.GetParentTransformNode() == outputModel.GetParentTransformNode():
+      algorithm.SetInputConnection(port, inputModel.GetPolyDataConnection())
     else:
       transformToOutput = vtk.vtkGeneralTransform()
-      slicer.vtkMRMLTransformNode.GetTransformBetweenNodes(inputModelA.GetParentTransformNode(), outputModel.GetParentTransformNode(), transformToOutput)
+      slicer.vtkMRMLTransformNode.GetTransformBetweenNodes(inputModel.GetParentTransformNode(), outputModel.GetParentTransformNode(), transformToOutput)
       transformer = vtk.vtkTransformPolyDataFilter()
       transformer.SetTransform(transformToOutput)
-      transformer.SetInputConnection(inputModelA.GetPolyDataConnection())
-      combine.SetInputConnection(0, transformer.GetOutputPort())
+      transformer.SetInputConnection(inputModel.GetPolyDataConnection())
+      algorithm.SetInputConnection(port, transformer.GetOutputPort())
 
-    if inputModelB.GetParentTransformNode() == outputModel.GetParentTransformNode():
-      combine.SetInputConnection(1, inputModelB.GetPolyDataConnection())
-    else:
-      transformToOutput = vtk.vtkGeneralTransform()
-      slicer.vtkMRMLTransformNode.GetTransformBetweenNodes(inputModelB.GetParentTransformNode(), outputModel.GetParentTransformNode(), transformToOutput)
-      transformer = vtk.vtkTransformPolyDataFilter()
-      transformer.SetTransform(transformToOutput)
-      transformer.SetInputConnection(inputModelB.GetPolyDataConnection())
-      combine.SetInputConnection(1, transformer.GetOutputPort())
+  def intersectionCurves(self, inputModelA, inputModelB, outputModel):
+    """
+    Compute only the intersection curves of the two surfaces, without the boolean result.
+    The output contains one polyline per curve, with the OrigCellIdsA/OrigCellIdsB point arrays
+    identifying the intersecting cells and a Closed cell array.
+    :param inputModelA: first input model node
+    :param inputModelB: second input model node
+    :param outputModel: model node that receives the curves
+    """
 
-    # These parameters might be useful to expose:
-    # combine.MergeRegsOn()  # default off
-    # combine.DecPolysOff()  # default on
-    combine.Update()
+    if not inputModelA or not inputModelB or not outputModel:
+      raise ValueError("Input or output model nodes are invalid")
 
-    outputModel.SetAndObservePolyData(combine.GetOutput())
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    contact = vtkbool.vtkPolyDataContactFilter()
+    contact.PolyLinesOn()
+    self.setInputConnection(contact, 0, inputModelA, outputModel)
+    self.setInputConnection(contact, 1, inputModelB, outputModel)
+    contact.Update()
+
+    outputModel.SetAndObservePolyData(contact.GetOutput())
     outputModel.CreateDefaultDisplayNodes()
-    # The filter creates a few scalars, don't show them by default, as they would be somewhat distracting
     outputModel.GetDisplayNode().SetScalarVisibility(False)
 
-    stopTime = time.time()
-    logging.info('Processing completed in {0:.2f} seconds'.format(stopTime-startTime))
+  def proximity(self, inputModelA, inputModelB, outputModel=None):
+    """
+    Compute the minimum distance between the two surfaces. If they intersect, compute the maximum depth of a vertex
+    inside the other surface instead. This is not the true penetration depth: if only edges interpenetrate and no
+    vertex is inside, it is 0.
+    :param inputModelA: first input model node
+    :param inputModelB: second input model node
+    :param outputModel: optional model node that receives the line between the two closest points, or between the
+      deepest vertex and the closest point on the other surface
+    :return: distance between the surfaces, or the negated maximum vertex depth if they intersect
+    """
+
+    if not inputModelA or not inputModelB:
+      raise ValueError("Input model nodes are invalid")
+
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    referenceModel = outputModel if outputModel else inputModelA
+
+    proximity = vtkbool.vtkPolyDataProximityFilter()
+    self.setInputConnection(proximity, 0, inputModelA, referenceModel)
+    self.setInputConnection(proximity, 1, inputModelB, referenceModel)
+    proximity.Update()
+
+    if outputModel:
+      outputModel.SetAndObservePolyData(proximity.GetOutput())
+      outputModel.CreateDefaultDisplayNodes()
+
+    return proximity.GetDistance()
+
+  def clearance(self, inputModelA, inputModelB, outputModel, maximumDistance=None):
+    """
+    Compute the signed distance of each point of model A to the surface of model B, negative inside B.
+    The output is a copy of model A with the distances as active point scalars named Distance.
+    :param inputModelA: model whose points are evaluated
+    :param inputModelB: closed, outward oriented reference surface
+    :param outputModel: model node that receives the result
+    :param maximumDistance: points farther away get this magnitude, which speeds up the computation
+    """
+
+    if not inputModelA or not inputModelB or not outputModel:
+      raise ValueError("Input or output model nodes are invalid")
+
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    clearance = vtkbool.vtkPolyDataClearanceFilter()
+    if maximumDistance is not None:
+      clearance.SetMaximumDistance(maximumDistance)
+    self.setInputConnection(clearance, 0, inputModelA, outputModel)
+    self.setInputConnection(clearance, 1, inputModelB, outputModel)
+    clearance.Update()
+
+    outputModel.SetAndObservePolyData(clearance.GetOutput())
+    outputModel.CreateDefaultDisplayNodes()
+    outputModel.GetDisplayNode().SetActiveScalarName("Distance")
+    outputModel.GetDisplayNode().SetScalarVisibility(True)
 
 #
 # CombineModelsTest
@@ -372,6 +540,36 @@ class CombineModelsTest(ScriptedLoadableModuleTest):
     """
     self.setUp()
     self.test_CombineModels1()
+    self.setUp()
+    self.test_PairSearchTiles()
+    self.setUp()
+    self.test_MappedMeshReader()
+    self.setUp()
+    self.test_Primitives()
+    self.setUp()
+    self.test_Progressive()
+    self.setUp()
+    self.test_Localized()
+    self.setUp()
+    self.test_MultiPoseDifference()
+    self.setUp()
+    self.test_Proximity()
+    self.setUp()
+    self.test_Clearance()
+    self.setUp()
+    self.test_SnapRounding()
+    self.setUp()
+    self.test_DegenerateContacts()
+    self.setUp()
+    self.test_RefitTrees()
+    self.setUp()
+    self.test_ValidateInputs()
+    self.setUp()
+    self.test_AttachIndex()
+    self.setUp()
+    self.test_DeterministicPolicy()
+    self.setUp()
+    self.test_SeamWelding()
 
   def test_CombineModels1(self):
     """ Ideally you should have several levels of tests.  At the lowest level
@@ -402,9 +600,919 @@ class CombineModelsTest(ScriptedLoadableModuleTest):
 
     logic = CombineModelsLogic()
 
+    intersectionVolumes = {}
     for operation in ['union', 'intersection', 'difference', 'difference2']:
       outputModel = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLModelNode", 'Output '+operation)
-      logic.process(inputModelA, inputModelB, outputModel, operation)
+      intersectionVolumes[operation] = logic.process(inputModelA, inputModelB, outputModel, operation, computeVolumes=True)
       self.assertTrue(outputModel.GetPolyData().GetNumberOfPoints()>0)
+      self.assertGreater(intersectionVolumes[operation], 0)
+
+    # the removed volume and the remaining volume add up to the volume of the sphere
+    sphereVolume = self.volume(inputModelA.GetPolyData())
+    remainingVolume = self.volume(slicer.mrmlScene.GetFirstNodeByName('Output difference').GetPolyData())
+    self.assertAlmostEqual(intersectionVolumes['difference']+remainingVolume, sphereVolume, delta=1e-3*sphereVolume)
+
+    # the preview deviates by up to about half a voxel across the surface of the exact result
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+    boundingBox = vtk.vtkBoundingBox(inputModelA.GetPolyData().GetBounds())
+    boundingBox.AddBounds(inputModelB.GetPolyData().GetBounds())
+    spacing = boundingBox.GetMaxLength()/vtkbool.vtkBooleanPreviewFilter().GetResolution()
+    for operation in ['union', 'intersection', 'difference']:
+      previewModel = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLModelNode", 'Preview '+operation)
+      logic.process(inputModelA, inputModelB, previewModel, operation, preview=True)
+      self.assertTrue(previewModel.GetPolyData().GetNumberOfPoints()>0)
+      exact = slicer.mrmlScene.GetFirstNodeByName('Output '+operation).GetPolyData()
+      self.assertAlmostEqual(self.volume(previewModel.GetPolyData()), self.volume(exact), delta=0.5*spacing*self.surfaceArea(exact))
+
+    curvesModel = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLModelNode", 'Intersection curves')
+    logic.intersectionCurves(inputModelA, inputModelB, curvesModel)
+    # the cylinder passes through the sphere, both ends stick out and give one closed curve each
+    self.assertEqual(curvesModel.GetPolyData().GetNumberOfLines(), 2)
+
+    # the cylinder sticks into the sphere
+    self.assertLess(logic.proximity(inputModelA, inputModelB), 0)
+
+    clearanceModel = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLModelNode", 'Clearance')
+    logic.clearance(inputModelA, inputModelB, clearanceModel)
+    distances = clearanceModel.GetPolyData().GetPointData().GetArray("Distance")
+    # the sphere is partly inside and partly outside of the cylinder
+    self.assertLess(distances.GetRange()[0], 0)
+    self.assertGreater(distances.GetRange()[1], 0)
+
+    self.delayDisplay('Test passed')
+
+  def volume(self, polyData):
+    triangles = vtk.vtkTriangleFilter()
+    triangles.SetInputData(polyData)
+    massProperties = vtk.vtkMassProperties()
+    massProperties.SetInputConnection(triangles.GetOutputPort())
+    massProperties.Update()
+    return massProperties.GetVolume()
+
+  def surfaceArea(self, polyData):
+    triangles = vtk.vtkTriangleFilter()
+    triangles.SetInputData(polyData)
+    massProperties = vtk.vtkMassProperties()
+    massProperties.SetInputConnection(triangles.GetOutputPort())
+    massProperties.Update()
+    return massProperties.GetSurfaceArea()
+
+  def numberOfOpenEdges(self, polyData):
+    # without SeamWelding the parts of A and B only share coincident points along the seam
+    clean = vtk.vtkCleanPolyData()
+    clean.SetInputData(polyData)
+    clean.SetTolerance(0)
+    edges = vtk.vtkFeatureEdges()
+    edges.SetInputConnection(clean.GetOutputPort())
+    edges.BoundaryEdgesOn()
+    edges.NonManifoldEdgesOn()
+    edges.FeatureEdgesOff()
+    edges.ManifoldEdgesOff()
+    edges.Update()
+    return edges.GetOutput().GetNumberOfCells()
+
+  def errorMessages(self, algorithm):
+    messages = []
+    @vtk.calldata_type(vtk.VTK_STRING)
+    def onError(caller, event, message):
+      messages.append(message)
+    algorithm.AddObserver(vtk.vtkCommand.ErrorEvent, onError)
+    return messages
+
+  def operands(self):
+    sphere = vtk.vtkSphereSource()
+    sphere.SetRadius(30)
+    sphere.SetThetaResolution(32)
+    sphere.SetPhiResolution(32)
+    sphere.Update()
+
+    cylinder = vtk.vtkCylinderSource()
+    cylinder.SetRadius(20)
+    cylinder.SetHeight(75)
+    cylinder.SetResolution(24)
+    cylinder.Update()
+
+    return sphere.GetOutput(), cylinder.GetOutput()
+
+  def difference(self, polyDataA, polyDataB, **options):
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+    combine = vtkbool.vtkPolyDataBooleanFilter()
+    combine.SetOperModeToDifference()
+    combine.SetInputData(0, polyDataA)
+    combine.SetInputData(1, polyDataB)
+    for name, value in options.items():
+      getattr(combine, 'Set'+name)(value)
+    combine.Update()
+    return combine
+
+  def test_PairSearchTiles(self):
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the tiled pair search test")
+
+    sphere, cylinder = self.operands()
+
+    # the tiles only change which trees are searched, the contact lines stay the same
+    lines = []
+    for tileSize in [0, 7.5]:
+      contact = vtkbool.vtkPolyDataContactFilter()
+      contact.SetInputData(0, sphere)
+      contact.SetInputData(1, cylinder)
+      contact.SetPairSearchTileSize(tileSize)
+      contact.Update()
+      lines.append(contact.GetOutput().GetNumberOfCells())
+    self.assertGreater(lines[0], 0)
+    self.assertEqual(lines[0], lines[1])
+
+    # a tile size that would give billions of tiles is enlarged
+    warnings = []
+    @vtk.calldata_type(vtk.VTK_STRING)
+    def onWarning(caller, event, message):
+      warnings.append(message)
+    contact = vtkbool.vtkPolyDataContactFilter()
+    contact.AddObserver(vtk.vtkCommand.WarningEvent, onWarning)
+    contact.SetInputData(0, sphere)
+    contact.SetInputData(1, cylinder)
+    contact.SetPairSearchTileSize(1e-4)
+    contact.Update()
+    self.assertEqual(contact.GetOutput().GetNumberOfCells(), lines[0])
+    self.assertTrue(any('tiles' in message for message in warnings))
+
+    full = self.difference(sphere, cylinder).GetOutput()
+    tiled = self.difference(sphere, cylinder, PairSearchTileSize=7.5).GetOutput()
+    self.assertEqual(tiled.GetNumberOfCells(), full.GetNumberOfCells())
+    self.assertAlmostEqual(self.volume(tiled), self.volume(full), delta=1e-6*self.volume(full))
+    self.assertEqual(self.numberOfOpenEdges(tiled), 0)
+
+    self.delayDisplay('Test passed')
+
+  def test_MappedMeshReader(self):
+    import os
+    import struct
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the mapped reader test")
+
+    sphere, cylinder = self.operands()
+    triangles = vtk.vtkTriangleFilter()
+    triangles.SetInputData(cylinder)
+    triangles.Update()
+
+    # the welded stl has the same points and triangles as the one read by vtkSTLReader
+    stlFileName = os.path.join(slicer.app.temporaryPath, 'CombineModelsTest.stl')
+    stlWriter = vtk.vtkSTLWriter()
+    stlWriter.SetInputData(triangles.GetOutput())
+    stlWriter.SetFileTypeToBinary()
+    stlWriter.SetFileName(stlFileName)
+    stlWriter.Write()
+
+    stlReader = vtk.vtkSTLReader()
+    stlReader.SetFileName(stlFileName)
+    stlReader.Update()
+
+    self.assertTrue(vtkbool.vtkMappedMeshReader.CanReadFile(stlFileName))
+    reader = vtkbool.vtkMappedMeshReader()
+    reader.SetFileName(stlFileName)
+    reader.Update()
+    self.assertEqual(reader.GetOutput().GetNumberOfPoints(), stlReader.GetOutput().GetNumberOfPoints())
+    self.assertEqual(reader.GetOutput().GetNumberOfCells(), stlReader.GetOutput().GetNumberOfCells())
+    self.assertAlmostEqual(self.volume(reader.GetOutput()), self.volume(stlReader.GetOutput()), delta=1e-6*self.volume(stlReader.GetOutput()))
+
+    # the ply keeps its points and faces
+    plyFileName = os.path.join(slicer.app.temporaryPath, 'CombineModelsTest.ply')
+    plyWriter = vtk.vtkPLYWriter()
+    plyWriter.SetInputData(sphere)
+    plyWriter.SetFileTypeToBinary()
+    plyWriter.SetFileName(plyFileName)
+    plyWriter.Write()
+
+    reader = vtkbool.vtkMappedMeshReader()
+    reader.SetFileName(plyFileName)
+    reader.Update()
+    self.assertEqual(reader.GetOutput().GetNumberOfPoints(), sphere.GetNumberOfPoints())
+    self.assertEqual(reader.GetOutput().GetNumberOfCells(), sphere.GetNumberOfCells())
+    self.assertAlmostEqual(self.volume(reader.GetOutput()), self.volume(sphere), delta=1e-6*self.volume(sphere))
+
+    # a face that refers to a missing vertex is rejected
+    badFileName = os.path.join(slicer.app.temporaryPath, 'CombineModelsTestBad.ply')
+    header = ("ply\nformat binary_little_endian 1.0\nelement vertex 3\nproperty float x\nproperty float y\nproperty float z\n"
+      "element face 1\nproperty list uchar int vertex_indices\nend_header\n")
+    with open(badFileName, 'wb') as f:
+      f.write(header.encode('ascii'))
+      f.write(struct.pack('<9f', 0, 0, 0, 1, 0, 0, 0, 1, 0))
+      f.write(struct.pack('<B3i', 3, 0, 1, 5))
+
+    reader = vtkbool.vtkMappedMeshReader()
+    reader.SetFileName(badFileName)
+    messages = self.errorMessages(reader)
+    reader.Update()
+    self.assertEqual(reader.GetOutput().GetNumberOfCells(), 0)
+    self.assertTrue(any('face indices outside' in message for message in messages))
+
+    # as well as a truncated one
+    with open(badFileName, 'wb') as f:
+      f.write(header.encode('ascii'))
+      f.write(struct.pack('<9f', 0, 0, 0, 1, 0, 0, 0, 1, 0))
+      f.write(struct.pack('<B2i', 3, 0, 1))
+
+    reader = vtkbool.vtkMappedMeshReader()
+    reader.SetFileName(badFileName)
+    messages = self.errorMessages(reader)
+    reader.Update()
+    self.assertEqual(reader.GetOutput().GetNumberOfCells(), 0)
+    self.assertTrue(any('truncated' in message for message in messages))
+
+    # the format may follow a long comment
+    with open(badFileName, 'wb') as f:
+      f.write(("ply\n"+"comment "+"x"*200+"\n"+header[4:]).encode('ascii'))
+      f.write(struct.pack('<9f', 0, 0, 0, 1, 0, 0, 0, 1, 0))
+      f.write(struct.pack('<B3i', 3, 0, 1, 2))
+    self.assertTrue(vtkbool.vtkMappedMeshReader.CanReadFile(badFileName))
+
+    # an stl with a NaN coordinate is rejected before the points are welded
+    nanFileName = os.path.join(slicer.app.temporaryPath, 'CombineModelsTestNaN.stl')
+    with open(nanFileName, 'wb') as f:
+      f.write(b'\0'*80)
+      f.write(struct.pack('<I', 2))
+      f.write(struct.pack('<12fH', 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0))
+      f.write(struct.pack('<12fH', 0, 0, 1, 0, 0, 0, 1, 0, 0, float('nan'), 1, 0, 0))
+
+    reader = vtkbool.vtkMappedMeshReader()
+    reader.SetFileName(nanFileName)
+    messages = self.errorMessages(reader)
+    reader.Update()
+    self.assertEqual(reader.GetOutput().GetNumberOfCells(), 0)
+    self.assertTrue(any('non-finite' in message for message in messages))
+
+    self.delayDisplay('Test passed')
+
+  def test_Primitives(self):
+    import math
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the primitive test")
+
+    sphere, cylinder = self.operands()
+
+    box = vtkbool.vtkBooleanPrimitive()
+    box.SetTypeToBox()
+    box.SetCenter(12, 3, -2)
+    box.SetAxis(0, 1, 1)
+    box.SetLengths(30, 20, 50)
+
+    ball = vtkbool.vtkBooleanPrimitive()
+    ball.SetTypeToSphere()
+    ball.SetCenter(25, 5, 1)
+    ball.SetRadius(15)
+    ball.SetResolution(32)
+
+    drill = vtkbool.vtkBooleanPrimitive()
+    drill.SetTypeToCylinder()
+    drill.SetCenter(1, 2, 0)
+    drill.SetAxis(1, 0.2, 0)
+    drill.SetRadius(8)
+    drill.SetHeight(90)
+    drill.SetResolution(24)
+
+    plane = vtkbool.vtkBooleanPrimitive()
+    plane.SetTypeToPlane()
+    plane.SetCenter(0, 0, 5)
+    plane.SetAxis(0, 0.3, 1)
+
+    # the exact volumes, the tessellations of sphere and cylinder are inscribed
+    exactVolumes = {
+      'box': (30*20*50, 0),
+      'ball': (4/3*math.pi*15**3, 4/3*math.pi*(15**3-(15-ball.GetTolerance())**3)),
+      'drill': (math.pi*8**2*90, math.pi*(8**2-(8-drill.GetTolerance())**2)*90)
+    }
+
+    for name, primitive in [('box', box), ('ball', ball), ('drill', drill), ('plane', plane)]:
+      tessellation = vtk.vtkPolyData()
+      primitive.GetPolyData(sphere.GetBounds(), tessellation)
+      self.assertEqual(self.numberOfOpenEdges(tessellation), 0, name)
+
+      points = tessellation.GetPoints()
+      distances = [primitive.SignedDistance(points.GetPoint(i)) for i in range(points.GetNumberOfPoints())]
+
+      if name == 'plane':
+        # the top of the box lies in the plane, the rest below it
+        self.assertLess(max(distances), 1e-9)
+        self.assertAlmostEqual(primitive.SignedDistance((0, 0, 5)), 0)
+        self.assertAlmostEqual(primitive.SignedDistance((0, 0, 15)), 10/math.sqrt(1.09))
+      else:
+        # all vertices lie on the exact surface, the center inside
+        self.assertLess(max(abs(d) for d in distances), 1e-9, name)
+        self.assertLess(primitive.SignedDistance(primitive.GetCenter()), 0, name)
+        exact, deficit = exactVolumes[name]
+        self.assertLessEqual(self.volume(tessellation), exact*(1+1e-9), name)
+        self.assertGreaterEqual(self.volume(tessellation), exact-deficit-1e-9*exact, name)
+
+      # the primitive path matches the tessellation given as a second input
+      withPrimitive = vtkbool.vtkPolyDataBooleanFilter()
+      withPrimitive.SetOperModeToDifference()
+      withPrimitive.SetInputData(0, sphere)
+      withPrimitive.SetPrimitive(primitive)
+      messages = self.errorMessages(withPrimitive)
+      withPrimitive.Update()
+
+      tessellated = self.difference(sphere, tessellation).GetOutput()
+      result = withPrimitive.GetOutput()
+      self.assertEqual(messages, [], name)
+      self.assertGreater(result.GetNumberOfCells(), 0, name)
+      self.assertEqual(result.GetNumberOfCells(), tessellated.GetNumberOfCells(), name)
+      self.assertAlmostEqual(self.volume(result), self.volume(tessellated), delta=1e-6*self.volume(tessellated), msg=name)
+      self.assertEqual(self.numberOfOpenEdges(result), 0, name)
+
+    self.delayDisplay('Test passed')
+
+  def test_Progressive(self):
+    import time
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the progressive test")
+
+    sphereSource = vtk.vtkSphereSource()
+    sphereSource.SetRadius(30)
+    sphereSource.SetThetaResolution(64)
+    sphereSource.SetPhiResolution(64)
+    sphereSource.Update()
+    sphere = sphereSource.GetOutput()
+
+    _, cylinder = self.operands()
+
+    def pose(translation):
+      transform = vtk.vtkTransform()
+      transform.Translate(translation)
+      transformFilter = vtk.vtkTransformPolyDataFilter()
+      transformFilter.SetTransform(transform)
+      transformFilter.SetInputData(cylinder)
+      transformFilter.Update()
+      return transformFilter.GetOutput()
+
+    def newFilter(b):
+      progressive = vtkbool.vtkProgressiveBooleanFilter()
+      progressive.SetOperModeToDifference()
+      progressive.SetMinimumNumberOfCells(1000)
+      progressive.SetInputData(0, sphere)
+      progressive.SetInputData(1, b)
+      return progressive
+
+    def waitForFullResult(progressive):
+      deadline = time.time()+120
+      while not progressive.Poll():
+        self.assertLess(time.time(), deadline)
+        time.sleep(0.05)
+      progressive.Update()
+
+    def assertSameAsPlain(progressive, b):
+      full = self.difference(sphere, b).GetOutput()
+      result = progressive.GetOutput()
+      self.assertEqual(progressive.GetLevel(), 1)
+      self.assertEqual(result.GetNumberOfCells(), full.GetNumberOfCells())
+      self.assertAlmostEqual(self.volume(result), self.volume(full), delta=1e-6*self.volume(full))
+
+    # the coarse result comes first, the full one replaces it after Poll()
+    b = pose((0, 0, 0))
+    progressive = newFilter(b)
+    messages = self.errorMessages(progressive)
+    progressive.Update()
+
+    self.assertEqual(progressive.GetLevel(), 0)
+    self.assertGreater(progressive.GetOutput().GetNumberOfCells(), 0)
+    self.assertLess(progressive.GetOutput().GetNumberOfCells(), self.difference(sphere, b).GetOutput().GetNumberOfCells())
+
+    waitForFullResult(progressive)
+    assertSameAsPlain(progressive, b)
+    self.assertFalse(progressive.Poll())
+
+    # the first new job is canceled or replaced while still pending, only the last one is delivered
+    progressive.SetInputData(1, pose((3, 0, 0)))
+    progressive.Update()
+    b = pose((0, 4, 1))
+    progressive.SetInputData(1, b)
+    progressive.Update()
+    self.assertEqual(progressive.GetLevel(), 0)
+
+    waitForFullResult(progressive)
+    assertSameAsPlain(progressive, b)
+    self.assertEqual(messages, [])
+
+    # destroying the filter while the worker is busy cancels the job and joins the thread
+    midRun = newFilter(pose((-2, 1, 0)))
+    midRun.Update()
+    self.assertEqual(midRun.GetLevel(), 0)
+    del midRun
+
+    self.delayDisplay('Test passed')
+
+  def test_Localized(self):
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the localized test")
+
+    sphere, cylinder = self.operands()
+
+    # one filter follows B through several poses, the first two stay within the cropped region, the others do not
+    localized = vtkbool.vtkPolyDataBooleanFilter()
+    localized.SetOperModeToDifference()
+    localized.LocalizedOn()
+    localized.SetInputData(0, sphere)
+
+    for translation, angle in [((0, 0, 0), 0), ((2, 1, 0), 0), ((12, -4, 0), 15), ((-12, 6, 3), 30)]:
+      transform = vtk.vtkTransform()
+      transform.Translate(translation)
+      transform.RotateZ(angle)
+      transformFilter = vtk.vtkTransformPolyDataFilter()
+      transformFilter.SetTransform(transform)
+      transformFilter.SetInputData(cylinder)
+      transformFilter.Update()
+      pose = transformFilter.GetOutput()
+
+      localized.SetInputData(1, pose)
+      localized.Update()
+
+      full = self.difference(sphere, pose).GetOutput()
+      result = localized.GetOutput()
+      self.assertGreater(full.GetNumberOfCells(), 0)
+      self.assertEqual(result.GetNumberOfCells(), full.GetNumberOfCells())
+      self.assertAlmostEqual(self.volume(result), self.volume(full), delta=1e-6*self.volume(full))
+      self.assertEqual(self.numberOfOpenEdges(result), 0)
+
+      # the pieces are numbered as in the full run
+      regions = lambda pd: int(pd.GetPointData().GetArray('RegionId').GetRange()[1])+1
+      self.assertEqual(regions(result), regions(full))
+
+    # a triangle soup, as read from an STL file, is validated once after cleaning and then only cut
+    shrink = vtk.vtkShrinkPolyData()
+    shrink.SetShrinkFactor(1)
+    shrink.SetInputData(sphere)
+    shrink.Update()
+    soup = shrink.GetOutput()
+    self.assertEqual(soup.GetNumberOfPoints(), 3*soup.GetNumberOfCells())
+
+    soupLocalized = vtkbool.vtkPolyDataBooleanFilter()
+    soupLocalized.SetOperModeToDifference()
+    soupLocalized.LocalizedOn()
+    soupLocalized.ValidateInputsOn()
+    soupLocalized.SetInputData(0, soup)
+    messages = self.errorMessages(soupLocalized)
+
+    for translation in [(0, 0, 0), (2, 1, 0)]:
+      transform = vtk.vtkTransform()
+      transform.Translate(translation)
+      transformFilter = vtk.vtkTransformPolyDataFilter()
+      transformFilter.SetTransform(transform)
+      transformFilter.SetInputData(cylinder)
+      transformFilter.Update()
+      pose = transformFilter.GetOutput()
+
+      soupLocalized.SetInputData(1, pose)
+      soupLocalized.Update()
+
+      full = self.difference(sphere, pose).GetOutput()
+      result = soupLocalized.GetOutput()
+      self.assertEqual(messages, [])
+      self.assertEqual(result.GetNumberOfCells(), full.GetNumberOfCells())
+      self.assertAlmostEqual(self.volume(result), self.volume(full), delta=1e-6*self.volume(full))
+      self.assertEqual(self.numberOfOpenEdges(result), 0)
+
+    self.delayDisplay('Test passed')
+
+  def test_MultiPoseDifference(self):
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the multi-pose difference test")
+
+    sphere, cylinder = self.operands()
+
+    toolSource = vtk.vtkSphereSource()
+    toolSource.SetRadius(5)
+    toolSource.SetThetaResolution(16)
+    toolSource.SetPhiResolution(16)
+    toolSource.Update()
+    tool = toolSource.GetOutput()
+
+    # the first two poses overlap each other, the third is on its own, the last one is far away from A
+    translations = [(30, 0.3, 0.2), (33, 0.9, 0.5), (-31, -0.4, 0.6), (100, 0, 0)]
+
+    multiPose = vtkbool.vtkMultiPoseDifferenceFilter()
+    multiPose.SetInputData(0, sphere)
+    multiPose.SetInputData(1, tool)
+    for translation in translations:
+      transform = vtk.vtkTransform()
+      transform.Translate(translation)
+      multiPose.AddPose(transform.GetMatrix())
+    messages = self.errorMessages(multiPose)
+    multiPose.Update()
+
+    self.assertEqual(messages, [])
+    self.assertEqual(multiPose.GetNumberOfPoses(), 4)
+    self.assertEqual(multiPose.GetNumberOfUsedPoses(), 3)
+    self.assertEqual(multiPose.GetNumberOfClusters(), 2)
+
+    # the same as subtracting the used poses one after another
+    def subtractOneByOne(translations):
+      expected = sphere
+      for translation in translations:
+        transform = vtk.vtkTransform()
+        transform.Translate(translation)
+        transformFilter = vtk.vtkTransformPolyDataFilter()
+        transformFilter.SetTransform(transform)
+        transformFilter.SetInputData(tool)
+        transformFilter.Update()
+        expected = self.difference(expected, transformFilter.GetOutput()).GetOutput()
+      return expected
+
+    expected = subtractOneByOne(translations[:3])
+    result = multiPose.GetOutput()
+    self.assertGreater(result.GetNumberOfCells(), 0)
+    self.assertLess(self.volume(result), self.volume(sphere))
+    self.assertAlmostEqual(self.volume(result), self.volume(expected), delta=1e-3*self.volume(expected))
+    self.assertEqual(self.numberOfOpenEdges(result), 0)
+
+    # diagonal poses whose bounds overlap while the tools are 0.47 apart, the first one is repeated
+    translations = [(28, -3.7, -3.7), (28, 3.7, 3.7), (28, -3.7, -3.7)]
+
+    multiPose.RemoveAllPoses()
+    for translation in translations:
+      transform = vtk.vtkTransform()
+      transform.Translate(translation)
+      multiPose.AddPose(transform.GetMatrix())
+    multiPose.Update()
+
+    self.assertEqual(messages, [])
+    self.assertEqual(multiPose.GetNumberOfUsedPoses(), 2)
+    self.assertEqual(multiPose.GetNumberOfClusters(), 1)
+
+    expected = subtractOneByOne(translations[:2])
+    result = multiPose.GetOutput()
+    self.assertAlmostEqual(self.volume(result), self.volume(expected), delta=1e-3*self.volume(expected))
+    self.assertEqual(self.numberOfOpenEdges(result), 0)
+
+    self.delayDisplay('Test passed')
+
+  def test_Proximity(self):
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the proximity test")
+
+    def cube(center):
+      source = vtk.vtkCubeSource()
+      source.SetXLength(10)
+      source.SetYLength(10)
+      source.SetZLength(10)
+      source.SetCenter(center)
+      source.Update()
+      return source.GetOutput()
+
+    cubeA = cube((0, 0, 0))
+
+    # separated along x, the faces x=5 and x=15 face each other where y is in [-2, 5] and z is in [-4, 5]
+    proximity = vtkbool.vtkPolyDataProximityFilter()
+    proximity.SetInputData(0, cubeA)
+    proximity.SetInputData(1, cube((20, 3, 1)))
+    proximity.Update()
+
+    self.assertAlmostEqual(proximity.GetDistance(), 10, delta=1e-9)
+    pointA = proximity.GetPointA()
+    pointB = proximity.GetPointB()
+    self.assertAlmostEqual(pointA[0], 5, delta=1e-9)
+    self.assertAlmostEqual(pointB[0], 15, delta=1e-9)
+    self.assertAlmostEqual(pointA[1], pointB[1], delta=1e-9)
+    self.assertAlmostEqual(pointA[2], pointB[2], delta=1e-9)
+    self.assertTrue(-2-1e-9 <= pointA[1] <= 5+1e-9)
+    self.assertTrue(-4-1e-9 <= pointA[2] <= 5+1e-9)
+
+    line = proximity.GetOutput()
+    self.assertEqual(line.GetNumberOfCells(), 1)
+    self.assertAlmostEqual(vtk.vtkMath.Distance2BetweenPoints(line.GetPoint(0), pointA), 0, delta=1e-12)
+    self.assertAlmostEqual(vtk.vtkMath.Distance2BetweenPoints(line.GetPoint(1), pointB), 0, delta=1e-12)
+
+    # a corner of each cube is 1 deep inside the other one
+    proximity.SetInputData(1, cube((9, 9, 9)))
+    proximity.Update()
+    self.assertAlmostEqual(proximity.GetDistance(), -1, delta=1e-9)
+
+    self.delayDisplay('Test passed')
+
+  def test_Clearance(self):
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the clearance test")
+
+    def cube(center):
+      source = vtk.vtkCubeSource()
+      source.SetXLength(40)
+      source.SetYLength(40)
+      source.SetZLength(40)
+      source.SetCenter(center)
+      source.Update()
+      return source.GetOutput()
+
+    # created first, so that it is older than the cube that is used first
+    farCube = cube((100, 0, 0))
+    nearCube = cube((0, 0, 0))
+
+    sphere = vtk.vtkSphereSource()
+    sphere.SetRadius(5)
+    sphere.Update()
+
+    # all points are at least 15 inside the cube, beyond the maximum distance
+    clearance = vtkbool.vtkPolyDataClearanceFilter()
+    clearance.SetMaximumDistance(5)
+    clearance.SetInputData(0, sphere.GetOutput())
+    clearance.SetInputData(1, nearCube)
+    clearance.Update()
+    self.assertEqual(clearance.GetOutput().GetPointData().GetArray("Distance").GetRange(), (-5, -5))
+
+    # another, older input replaces the cached one
+    clearance.SetInputData(1, farCube)
+    clearance.Update()
+    self.assertEqual(clearance.GetOutput().GetPointData().GetArray("Distance").GetRange(), (5, 5))
+
+    self.delayDisplay('Test passed')
+
+  def assertSamePolyData(self, polyDataA, polyDataB):
+    self.assertEqual(polyDataA.GetNumberOfPoints(), polyDataB.GetNumberOfPoints())
+    self.assertEqual(polyDataA.GetNumberOfCells(), polyDataB.GetNumberOfCells())
+    for i in range(polyDataA.GetNumberOfPoints()):
+      self.assertEqual(polyDataA.GetPoint(i), polyDataB.GetPoint(i))
+    idsA = vtk.vtkIdList()
+    idsB = vtk.vtkIdList()
+    for i in range(polyDataA.GetNumberOfCells()):
+      polyDataA.GetCellPoints(i, idsA)
+      polyDataB.GetCellPoints(i, idsB)
+      self.assertEqual([idsA.GetId(j) for j in range(idsA.GetNumberOfIds())], [idsB.GetId(j) for j in range(idsB.GetNumberOfIds())])
+
+  def test_SnapRounding(self):
+    self.delayDisplay("Starting the snap rounding test")
+
+    sphere, cylinder = self.operands()
+
+    # moves the sphere by far less than the grid spacing of 2**-3
+    transform = vtk.vtkTransform()
+    transform.Translate(1e-9, 0, 0)
+    moved = vtk.vtkTransformPolyDataFilter()
+    moved.SetInputData(sphere)
+    moved.SetTransform(transform)
+    moved.SetOutputPointsPrecision(vtk.vtkAlgorithm.DOUBLE_PRECISION)
+    moved.Update()
+
+    full = self.difference(sphere, cylinder).GetOutput()
+    snapped = self.difference(sphere, cylinder, SnapRounding=True, SnapResolution=1024).GetOutput()
+    self.assertEqual(self.numberOfOpenEdges(snapped), 0)
+    self.assertAlmostEqual(self.volume(snapped), self.volume(full), delta=1e-2*self.volume(full))
+
+    # both inputs end up on the same grid, the result does not change at all
+    snappedMoved = self.difference(moved.GetOutput(), cylinder, SnapRounding=True, SnapResolution=1024).GetOutput()
+    self.assertSamePolyData(snappedMoved, snapped)
+
+    self.delayDisplay('Test passed')
+
+  def test_DegenerateContacts(self):
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the degenerate contacts test")
+
+    sphere, _ = self.operands()
+
+    # the sphere is symmetric under quarter turns about z; the box faces pass exactly through a meridian of
+    # vertices, at 1e-9 off it, or with an edge exactly through both poles, while the vertices of the opposite
+    # meridian are off the plane only by rounding
+    cases = [
+      ('vertices on a face', (-40, 40, 0, 40, -40, 40), 0.5),
+      ('vertices near a face', (-40, 40, 1e-9, 40, -40, 40), 0.5),
+      ('poles on an edge', (0, 40, 0, 40, -40, 40), 0.75)
+    ]
+
+    for name, bounds, fraction in cases:
+      cube = vtk.vtkCubeSource()
+      cube.SetBounds(bounds)
+      cube.Update()
+
+      combine = vtkbool.vtkPolyDataBooleanFilter()
+      combine.SetOperModeToDifference()
+      combine.SetInputData(0, sphere)
+      combine.SetInputData(1, cube.GetOutput())
+      messages = self.errorMessages(combine)
+      combine.Update()
+
+      result = combine.GetOutput()
+      self.assertEqual(messages, [], name)
+      self.assertGreater(result.GetNumberOfCells(), 0, name)
+      self.assertAlmostEqual(self.volume(result), fraction*self.volume(sphere), delta=1e-6*self.volume(sphere), msg=name)
+      self.assertEqual(self.numberOfOpenEdges(result), 0, name)
+
+    self.delayDisplay('Test passed')
+
+  def test_RefitTrees(self):
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the tree refit test")
+
+    sphere, cylinder = self.operands()
+
+    # the points of the tool are moved in place, its cells stay the same
+    tool = vtk.vtkPolyData()
+    tool.DeepCopy(cylinder)
+
+    def moveTool(x, y, z):
+      transform = vtk.vtkTransform()
+      transform.Translate(x, y, z)
+      points = vtk.vtkPoints()
+      transform.TransformPoints(cylinder.GetPoints(), points)
+      tool.GetPoints().DeepCopy(points)
+      tool.GetPoints().Modified()
+
+    def contactLines(contact):
+      lines = contact.GetOutput()
+      length = 0
+      for i in range(lines.GetNumberOfCells()):
+        ids = lines.GetCell(i).GetPointIds()
+        length += vtk.vtkMath.Distance2BetweenPoints(lines.GetPoint(ids.GetId(0)), lines.GetPoint(ids.GetId(1)))**0.5
+      return lines.GetNumberOfCells(), length
+
+    refitted = vtkbool.vtkPolyDataContactFilter()
+    refitted.SetRefitThreshold(2)
+    refitted.SetInputData(0, sphere)
+    refitted.SetInputData(1, tool)
+    refitted.Update()
+
+    # the refitted trees find the same contact as trees that are built from scratch
+    for offset in [(0.5, 0, 0.5), (3, 1, -2), (100, 0, 0)]:
+      moveTool(*offset)
+      refitted.Update()
+
+      rebuilt = vtkbool.vtkPolyDataContactFilter()
+      rebuilt.SetInputData(0, sphere)
+      rebuilt.SetInputData(1, tool)
+      rebuilt.Update()
+
+      numberOfLines, length = contactLines(refitted)
+      expectedNumberOfLines, expectedLength = contactLines(rebuilt)
+      self.assertEqual(numberOfLines, expectedNumberOfLines)
+      self.assertAlmostEqual(length, expectedLength, delta=1e-9*max(expectedLength, 1))
+
+    # the last pose does not touch the sphere
+    self.assertEqual(refitted.GetOutput().GetNumberOfCells(), 0)
+
+    self.delayDisplay('Test passed')
+
+  def test_ValidateInputs(self):
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the input validation test")
+
+    sphere, cylinder = self.operands()
+
+    # a wedge is missing
+    openSphere = vtk.vtkSphereSource()
+    openSphere.SetRadius(30)
+    openSphere.SetThetaResolution(32)
+    openSphere.SetPhiResolution(32)
+    openSphere.SetEndTheta(300)
+    openSphere.Update()
+
+    # two overlapping cylinders in one input
+    shifted = vtk.vtkTransform()
+    shifted.Translate(10, 0, 0)
+    shiftedCylinder = vtk.vtkTransformPolyDataFilter()
+    shiftedCylinder.SetInputData(cylinder)
+    shiftedCylinder.SetTransform(shifted)
+    crossing = vtk.vtkAppendPolyData()
+    crossing.AddInputData(cylinder)
+    crossing.AddInputConnection(shiftedCylinder.GetOutputPort())
+    crossing.Update()
+
+    for inputA, inputB, expected in [(openSphere.GetOutput(), cylinder, "First input is not valid: not closed"),
+        (sphere, crossing.GetOutput(), "Second input is not valid: self-intersecting")]:
+      combine = vtkbool.vtkPolyDataBooleanFilter()
+      messages = self.errorMessages(combine)
+      combine.SetOperModeToDifference()
+      combine.ValidateInputsOn()
+      combine.SetInputData(0, inputA)
+      combine.SetInputData(1, inputB)
+      combine.Update()
+      self.assertEqual(len(messages), 1)
+      self.assertIn(expected, messages[0])
+      self.assertEqual(combine.GetOutput().GetNumberOfCells(), 0)
+
+    # valid inputs pass unchanged
+    combine = self.difference(sphere, cylinder, ValidateInputs=True)
+    self.assertEqual(combine.GetOutput().GetNumberOfCells(), self.difference(sphere, cylinder).GetOutput().GetNumberOfCells())
+
+    # strips are checked like the triangles they stand for, alone and next to polygons
+    stripper = vtk.vtkStripper()
+    stripper.SetInputData(sphere)
+    stripper.Update()
+
+    mixed = vtk.vtkPolyData()
+    mixed.SetPoints(sphere.GetPoints())
+    polys = vtk.vtkCellArray()
+    strips = vtk.vtkCellArray()
+    ids = vtk.vtkIdList()
+    for i in range(sphere.GetNumberOfCells()):
+      sphere.GetCellPoints(i, ids)
+      (polys if i%2 == 0 else strips).InsertNextCell(ids)
+    mixed.SetPolys(polys)
+    mixed.SetStrips(strips)
+
+    for inputA in [stripper.GetOutput(), mixed]:
+      combine = vtkbool.vtkPolyDataBooleanFilter()
+      messages = self.errorMessages(combine)
+      combine.SetOperModeToDifference()
+      combine.ValidateInputsOn()
+      combine.SetInputData(0, inputA)
+      combine.SetInputData(1, cylinder)
+      combine.Update()
+      self.assertEqual(messages, [])
+      self.assertGreater(combine.GetOutput().GetNumberOfCells(), 0)
+
+    self.delayDisplay('Test passed')
+
+  def test_AttachIndex(self):
+    self.delayDisplay("Starting the attached index test")
+
+    sphere, cylinder = self.operands()
+
+    # the second cut crosses the first one
+    rotation = vtk.vtkTransform()
+    rotation.RotateZ(90)
+    rotatedCylinder = vtk.vtkTransformPolyDataFilter()
+    rotatedCylinder.SetInputData(cylinder)
+    rotatedCylinder.SetTransform(rotation)
+    rotatedCylinder.SetOutputPointsPrecision(vtk.vtkAlgorithm.DOUBLE_PRECISION)
+    rotatedCylinder.Update()
+
+    # the second filter takes over the tree of the first output instead of building its own
+    results = []
+    referenceCounts = []
+    for attachIndex in [False, True]:
+      first = self.difference(sphere, cylinder, AttachIndex=attachIndex)
+      # the attached tree must not hold on to the output, or neither would ever be freed
+      referenceCounts.append(first.GetOutput().GetReferenceCount())
+      second = self.difference(first.GetOutput(), rotatedCylinder.GetOutput())
+      results.append(second.GetOutput())
+    self.assertEqual(referenceCounts[1], referenceCounts[0])
+
+    plain, indexed = results
+    self.assertGreater(plain.GetNumberOfCells(), 0)
+    self.assertEqual(indexed.GetNumberOfCells(), plain.GetNumberOfCells())
+    self.assertAlmostEqual(self.volume(indexed), self.volume(plain), delta=1e-6*self.volume(plain))
+    self.assertEqual(self.numberOfOpenEdges(indexed), 0)
+
+    self.delayDisplay('Test passed')
+
+  def test_DeterministicPolicy(self):
+    import vtkSlicerCombineModelsModuleLogicPython as vtkbool
+
+    self.delayDisplay("Starting the deterministic policy test")
+
+    sphere, cylinder = self.operands()
+
+    # small grains split the loops into many chunks, so that the threads really interleave
+    results = []
+    for numberOfThreads in [1, 4]:
+      policy = vtkbool.vtkBooleanExecutionPolicy()
+      policy.SetNumberOfThreads(numberOfThreads)
+      policy.SetPolygonGrain(1)
+      policy.SetPairGrain(1)
+      policy.DeterministicOn()
+      results.append(self.difference(sphere, cylinder, Policy=policy).GetOutput())
+
+    self.assertGreater(results[0].GetNumberOfCells(), 0)
+    self.assertSamePolyData(results[1], results[0])
+
+    self.delayDisplay('Test passed')
+
+  def test_SeamWelding(self):
+    self.delayDisplay("Starting the seam welding test")
+
+    sphere, cylinder = self.operands()
+
+    def numberOfRegions(polyData):
+      return int(polyData.GetPointData().GetArray("RegionId").GetRange()[1])+1
+
+    def numberOfBoundaryEdges(polyData):
+      edges = vtk.vtkFeatureEdges()
+      edges.SetInputData(polyData)
+      edges.BoundaryEdgesOn()
+      edges.NonManifoldEdgesOff()
+      edges.FeatureEdgesOff()
+      edges.ManifoldEdgesOff()
+      edges.Update()
+      return edges.GetOutput().GetNumberOfCells()
+
+    # by default the ring of the sphere and the wall of the hole are separate regions
+    plain = self.difference(sphere, cylinder).GetOutput()
+    self.assertGreater(numberOfBoundaryEdges(plain), 0)
+    self.assertEqual(numberOfRegions(plain), 2)
+
+    # welded they form one closed body
+    welded = self.difference(sphere, cylinder, SeamWelding=True).GetOutput()
+    self.assertEqual(numberOfBoundaryEdges(welded), 0)
+    self.assertEqual(numberOfRegions(welded), 1)
+    self.assertEqual(welded.GetNumberOfCells(), plain.GetNumberOfCells())
+    self.assertAlmostEqual(self.volume(welded), self.volume(plain), delta=1e-9*self.volume(plain))
 
     self.delayDisplay('Test passed')
@@ -0,0 +1,58 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cassert>
+#include <vector>
+
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkIntArray.h>
+
+#include "AppendBuffer.h"
+
+PointBuffer::PointBuffer (vtkPoints *_pts) : offset(_pts->GetNumberOfPoints()) {}
+
+void PointBuffer::Compact (vtkPoints *_pts) {
+    assert(_pts->GetNumberOfPoints() == offset);
+
+    vtkIdType i, num = pts.Size();
+
+    for (i = 0; i < num; i++) {
+        _pts->InsertNextPoint(pts[i].data());
+    }
+}
+
+CellBuffer::CellBuffer (vtkPolyData *pd) : offset(pd->GetNumberOfCells()) {}
+
+void CellBuffer::Compact (vtkPolyData *pd, vtkIntArray *origCellIds) {
+    assert(pd->GetNumberOfCells() == offset);
+
+    std::vector<vtkIdType> poly;
+
+    vtkIdType i, j, num = cells.Size();
+
+    for (i = 0; i < num; i++) {
+        const Cell &cell = cells[i];
+
+        // die punkte können über zwei segmente verteilt sein
+        poly.resize(cell.num);
+
+        for (j = 0; j < cell.num; j++) {
+            poly[j] = conn[cell.start+j];
+        }
+
+        pd->InsertNextCell(VTK_POLYGON, cell.num, poly.data());
+        origCellIds->InsertNextValue(cell.origId);
+    }
+}
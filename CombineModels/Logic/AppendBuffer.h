@@ -0,0 +1,177 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __AppendBuffer_h
+#define __AppendBuffer_h
+
+#include <atomic>
+#include <array>
+
+#include <vtkType.h>
+
+class vtkPoints;
+class vtkPolyData;
+class vtkIntArray;
+
+// ein puffer, an den mehrere threads gleichzeitig anhängen können
+//
+// ein bereich wird atomar reserviert und kann danach ohne sperre beschrieben werden; die elemente liegen in
+// segmenten, deren größe sich verdoppelt, ein segment wird also nie verschoben und die ersten 48 reichen für alles
+//
+// genutzt wird er nur von CutCells, der einzigen stufe des vtkPolyDataBooleanFilter, die parallel einfügt;
+// DisjoinPolys, MergePoints und DecPolys_ laufen seriell und fügen weiterhin direkt in den datensatz ein
+
+template <typename T, int Bits = 10>
+class ChunkedBuffer {
+    static const int numSegs = 48;
+
+    std::atomic<T*> segs[numSegs];
+    std::atomic<vtkIdType> size;
+
+    static int Segment (vtkIdType i, vtkIdType &j) {
+        vtkIdType k = (i >> Bits)+1;
+
+        int s = 0;
+
+        while ((k >> (s+1)) != 0) {
+            s++;
+        }
+
+        j = i-(((vtkIdType(1) << s)-1) << Bits);
+
+        return s;
+    }
+
+public:
+    ChunkedBuffer () : size(0) {
+        for (int s = 0; s < numSegs; s++) {
+            segs[s] = nullptr;
+        }
+    }
+
+    ~ChunkedBuffer () {
+        for (int s = 0; s < numSegs; s++) {
+            delete[] segs[s].load();
+        }
+    }
+
+    ChunkedBuffer (const ChunkedBuffer&) = delete;
+    ChunkedBuffer& operator= (const ChunkedBuffer&) = delete;
+
+    // liefert den anfang des bereichs
+    vtkIdType Reserve (vtkIdType num) {
+        return size.fetch_add(num);
+    }
+
+    vtkIdType Size () const {
+        return size.load();
+    }
+
+    T& operator[] (vtkIdType i) {
+        vtkIdType j;
+        int s = Segment(i, j);
+
+        T *seg = segs[s].load(std::memory_order_acquire);
+
+        if (seg == nullptr) {
+            // wer verliert, gibt sein segment wieder frei
+            T *_seg = new T[vtkIdType(1) << (Bits+s)];
+
+            if (segs[s].compare_exchange_strong(seg, _seg, std::memory_order_acq_rel)) {
+                seg = _seg;
+            } else {
+                delete[] _seg;
+            }
+        }
+
+        return seg[j];
+    }
+
+    const T& operator[] (vtkIdType i) const {
+        vtkIdType j;
+        int s = Segment(i, j);
+
+        return segs[s].load(std::memory_order_acquire)[j];
+    }
+};
+
+// neue punkte, deren ids ab der aktuellen anzahl der punkte feststehen
+class PointBuffer {
+    ChunkedBuffer<std::array<double, 3>> pts;
+    vtkIdType offset;
+
+public:
+    PointBuffer (vtkPoints *_pts);
+
+    vtkIdType Reserve (vtkIdType num) { return offset+pts.Reserve(num); }
+
+    void SetPoint (vtkIdType id, const double *pt) {
+        std::array<double, 3> &p = pts[id-offset];
+
+        p[0] = pt[0];
+        p[1] = pt[1];
+        p[2] = pt[2];
+    }
+
+    vtkIdType InsertNextPoint (const double *pt) {
+        vtkIdType id = Reserve(1);
+        SetPoint(id, pt);
+
+        return id;
+    }
+
+    // hängt die punkte in der reihenfolge ihrer ids an, nur wenn die threads fertig sind
+    void Compact (vtkPoints *_pts);
+};
+
+// neue polygone mit ihrer OrigCellId, ebenso mit festen ids
+class CellBuffer {
+    class Cell {
+    public:
+        vtkIdType start, num;
+        int origId;
+    };
+
+    ChunkedBuffer<Cell> cells;
+    ChunkedBuffer<vtkIdType> conn;
+    vtkIdType offset;
+
+public:
+    CellBuffer (vtkPolyData *pd);
+
+    vtkIdType Reserve (vtkIdType num) { return offset+cells.Reserve(num); }
+
+    void SetCell (vtkIdType id, vtkIdType num, const vtkIdType *poly, int origId) {
+        Cell &cell = cells[id-offset];
+
+        cell.start = conn.Reserve(num);
+        cell.num = num;
+        cell.origId = origId;
+
+        for (vtkIdType i = 0; i < num; i++) {
+            conn[cell.start+i] = poly[i];
+        }
+    }
+
+    vtkIdType InsertNextCell (vtkIdType num, const vtkIdType *poly, int origId) {
+        vtkIdType id = Reserve(1);
+        SetCell(id, num, poly, origId);
+
+        return id;
+    }
+
+    void Compact (vtkPolyData *pd, vtkIntArray *origCellIds);
+};
+
+#endif
@@ -0,0 +1,314 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cmath>
+#include <algorithm>
+
+#include <vtkOBBTree.h>
+#include <vtkMath.h>
+
+#include "ClosestPoints.h"
+#include "Predicates.h"
+
+Box::Box (const vtkOBBNode *node) {
+    int i, num = 0;
+
+    std::copy_n(node->Corner, 3, c);
+
+    for (i = 0; i < 3; i++) {
+        std::copy_n(node->Axes[i], 3, u[i]);
+
+        for (int j = 0; j < 3; j++) {
+            c[j] += node->Axes[i][j]/2;
+        }
+
+        h[i] = vtkMath::Normalize(u[i])/2;
+
+        if (h[i] > 0) {
+            num++;
+        }
+    }
+
+    // flache knoten, wie beim RefitOBBTree
+
+    if (num == 0) {
+        u[0][0] = 1; u[0][1] = 0; u[0][2] = 0;
+    }
+
+    if (num < 2) {
+        vtkMath::Perpendiculars(u[0], u[1], u[2], 0);
+    } else if (num == 2) {
+        vtkMath::Cross(u[0], u[1], u[2]);
+        vtkMath::Normalize(u[2]);
+    }
+}
+
+double Box::Radius (const double *l) const {
+    return h[0]*std::abs(vtkMath::Dot(l, u[0]))+h[1]*std::abs(vtkMath::Dot(l, u[1]))+h[2]*std::abs(vtkMath::Dot(l, u[2]));
+}
+
+double LowerBound (const Box &a, const Box &b) {
+    double d[3];
+    vtkMath::Subtract(b.c, a.c, d);
+
+    double lb = 0;
+
+    auto Test = [&](const double *l) {
+        lb = std::max(lb, std::abs(vtkMath::Dot(l, d))-a.Radius(l)-b.Radius(l));
+    };
+
+    for (int i = 0; i < 3; i++) {
+        Test(a.u[i]);
+        Test(b.u[i]);
+    }
+
+    double l[] = {d[0], d[1], d[2]};
+
+    if (vtkMath::Normalize(l) > 0) {
+        Test(l);
+    }
+
+    return lb;
+}
+
+double LowerBound (const double *p, const Box &b) {
+    double d[3], s = 0;
+    vtkMath::Subtract(p, b.c, d);
+
+    for (int i = 0; i < 3; i++) {
+        double e = std::max(0., std::abs(vtkMath::Dot(d, b.u[i]))-b.h[i]);
+        s += e*e;
+    }
+
+    return std::sqrt(s);
+}
+
+double NodeSize (const vtkOBBNode *node) {
+    return vtkMath::Norm(node->Axes[0])+vtkMath::Norm(node->Axes[1])+vtkMath::Norm(node->Axes[2]);
+}
+
+int ClosestPtTri (const double *p, const double *a, const double *b, const double *c, double *q) {
+    double ab[3], ac[3], ap[3], bp[3], cp[3], bc[3];
+
+    vtkMath::Subtract(b, a, ab);
+    vtkMath::Subtract(c, a, ac);
+    vtkMath::Subtract(p, a, ap);
+
+    double d1 = vtkMath::Dot(ab, ap),
+        d2 = vtkMath::Dot(ac, ap);
+
+    if (d1 <= 0 && d2 <= 0) {
+        std::copy_n(a, 3, q);
+        return FEAT_A;
+    }
+
+    vtkMath::Subtract(p, b, bp);
+
+    double d3 = vtkMath::Dot(ab, bp),
+        d4 = vtkMath::Dot(ac, bp);
+
+    if (d3 >= 0 && d4 <= d3) {
+        std::copy_n(b, 3, q);
+        return FEAT_B;
+    }
+
+    double vc = d1*d4-d3*d2;
+
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+        double v = d1/(d1-d3);
+
+        for (int i = 0; i < 3; i++) {
+            q[i] = a[i]+v*ab[i];
+        }
+
+        return FEAT_AB;
+    }
+
+    vtkMath::Subtract(p, c, cp);
+
+    double d5 = vtkMath::Dot(ab, cp),
+        d6 = vtkMath::Dot(ac, cp);
+
+    if (d6 >= 0 && d5 <= d6) {
+        std::copy_n(c, 3, q);
+        return FEAT_C;
+    }
+
+    double vb = d5*d2-d1*d6;
+
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+        double w = d2/(d2-d6);
+
+        for (int i = 0; i < 3; i++) {
+            q[i] = a[i]+w*ac[i];
+        }
+
+        return FEAT_CA;
+    }
+
+    double va = d3*d6-d5*d4;
+
+    if (va <= 0 && d4-d3 >= 0 && d5-d6 >= 0) {
+        double w = (d4-d3)/((d4-d3)+(d5-d6));
+
+        vtkMath::Subtract(c, b, bc);
+
+        for (int i = 0; i < 3; i++) {
+            q[i] = b[i]+w*bc[i];
+        }
+
+        return FEAT_BC;
+    }
+
+    double sum = va+vb+vc;
+
+    if (sum == 0) {
+        // entartet
+        std::copy_n(a, 3, q);
+        return FEAT_A;
+    }
+
+    double v = vb/sum,
+        w = vc/sum;
+
+    for (int i = 0; i < 3; i++) {
+        q[i] = a[i]+v*ab[i]+w*ac[i];
+    }
+
+    return FEAT_FACE;
+}
+
+void ClosestPtSegSeg (const double *pA, const double *qA, const double *pB, const double *qB, double *cA, double *cB) {
+    double dA[3], dB[3], r[3];
+
+    vtkMath::Subtract(qA, pA, dA);
+    vtkMath::Subtract(qB, pB, dB);
+    vtkMath::Subtract(pA, pB, r);
+
+    double a = vtkMath::Dot(dA, dA),
+        e = vtkMath::Dot(dB, dB),
+        f = vtkMath::Dot(dB, r);
+
+    double s = 0, t = 0;
+
+    auto Clamp = [](double v) { return std::min(1., std::max(0., v)); };
+
+    if (a == 0 && e == 0) {
+        // beides punkte
+    } else if (a == 0) {
+        t = Clamp(f/e);
+    } else {
+        double c = vtkMath::Dot(dA, r);
+
+        if (e == 0) {
+            s = Clamp(-c/a);
+        } else {
+            double b = vtkMath::Dot(dA, dB),
+                denom = a*e-b*b;
+
+            s = denom != 0 ? Clamp((b*f-c*e)/denom) : 0;
+            t = (b*s+f)/e;
+
+            if (t < 0) {
+                t = 0;
+                s = Clamp(-c/a);
+            } else if (t > 1) {
+                t = 1;
+                s = Clamp((b-c)/a);
+            }
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        cA[i] = pA[i]+s*dA[i];
+        cB[i] = pB[i]+t*dB[i];
+    }
+}
+
+bool InterSegTri (const double *p, const double *q, const double *a, const double *b, const double *c, double *x) {
+    double sP = Orient3d(a, b, c, p),
+        sQ = Orient3d(a, b, c, q);
+
+    if ((sP > 0 && sQ > 0) || (sP < 0 && sQ < 0) || (sP == 0 && sQ == 0)) {
+        // koplanare fälle werden über die abstände der kanten erfasst
+        return false;
+    }
+
+    double eA = Orient3d(p, q, a, b),
+        eB = Orient3d(p, q, b, c),
+        eC = Orient3d(p, q, c, a);
+
+    if ((eA < 0 || eB < 0 || eC < 0) && (eA > 0 || eB > 0 || eC > 0)) {
+        return false;
+    }
+
+    double s = sP/(sP-sQ);
+
+    for (int i = 0; i < 3; i++) {
+        x[i] = p[i]+s*(q[i]-p[i]);
+    }
+
+    return true;
+}
+
+double TriTriDistance (const TriType &triA, const TriType &triB, double *ptA, double *ptB) {
+    int i, j;
+
+    double x[3];
+
+    for (i = 0; i < 3; i++) {
+        j = (i+1)%3;
+
+        if (InterSegTri(triA[i], triA[j], triB[0], triB[1], triB[2], x)
+            || InterSegTri(triB[i], triB[j], triA[0], triA[1], triA[2], x)) {
+
+            std::copy_n(x, 3, ptA);
+            std::copy_n(x, 3, ptB);
+
+            return 0;
+        }
+    }
+
+    double best = VTK_DOUBLE_MAX, d, cA[3], cB[3];
+
+    auto Update = [&]() {
+        d = vtkMath::Distance2BetweenPoints(cA, cB);
+
+        if (d < best) {
+            best = d;
+
+            std::copy_n(cA, 3, ptA);
+            std::copy_n(cB, 3, ptB);
+        }
+    };
+
+    for (i = 0; i < 3; i++) {
+        std::copy_n(triA[i], 3, cA);
+        ClosestPtTri(cA, triB[0], triB[1], triB[2], cB);
+        Update();
+
+        std::copy_n(triB[i], 3, cB);
+        ClosestPtTri(cB, triA[0], triA[1], triA[2], cA);
+        Update();
+    }
+
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) {
+            ClosestPtSegSeg(triA[i], triA[(i+1)%3], triB[j], triB[(j+1)%3], cA, cB);
+            Update();
+        }
+    }
+
+    return std::sqrt(best);
+}
@@ -0,0 +1,63 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __ClosestPoints_h
+#define __ClosestPoints_h
+
+class vtkOBBNode;
+
+// ein knoten als mittelpunkt, normierte achsen und halbe ausdehnungen
+class Box {
+public:
+    Box (const vtkOBBNode *node);
+
+    double c[3], u[3][3], h[3];
+
+    double Radius (const double *l) const;
+};
+
+// untere schranken für den abstand zweier knoten bzw. eines punkts von einem knoten
+//
+// die lücke zwischen den projektionen auf eine normierte achse ist nie größer als der abstand,
+// geprüft werden die achsen beider boxen und die verbindung der mittelpunkte
+double LowerBound (const Box &a, const Box &b);
+double LowerBound (const double *p, const Box &b);
+
+double NodeSize (const vtkOBBNode *node);
+
+typedef double TriType[3][3];
+
+enum {
+    FEAT_A,
+    FEAT_B,
+    FEAT_C,
+    FEAT_AB,
+    FEAT_BC,
+    FEAT_CA,
+    FEAT_FACE
+};
+
+// nächster punkt im dreieck abc (nach ericson), liefert das element, auf dem er liegt
+int ClosestPtTri (const double *p, const double *a, const double *b, const double *c, double *q);
+
+// nächste punkte zweier strecken (nach ericson)
+void ClosestPtSegSeg (const double *pA, const double *qA, const double *pB, const double *qB, double *cA, double *cB);
+
+// schnitt der strecke pq mit dem dreieck abc, die seiten werden exakt bestimmt
+bool InterSegTri (const double *p, const double *q, const double *a, const double *b, const double *c, double *x);
+
+// 0, wenn sich die dreiecke schneiden
+double TriTriDistance (const TriType &triA, const TriType &triB, double *ptA, double *ptB);
+
+#endif
@@ -0,0 +1,457 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// führt boolesche operationen aus einer auftragsliste ohne slicer aus
+//
+// CombineModelsBatch [-j threads] [-m maxMemoryMB] [-o report.json] manifest.txt
+//
+// jede zeile der auftragsliste hat die form
+//
+//     inputA inputB union|intersection|difference|difference2 output
+//
+// leere zeilen und zeilen, die mit # beginnen, werden übersprungen
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cctype>
+#include <memory>
+
+#include <vtkSmartPointer.h>
+#include <vtkCommand.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSTLReader.h>
+#include <vtkPLYReader.h>
+#include <vtkOBJReader.h>
+#include <vtkXMLPolyDataReader.h>
+#include <vtkPolyDataReader.h>
+#include <vtkPolyDataWriter.h>
+
+#include "vtkPolyDataBooleanFilter.h"
+#include "vtkMappedMeshReader.h"
+#include "Sink.h"
+
+namespace {
+
+class Job {
+public:
+    Job () : operMode(OPER_UNION), ok(false), readTime(0), boolTime(0), writeTime(0), numPts(0), numCells(0), numLines(0), memory(0) {}
+
+    std::string inputA, inputB, oper, output, message;
+    int operMode;
+    bool ok;
+
+    double readTime, boolTime, writeTime;
+    std::vector<double> stages;
+
+    vtkIdType numPts, numCells, numLines;
+
+    std::size_t memory;
+};
+
+class ErrorObserver : public vtkCommand {
+public:
+    static ErrorObserver* New () { return new ErrorObserver; }
+
+    void Execute (vtkObject *vtkNotUsed(caller), unsigned long vtkNotUsed(event), void *data) override {
+        if (data != nullptr) {
+            if (!message.empty()) {
+                message += " ";
+            }
+            message += static_cast<const char*>(data);
+        }
+    }
+
+    std::string message;
+};
+
+std::string GetExt (const std::string &fileName) {
+    std::string::size_type i = fileName.rfind('.');
+
+    if (i == std::string::npos) {
+        return "";
+    }
+
+    std::string ext = fileName.substr(i+1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+    return ext;
+}
+
+std::size_t GetFileSize (const std::string &fileName) {
+    std::ifstream f(fileName, std::ios::binary | std::ios::ate);
+    return f ? static_cast<std::size_t>(f.tellg()) : 0;
+}
+
+vtkSmartPointer<vtkPolyDataAlgorithm> GetReader (const std::string &fileName) {
+    std::string ext = GetExt(fileName);
+
+    if ((ext == "stl" || ext == "ply") && vtkMappedMeshReader::CanReadFile(fileName.c_str())) {
+        auto reader = vtkSmartPointer<vtkMappedMeshReader>::New();
+        reader->SetFileName(fileName.c_str());
+        return reader;
+    } else if (ext == "stl") {
+        auto reader = vtkSmartPointer<vtkSTLReader>::New();
+        reader->SetFileName(fileName.c_str());
+        return reader;
+    } else if (ext == "ply") {
+        auto reader = vtkSmartPointer<vtkPLYReader>::New();
+        reader->SetFileName(fileName.c_str());
+        return reader;
+    } else if (ext == "obj") {
+        auto reader = vtkSmartPointer<vtkOBJReader>::New();
+        reader->SetFileName(fileName.c_str());
+        return reader;
+    } else if (ext == "vtp") {
+        auto reader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
+        reader->SetFileName(fileName.c_str());
+        return reader;
+    } else if (ext == "vtk") {
+        auto reader = vtkSmartPointer<vtkPolyDataReader>::New();
+        reader->SetFileName(fileName.c_str());
+        return reader;
+    }
+
+    return nullptr;
+}
+
+std::unique_ptr<Sink> GetSink (const std::string &fileName) {
+    std::string ext = GetExt(fileName);
+
+    if (ext == "stl") {
+        return std::unique_ptr<Sink>(new StlSink(fileName));
+    } else if (ext == "ply") {
+        return std::unique_ptr<Sink>(new PlySink(fileName));
+    } else if (ext == "vtp") {
+        return std::unique_ptr<Sink>(new VtpSink(fileName));
+    }
+
+    return nullptr;
+}
+
+bool Write (const std::string &fileName, vtkPolyData *pd) {
+    if (GetExt(fileName) == "vtk") {
+        auto writer = vtkSmartPointer<vtkPolyDataWriter>::New();
+        writer->SetFileName(fileName.c_str());
+        writer->SetFileTypeToBinary();
+        writer->SetInputData(pd);
+        return writer->Write() == 1;
+    }
+
+    return false;
+}
+
+double Seconds (std::chrono::steady_clock::duration d) {
+    return std::chrono::duration_cast<std::chrono::duration<double>>(d).count();
+}
+
+void RunJob (Job &job) {
+    using clock = std::chrono::steady_clock;
+
+    clock::time_point start = clock::now();
+
+    vtkSmartPointer<vtkPolyDataAlgorithm> readerA = GetReader(job.inputA),
+        readerB = GetReader(job.inputB);
+
+    if (readerA == nullptr || readerB == nullptr) {
+        job.message = "Unsupported input format.";
+        return;
+    }
+
+    vtkSmartPointer<ErrorObserver> errors = vtkSmartPointer<ErrorObserver>::New();
+
+    readerA->AddObserver(vtkCommand::ErrorEvent, errors);
+    readerB->AddObserver(vtkCommand::ErrorEvent, errors);
+
+    readerA->Update();
+    readerB->Update();
+
+    job.readTime = Seconds(clock::now()-start);
+
+    if (readerA->GetOutput()->GetNumberOfCells() == 0 || readerB->GetOutput()->GetNumberOfCells() == 0) {
+        job.message = errors->message.empty() ? "Empty input." : errors->message;
+        return;
+    }
+
+    start = clock::now();
+
+    // stl, ply und vtp werden direkt aus den regionen geschrieben, die schreibzeit steckt dann in booleanSeconds
+
+    std::unique_ptr<Sink> sink = GetSink(job.output);
+
+    auto bf = vtkSmartPointer<vtkPolyDataBooleanFilter>::New();
+    bf->AddObserver(vtkCommand::ErrorEvent, errors);
+    bf->SetInputData(0, readerA->GetOutput());
+    bf->SetInputData(1, readerB->GetOutput());
+    bf->SetOperMode(job.operMode);
+    bf->SetResultSink(sink.get());
+    bf->Update();
+
+    job.boolTime = Seconds(clock::now()-start);
+
+    for (int i = 0; i < bf->GetNumberOfTimings(); i++) {
+        job.stages.push_back(bf->GetTiming(i));
+    }
+
+    vtkPolyData *result = bf->GetOutput(0);
+
+    if (sink) {
+        job.numPts = sink->GetNumberOfPoints();
+        job.numCells = sink->GetNumberOfCells();
+    } else {
+        job.numPts = result->GetNumberOfPoints();
+        job.numCells = result->GetNumberOfCells();
+    }
+
+    job.numLines = bf->GetOutput(1)->GetNumberOfCells();
+
+    if (!errors->message.empty() || job.numCells == 0) {
+        job.message = errors->message.empty() ? "Empty result." : errors->message;
+        return;
+    }
+
+    if (!sink) {
+        start = clock::now();
+
+        if (!Write(job.output, result)) {
+            job.message = "Could not write " + job.output + ".";
+            return;
+        }
+
+        job.writeTime = Seconds(clock::now()-start);
+    }
+
+    job.ok = true;
+}
+
+std::string Escape (const std::string &s) {
+    std::ostringstream out;
+
+    for (char c : s) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out << buf;
+                } else {
+                    out << c;
+                }
+        }
+    }
+
+    return out.str();
+}
+
+void WriteReport (std::ostream &out, const std::vector<Job> &jobs, double total) {
+    out << "{\n  \"seconds\": " << total << ",\n  \"jobs\": [";
+
+    for (std::size_t i = 0; i < jobs.size(); i++) {
+        const Job &job = jobs[i];
+
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\n"
+            << "      \"inputA\": \"" << Escape(job.inputA) << "\",\n"
+            << "      \"inputB\": \"" << Escape(job.inputB) << "\",\n"
+            << "      \"operation\": \"" << Escape(job.oper) << "\",\n"
+            << "      \"output\": \"" << Escape(job.output) << "\",\n"
+            << "      \"status\": \"" << (job.ok ? "ok" : "failed") << "\",\n"
+            << "      \"message\": \"" << Escape(job.message) << "\",\n"
+            << "      \"readSeconds\": " << job.readTime << ",\n"
+            << "      \"booleanSeconds\": " << job.boolTime << ",\n"
+            << "      \"writeSeconds\": " << job.writeTime << ",\n"
+            << "      \"stageSeconds\": [";
+
+        for (std::size_t j = 0; j < job.stages.size(); j++) {
+            out << (j == 0 ? "" : ", ") << job.stages[j];
+        }
+
+        out << "],\n"
+            << "      \"contactLines\": " << job.numLines << ",\n"
+            << "      \"points\": " << job.numPts << ",\n"
+            << "      \"cells\": " << job.numCells << "\n"
+            << "    }";
+    }
+
+    out << "\n  ]\n}\n";
+}
+
+int Usage () {
+    std::cerr << "Usage: CombineModelsBatch [-j threads] [-m maxMemoryMB] [-o report.json] manifest.txt" << std::endl;
+    return EXIT_FAILURE;
+}
+
+}
+
+int main (int argc, char *argv[]) {
+
+    unsigned int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t maxMemory = 0;
+
+    std::string manifest, report;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "-j" && i+1 < argc) {
+            numThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "-m" && i+1 < argc) {
+            maxMemory = static_cast<std::size_t>(std::atoll(argv[++i]))*1024*1024;
+        } else if (arg == "-o" && i+1 < argc) {
+            report = argv[++i];
+        } else if (manifest.empty() && arg[0] != '-') {
+            manifest = arg;
+        } else {
+            return Usage();
+        }
+    }
+
+    if (manifest.empty()) {
+        return Usage();
+    }
+
+    std::ifstream in(manifest);
+
+    if (!in) {
+        std::cerr << "Could not open " << manifest << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Job> jobs;
+
+    std::string line;
+    int lineNum = 0;
+
+    while (std::getline(in, line)) {
+        lineNum++;
+
+        std::istringstream ls(line);
+
+        Job job;
+
+        if (!(ls >> job.inputA) || job.inputA[0] == '#') {
+            continue;
+        }
+
+        if (!(ls >> job.inputB >> job.oper >> job.output)) {
+            std::cerr << manifest << ":" << lineNum << ": expected inputA inputB operation output." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        if (job.oper == "union") {
+            job.operMode = OPER_UNION;
+        } else if (job.oper == "intersection") {
+            job.operMode = OPER_INTERSECTION;
+        } else if (job.oper == "difference") {
+            job.operMode = OPER_DIFFERENCE;
+        } else if (job.oper == "difference2") {
+            job.operMode = OPER_DIFFERENCE2;
+        } else {
+            std::cerr << manifest << ":" << lineNum << ": unknown operation " << job.oper << "." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // grobe schätzung des speicherbedarfs, die kopien im filter eingerechnet
+
+        job.memory = 40*(GetFileSize(job.inputA)+GetFileSize(job.inputB));
+
+        jobs.push_back(job);
+    }
+
+    // die aufträge werden in der reihenfolge der liste vergeben, ein auftrag startet erst, wenn sein
+    // geschätzter speicherbedarf ins budget passt (oder kein anderer läuft)
+
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    std::size_t next = 0, used = 0;
+    unsigned int running = 0;
+
+    auto worker = [&] () {
+        for (;;) {
+            std::size_t i;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+
+                cond.wait(lock, [&] () {
+                    return next == jobs.size() || maxMemory == 0 || running == 0 || used+jobs[next].memory <= maxMemory;
+                });
+
+                if (next == jobs.size()) {
+                    return;
+                }
+
+                i = next++;
+
+                used += jobs[i].memory;
+                running++;
+            }
+
+            RunJob(jobs[i]);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                used -= jobs[i].memory;
+                running--;
+
+                std::cerr << (jobs[i].ok ? "done " : "failed ") << jobs[i].output << std::endl;
+            }
+
+            cond.notify_all();
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+
+    for (unsigned int i = 0; i < std::min<std::size_t>(numThreads, jobs.size()); i++) {
+        threads.emplace_back(worker);
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    double total = Seconds(std::chrono::steady_clock::now()-start);
+
+    if (report.empty()) {
+        WriteReport(std::cout, jobs, total);
+    } else {
+        std::ofstream out(report);
+        WriteReport(out, jobs, total);
+    }
+
+    bool ok = std::all_of(jobs.begin(), jobs.end(), [] (const Job &job) { return job.ok; });
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
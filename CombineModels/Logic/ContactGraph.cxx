@@ -0,0 +1,285 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+
+#include <vtkPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIntArray.h>
+#include <vtkPoints.h>
+#include <vtkIdList.h>
+
+#include "ContactGraph.h"
+
+void ContactGraph::Init (vtkPolyData *pd) {
+    vtkIdType i, numPts = pd->GetNumberOfPoints(), numLines = pd->GetNumberOfCells();
+
+    pts.resize(3*numPts);
+
+    for (i = 0; i < numPts; i++) {
+        pd->GetPoint(i, pts.data()+3*i);
+    }
+
+    lines.resize(numLines);
+    deleted.assign(numLines, 0);
+
+    vtkIntArray *_contsA = vtkIntArray::SafeDownCast(pd->GetCellData()->GetScalars("cA"));
+    vtkIntArray *_contsB = vtkIntArray::SafeDownCast(pd->GetCellData()->GetScalars("cB"));
+
+    vtkIntArray *_sourcesA = vtkIntArray::SafeDownCast(pd->GetCellData()->GetScalars("sourcesA"));
+    vtkIntArray *_sourcesB = vtkIntArray::SafeDownCast(pd->GetCellData()->GetScalars("sourcesB"));
+
+    contsA.resize(numLines);
+    contsB.resize(numLines);
+
+    sourcesA.resize(numLines);
+    sourcesB.resize(numLines);
+
+    vtkIdType num;
+    const vtkIdType *line;
+
+    vtkCellArray *cells = pd->GetLines();
+
+    for (i = 0; i < numLines; i++) {
+        cells->GetCellAtId(i, num, line);
+
+        lines[i] = LineType{line[0], line[1]};
+
+        contsA[i] = _contsA->GetValue(i);
+        contsB[i] = _contsB->GetValue(i);
+
+        sourcesA[i] = {_sourcesA->GetValue(2*i), _sourcesA->GetValue(2*i+1)};
+        sourcesB[i] = {_sourcesB->GetValue(2*i), _sourcesB->GetValue(2*i+1)};
+    }
+
+    dirty = true;
+}
+
+void ContactGraph::Export (vtkPolyData *pd) const {
+    pd->Initialize();
+
+    vtkIdType i, numPts = GetNumberOfPoints(), numLines = GetNumberOfLines();
+
+    vtkPoints *_pts = vtkPoints::New();
+    _pts->SetDataTypeToDouble();
+    _pts->SetNumberOfPoints(numPts);
+
+    for (i = 0; i < numPts; i++) {
+        _pts->SetPoint(i, pts.data()+3*i);
+    }
+
+    pd->SetPoints(_pts);
+    pd->Allocate(numLines);
+
+    vtkIntArray *_contsA = vtkIntArray::New();
+    vtkIntArray *_contsB = vtkIntArray::New();
+
+    _contsA->SetName("cA");
+    _contsB->SetName("cB");
+
+    vtkIntArray *_sourcesA = vtkIntArray::New();
+    _sourcesA->SetNumberOfComponents(2);
+    _sourcesA->SetName("sourcesA");
+
+    vtkIntArray *_sourcesB = vtkIntArray::New();
+    _sourcesB->SetNumberOfComponents(2);
+    _sourcesB->SetName("sourcesB");
+
+    for (i = 0; i < numLines; i++) {
+        if (deleted[i]) {
+            pd->InsertNextCell(VTK_EMPTY_CELL, 0, nullptr);
+        } else {
+            pd->InsertNextCell(VTK_LINE, 2, lines[i].data());
+        }
+
+        _contsA->InsertNextValue(contsA[i]);
+        _contsB->InsertNextValue(contsB[i]);
+
+        _sourcesA->InsertNextTuple2(sourcesA[i][0], sourcesA[i][1]);
+        _sourcesB->InsertNextTuple2(sourcesB[i][0], sourcesB[i][1]);
+    }
+
+    pd->GetCellData()->AddArray(_contsA);
+    pd->GetCellData()->AddArray(_contsB);
+
+    pd->GetCellData()->AddArray(_sourcesA);
+    pd->GetCellData()->AddArray(_sourcesB);
+
+    _sourcesB->Delete();
+    _sourcesA->Delete();
+    _contsB->Delete();
+    _contsA->Delete();
+    _pts->Delete();
+}
+
+void ContactGraph::BuildLinks () {
+    vtkIdType i, numPts = GetNumberOfPoints(), numLines = GetNumberOfLines();
+
+    counts.assign(numPts, 0);
+
+    for (i = 0; i < numLines; i++) {
+        if (!deleted[i]) {
+            counts[lines[i][0]]++;
+            counts[lines[i][1]]++;
+        }
+    }
+
+    offsets.assign(numPts+1, 0);
+
+    for (i = 0; i < numPts; i++) {
+        offsets[i+1] = offsets[i]+counts[i];
+    }
+
+    links.resize(offsets.back());
+    extraLinks.clear();
+
+    // die linien eines punkts sind aufsteigend, wie nach vtkPolyData::BuildLinks; eine linie, die zu einem punkt
+    // zusammengefallen ist, steht dort ebenfalls zweimal
+
+    std::fill(counts.begin(), counts.end(), 0);
+
+    for (i = 0; i < numLines; i++) {
+        if (!deleted[i]) {
+            for (vtkIdType pt : lines[i]) {
+                links[offsets[pt]+counts[pt]++] = i;
+            }
+        }
+    }
+
+    dirty = false;
+}
+
+void ContactGraph::GetLines (vtkIdType pt, IdsType &ids) {
+    if (dirty) {
+        BuildLinks();
+    }
+
+    ids.assign(links.begin()+offsets[pt], links.begin()+offsets[pt]+counts[pt]);
+
+    std::size_t num = ids.size();
+
+    for (const LinkType &link : extraLinks) {
+        if (link[0] == pt) {
+            ids.push_back(link[1]);
+        }
+    }
+
+    if (ids.size() > num) {
+        std::sort(ids.begin()+num, ids.end());
+        std::inplace_merge(ids.begin(), ids.begin()+num, ids.end());
+    }
+}
+
+void ContactGraph::RemoveLink (vtkIdType pt, vtkIdType i) {
+    auto first = links.begin()+offsets[pt],
+        last = first+counts[pt],
+        itr = std::find(first, last, i);
+
+    if (itr != last) {
+        std::copy(itr+1, last, itr);
+        counts[pt]--;
+
+        return;
+    }
+
+    auto extra = std::find(extraLinks.begin(), extraLinks.end(), LinkType{pt, i});
+
+    if (extra != extraLinks.end()) {
+        extraLinks.erase(extra);
+    }
+}
+
+void ContactGraph::AddLink (vtkIdType pt, vtkIdType i) {
+    // passt die linie noch in den platz des punkts, wird sie dort einsortiert, sonst kommt sie in die überlaufliste
+
+    if (offsets[pt]+counts[pt] < offsets[pt+1]) {
+        auto first = links.begin()+offsets[pt],
+            last = first+counts[pt],
+            itr = std::upper_bound(first, last, i);
+
+        std::copy_backward(itr, last, last+1);
+        *itr = i;
+
+        counts[pt]++;
+
+        return;
+    }
+
+    extraLinks.push_back(LinkType{pt, i});
+
+    // wird die liste zu lang, lohnt sich der neuaufbau
+    if (extraLinks.size() > 64+counts.size()/16) {
+        dirty = true;
+    }
+}
+
+void ContactGraph::ReplacePoint (vtkIdType i, vtkIdType from, vtkIdType to) {
+    LineType &line = lines[i];
+
+    if (line[0] == from) {
+        line[0] = to;
+    } else if (line[1] == from) {
+        line[1] = to;
+    } else {
+        return;
+    }
+
+    if (dirty || deleted[i]) {
+        return;
+    }
+
+    // die linie wechselt einmal von der liste des einen in die des anderen punkts, die reihenfolge bleibt aufsteigend
+
+    RemoveLink(from, i);
+    AddLink(to, i);
+}
+
+void ContactGraph::DeleteLine (vtkIdType i) {
+    if (deleted[i]) {
+        return;
+    }
+
+    deleted[i] = 1;
+
+    if (dirty) {
+        return;
+    }
+
+    // nur aus den listen der beiden punkte entfernen, die reihenfolge bleibt
+
+    for (vtkIdType pt : lines[i]) {
+        RemoveLink(pt, i);
+    }
+}
+
+void ContactGraph::GetBounds (double *bnds) const {
+    bnds[0] = bnds[2] = bnds[4] = VTK_DOUBLE_MAX;
+    bnds[1] = bnds[3] = bnds[5] = -VTK_DOUBLE_MAX;
+
+    vtkIdType i, numLines = GetNumberOfLines();
+
+    for (i = 0; i < numLines; i++) {
+        if (deleted[i]) {
+            continue;
+        }
+
+        for (vtkIdType pt : lines[i]) {
+            for (int j = 0; j < 3; j++) {
+                bnds[2*j] = std::min(bnds[2*j], pts[3*pt+j]);
+                bnds[2*j+1] = std::max(bnds[2*j+1], pts[3*pt+j]);
+            }
+        }
+    }
+}
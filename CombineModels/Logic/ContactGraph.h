@@ -0,0 +1,94 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __ContactGraph_h
+#define __ContactGraph_h
+
+#include <vector>
+#include <array>
+
+#include <vtkType.h>
+
+#include "Tools.h"
+
+class vtkPolyData;
+
+typedef std::vector<int> ContsType;
+typedef std::vector<std::array<int, 2>> SourcesType;
+
+// die schnittlinien des vtkPolyDataContactFilter in getrennten arrays statt als vtkPolyData
+//
+// je linie die beiden punkte, die geschnittenen polygone (cA, cB) und die kanten, auf denen die enden liegen
+// (sourcesA, sourcesB); die linien je punkt werden einmal aufgebaut und danach von ReplacePoint und DeleteLine
+// mitgeführt, was nicht mehr an seinen platz passt, steht in einer kleinen überlaufliste; gelöschte linien behalten
+// ihre id
+
+class ContactGraph {
+    std::vector<double> pts;
+
+    typedef std::array<vtkIdType, 2> LineType;
+
+    std::vector<LineType> lines;
+    std::vector<char> deleted;
+
+    // linien je punkt, aufsteigend und hintereinander; der punkt pt hat counts[pt] linien ab offsets[pt]
+    std::vector<vtkIdType> offsets, counts, links;
+
+    // linien, die ReplacePoint einem punkt ohne freien platz zugeteilt hat, als punkt und linie
+    typedef std::array<vtkIdType, 2> LinkType;
+    std::vector<LinkType> extraLinks;
+
+    bool dirty;
+
+    void BuildLinks ();
+
+    void RemoveLink (vtkIdType pt, vtkIdType i);
+    void AddLink (vtkIdType pt, vtkIdType i);
+
+public:
+    ContactGraph () : dirty(true) {}
+
+    ContsType contsA, contsB;
+    SourcesType sourcesA, sourcesB;
+
+    // übernimmt den ersten output des vtkPolyDataContactFilter
+    void Init (vtkPolyData *pd);
+
+    // gelöschte linien werden zu leeren zellen, die anzahl der zellen bleibt also erhalten
+    void Export (vtkPolyData *pd) const;
+
+    vtkIdType GetNumberOfPoints () const { return static_cast<vtkIdType>(pts.size()/3); }
+    vtkIdType GetNumberOfLines () const { return static_cast<vtkIdType>(lines.size()); }
+
+    void GetPoint (vtkIdType i, double *pt) const {
+        pt[0] = pts[3*i];
+        pt[1] = pts[3*i+1];
+        pt[2] = pts[3*i+2];
+    }
+
+    const LineType& GetLine (vtkIdType i) const { return lines[i]; }
+
+    bool IsDeleted (vtkIdType i) const { return deleted[i] != 0; }
+
+    // die nicht gelöschten linien am punkt
+    void GetLines (vtkIdType pt, IdsType &ids);
+
+    void ReplacePoint (vtkIdType i, vtkIdType from, vtkIdType to);
+    void DeleteLine (vtkIdType i);
+
+    // über die punkte der nicht gelöschten linien
+    void GetBounds (double *bnds) const;
+};
+
+#endif
@@ -72,7 +72,10 @@ Decomposer::Decomposer (const PolyType &_orig) : orig(_orig), savedPts(new Saved
     }
     #endif
 
-    Simplify(orig, savedPts, specTags, poly, NO_USE, false);
+    // die vorarbeit von Simplify wird für alle sichtbarkeitspolygone wiederverwendet
+    SimplifyCache cache(orig);
+
+    Simplify(cache, savedPts, specTags, poly, NO_USE, false);
 
     std::copy(poly.begin(), poly.end(), std::back_inserter(verts));
 
@@ -111,7 +114,7 @@ Decomposer::Decomposer (const PolyType &_orig) : orig(_orig), savedPts(new Saved
             int i = itr2-orig.begin();
 
             PolyType vp;
-            GetVisPoly_wrapper(orig, vp, i);
+            GetVisPoly_wrapper(cache, vp, i);
 
             for (itr3 = vp.begin()+1; itr3 != vp.end(); ++itr3) {
                 if (itr3->id == NO_USE) {
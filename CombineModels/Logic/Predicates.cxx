@@ -0,0 +1,177 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cmath>
+#include <vector>
+#include <limits>
+
+#include "Predicates.h"
+
+namespace {
+
+// komponenten ohne überlappung, aufsteigend nach betrag, ohne nullen
+typedef std::vector<double> ExpansionType;
+
+const double eps = std::numeric_limits<double>::epsilon()/2;
+
+const double ccwErrBound = (3+16*eps)*eps;
+const double o3dErrBound = (7+56*eps)*eps;
+
+inline void TwoSum (double a, double b, double &x, double &y) {
+    x = a+b;
+    double bv = x-a,
+        av = x-bv;
+    y = (a-av)+(b-bv);
+}
+
+inline void TwoProduct (double a, double b, double &x, double &y) {
+    x = a*b;
+    y = std::fma(a, b, -x);
+}
+
+ExpansionType Grow (const ExpansionType &e, double b) {
+    ExpansionType h;
+
+    double q = b, hh;
+
+    for (double c : e) {
+        TwoSum(q, c, q, hh);
+
+        if (hh != 0) {
+            h.push_back(hh);
+        }
+    }
+
+    if (q != 0) {
+        h.push_back(q);
+    }
+
+    return h;
+}
+
+ExpansionType Sum (const ExpansionType &e, const ExpansionType &f) {
+    ExpansionType h(e);
+
+    for (double c : f) {
+        h = Grow(h, c);
+    }
+
+    return h;
+}
+
+ExpansionType Negate (ExpansionType e) {
+    for (double &c : e) {
+        c = -c;
+    }
+
+    return e;
+}
+
+ExpansionType Product (const ExpansionType &e, const ExpansionType &f) {
+    ExpansionType h;
+
+    double x, y;
+
+    for (double a : e) {
+        for (double b : f) {
+            TwoProduct(a, b, x, y);
+
+            if (y != 0) {
+                h = Grow(h, y);
+            }
+
+            h = Grow(h, x);
+        }
+    }
+
+    return h;
+}
+
+// exakte differenz zweier zahlen
+ExpansionType Diff (double a, double b) {
+    double x, y;
+    TwoSum(a, -b, x, y);
+
+    ExpansionType h;
+
+    if (y != 0) {
+        h.push_back(y);
+    }
+
+    if (x != 0) {
+        h.push_back(x);
+    }
+
+    return h;
+}
+
+double Estimate (const ExpansionType &e) {
+    double s = 0;
+
+    // die größte komponente bestimmt das vorzeichen
+    for (double c : e) {
+        s += c;
+    }
+
+    return s;
+}
+
+}
+
+double Orient2d (const double *a, const double *b, const double *c) {
+    double detLeft = (a[0]-c[0])*(b[1]-c[1]),
+        detRight = (a[1]-c[1])*(b[0]-c[0]),
+        det = detLeft-detRight;
+
+    if (std::abs(det) >= ccwErrBound*(std::abs(detLeft)+std::abs(detRight))) {
+        return det;
+    }
+
+    ExpansionType acx = Diff(a[0], c[0]),
+        acy = Diff(a[1], c[1]),
+        bcx = Diff(b[0], c[0]),
+        bcy = Diff(b[1], c[1]);
+
+    return Estimate(Sum(Product(acx, bcy), Negate(Product(acy, bcx))));
+}
+
+double Orient3d (const double *a, const double *b, const double *c, const double *d) {
+    double adx = a[0]-d[0], ady = a[1]-d[1], adz = a[2]-d[2],
+        bdx = b[0]-d[0], bdy = b[1]-d[1], bdz = b[2]-d[2],
+        cdx = c[0]-d[0], cdy = c[1]-d[1], cdz = c[2]-d[2];
+
+    double bdxcdy = bdx*cdy, cdxbdy = cdx*bdy,
+        cdxady = cdx*ady, adxcdy = adx*cdy,
+        adxbdy = adx*bdy, bdxady = bdx*ady;
+
+    double det = adz*(bdxcdy-cdxbdy)+bdz*(cdxady-adxcdy)+cdz*(adxbdy-bdxady);
+
+    double permanent = (std::abs(bdxcdy)+std::abs(cdxbdy))*std::abs(adz)
+        +(std::abs(cdxady)+std::abs(adxcdy))*std::abs(bdz)
+        +(std::abs(adxbdy)+std::abs(bdxady))*std::abs(cdz);
+
+    if (std::abs(det) >= o3dErrBound*permanent) {
+        return det;
+    }
+
+    ExpansionType eAdx = Diff(a[0], d[0]), eAdy = Diff(a[1], d[1]), eAdz = Diff(a[2], d[2]),
+        eBdx = Diff(b[0], d[0]), eBdy = Diff(b[1], d[1]), eBdz = Diff(b[2], d[2]),
+        eCdx = Diff(c[0], d[0]), eCdy = Diff(c[1], d[1]), eCdz = Diff(c[2], d[2]);
+
+    ExpansionType bc = Sum(Product(eBdx, eCdy), Negate(Product(eCdx, eBdy))),
+        ca = Sum(Product(eCdx, eAdy), Negate(Product(eAdx, eCdy))),
+        ab = Sum(Product(eAdx, eBdy), Negate(Product(eBdx, eAdy)));
+
+    return Estimate(Sum(Sum(Product(eAdz, bc), Product(eBdz, ca)), Product(eCdz, ab)));
+}
@@ -0,0 +1,29 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __Predicates_h
+#define __Predicates_h
+
+// orientierungstests nach shewchuk
+//
+// zuerst wird in gleitkomma gerechnet, reicht die fehlerschranke nicht aus, wird die determinante
+// mit expansionen exakt bestimmt, das vorzeichen des ergebnisses ist in jedem fall exakt
+
+// positiv, wenn a, b und c gegen den uhrzeigersinn liegen
+double Orient2d (const double *a, const double *b, const double *c);
+
+// positiv, wenn d unterhalb der ebene durch a, b und c liegt, die von oben gesehen gegen den uhrzeigersinn liegen
+double Orient3d (const double *a, const double *b, const double *c, const double *d);
+
+#endif
@@ -0,0 +1,488 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cmath>
+#include <algorithm>
+#include <utility>
+
+#include <vtkObjectFactory.h>
+#include <vtkInformation.h>
+#include <vtkInformationObjectBaseKey.h>
+#include <vtkPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+
+#include "RefitOBBTree.h"
+
+vtkStandardNewMacro(RefitOBBTree);
+
+void RefitOBBTree::Build (vtkPolyData *pd) {
+    SetDataSet(pd);
+    BuildLocator();
+
+    dirs.clear();
+    builtSize = 0;
+
+    if (Tree != nullptr) {
+        Collect(Tree);
+    }
+}
+
+void RefitOBBTree::Collect (vtkOBBNode *node) {
+    DirsType d;
+
+    double *u[] = {d.data(), d.data()+3, d.data()+6};
+
+    int i, num = 0;
+
+    for (i = 0; i < 3; i++) {
+        std::copy_n(node->Axes[i], 3, u[i]);
+
+        double l = vtkMath::Normalize(u[i]);
+
+        builtSize += l;
+
+        if (l > 0) {
+            num++;
+        }
+    }
+
+    // flache knoten (z.b. ein einzelnes dreieck) haben achsen der länge 0, die richtung wird ergänzt
+
+    if (num == 0) {
+        u[0][0] = 1; u[0][1] = 0; u[0][2] = 0;
+    }
+
+    if (num < 2) {
+        vtkMath::Perpendiculars(u[0], u[1], u[2], 0);
+    } else if (num == 2) {
+        vtkMath::Cross(u[0], u[1], u[2]);
+        vtkMath::Normalize(u[2]);
+    }
+
+    dirs.push_back(d);
+
+    if (node->Kids != nullptr) {
+        Collect(node->Kids[0]);
+        Collect(node->Kids[1]);
+    }
+}
+
+void RefitOBBTree::RefitNode (vtkOBBNode *node, vtkPolyData *pd, std::size_t &ind, double &size) {
+    const DirsType &d = dirs[ind++];
+
+    double lo[] = {VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, VTK_DOUBLE_MAX},
+        hi[] = {VTK_DOUBLE_MIN, VTK_DOUBLE_MIN, VTK_DOUBLE_MIN};
+
+    int i, j;
+
+    auto Add = [&](const double *p) {
+        for (int k = 0; k < 3; k++) {
+            double t = vtkMath::Dot(p, d.data()+3*k);
+
+            lo[k] = std::min(lo[k], t);
+            hi[k] = std::max(hi[k], t);
+        }
+    };
+
+    double p[3];
+
+    if (node->Kids != nullptr) {
+        RefitNode(node->Kids[0], pd, ind, size);
+        RefitNode(node->Kids[1], pd, ind, size);
+
+        // die ecken der kinder umschließen alle ihre punkte
+
+        for (vtkOBBNode *kid : {node->Kids[0], node->Kids[1]}) {
+            for (i = 0; i < 8; i++) {
+                std::copy_n(kid->Corner, 3, p);
+
+                for (j = 0; j < 3; j++) {
+                    if (i >> j & 1) {
+                        vtkMath::Add(p, kid->Axes[j], p);
+                    }
+                }
+
+                Add(p);
+            }
+        }
+
+    } else if (node->Cells != nullptr) {
+        vtkIdType num;
+        const vtkIdType *poly;
+
+        for (i = 0; i < node->Cells->GetNumberOfIds(); i++) {
+            pd->GetCellPoints(node->Cells->GetId(i), num, poly);
+
+            for (j = 0; j < num; j++) {
+                pd->GetPoint(poly[j], p);
+                Add(p);
+            }
+        }
+    }
+
+    if (lo[0] > hi[0]) {
+        return;
+    }
+
+    for (i = 0; i < 3; i++) {
+        node->Corner[i] = lo[0]*d[i]+lo[1]*d[3+i]+lo[2]*d[6+i];
+
+        for (j = 0; j < 3; j++) {
+            node->Axes[j][i] = (hi[j]-lo[j])*d[3*j+i];
+        }
+    }
+
+    size += (hi[0]-lo[0])+(hi[1]-lo[1])+(hi[2]-lo[2]);
+}
+
+bool RefitOBBTree::Refit (vtkPolyData *pd, double threshold) {
+    if (Tree == nullptr || dirs.empty()) {
+        return false;
+    }
+
+    SetDataSet(pd);
+
+    std::size_t ind = 0;
+    double size = 0;
+
+    RefitNode(Tree, pd, ind, size);
+
+    return size <= threshold*builtSize;
+}
+
+vtkOBBNode* RefitOBBTree::CopyNode (const vtkOBBNode *node, const CellMapType *map, vtkPolyData *pd, int level, int &depth) {
+    if (node->Kids != nullptr) {
+        vtkOBBNode *kidA = CopyNode(node->Kids[0], map, pd, level+1, depth),
+            *kidB = CopyNode(node->Kids[1], map, pd, level+1, depth);
+
+        if (kidA == nullptr || kidB == nullptr) {
+            // der verbliebene teilbaum rückt auf, depth ist dann nur eine obere schranke
+            return kidA != nullptr ? kidA : kidB;
+        }
+
+        vtkOBBNode *copy = new vtkOBBNode;
+
+        std::copy_n(node->Corner, 3, copy->Corner);
+        std::copy_n(&node->Axes[0][0], 9, &copy->Axes[0][0]);
+
+        copy->Kids = new vtkOBBNode*[2];
+        copy->Kids[0] = kidA;
+        copy->Kids[1] = kidB;
+
+        kidA->Parent = copy;
+        kidB->Parent = copy;
+
+        return copy;
+    }
+
+    if (node->Cells == nullptr) {
+        return nullptr;
+    }
+
+    std::vector<vtkIdType> cells;
+
+    for (vtkIdType i = 0; i < node->Cells->GetNumberOfIds(); i++) {
+        vtkIdType cellId = node->Cells->GetId(i);
+
+        if (map == nullptr) {
+            cells.push_back(cellId);
+        } else if (static_cast<std::size_t>(cellId) < map->size()) {
+            const std::vector<vtkIdType> &ids = (*map)[cellId];
+            cells.insert(cells.end(), ids.begin(), ids.end());
+        }
+    }
+
+    if (cells.empty()) {
+        return nullptr;
+    }
+
+    if (map != nullptr && cells.size() > 1) {
+        return SplitCells(cells, node, pd, level, depth);
+    }
+
+    vtkOBBNode *copy = new vtkOBBNode;
+
+    std::copy_n(node->Corner, 3, copy->Corner);
+    std::copy_n(&node->Axes[0][0], 9, &copy->Axes[0][0]);
+
+    copy->Cells = vtkIdList::New();
+
+    for (vtkIdType cellId : cells) {
+        copy->Cells->InsertNextId(cellId);
+    }
+
+    depth = std::max(depth, level);
+
+    return copy;
+}
+
+vtkOBBNode* RefitOBBTree::SplitCells (std::vector<vtkIdType> &cells, const vtkOBBNode *node, vtkPolyData *pd, int level, int &depth) {
+    // die teile liegen in der ebene der ursprünglichen zelle, deren achsen werden für alle neuen knoten übernommen
+
+    vtkOBBNode *split = new vtkOBBNode;
+
+    std::copy_n(node->Corner, 3, split->Corner);
+    std::copy_n(&node->Axes[0][0], 9, &split->Axes[0][0]);
+
+    if (cells.size() == 1) {
+        split->Cells = vtkIdList::New();
+        split->Cells->InsertNextId(cells[0]);
+
+        depth = std::max(depth, level);
+
+        return split;
+    }
+
+    int i, axis = 0;
+
+    for (i = 1; i < 3; i++) {
+        if (vtkMath::Norm(node->Axes[i]) > vtkMath::Norm(node->Axes[axis])) {
+            axis = i;
+        }
+    }
+
+    std::vector<std::pair<double, vtkIdType>> centers;
+
+    vtkIdType num;
+    const vtkIdType *poly;
+
+    double p[3];
+
+    for (vtkIdType cellId : cells) {
+        pd->GetCellPoints(cellId, num, poly);
+
+        double t = 0;
+
+        for (i = 0; i < num; i++) {
+            pd->GetPoint(poly[i], p);
+            t += vtkMath::Dot(p, node->Axes[axis]);
+        }
+
+        centers.emplace_back(t/num, cellId);
+    }
+
+    std::size_t half = centers.size()/2;
+
+    std::nth_element(centers.begin(), centers.begin()+half, centers.end());
+
+    std::vector<vtkIdType> cellsA, cellsB;
+
+    for (std::size_t j = 0; j < centers.size(); j++) {
+        (j < half ? cellsA : cellsB).push_back(centers[j].second);
+    }
+
+    split->Kids = new vtkOBBNode*[2];
+    split->Kids[0] = SplitCells(cellsA, node, pd, level+1, depth);
+    split->Kids[1] = SplitCells(cellsB, node, pd, level+1, depth);
+
+    split->Kids[0]->Parent = split;
+    split->Kids[1]->Parent = split;
+
+    return split;
+}
+
+void RefitOBBTree::SetTree (vtkOBBNode *root, int depth, vtkPolyData *pd) {
+    FreeSearchStructure();
+
+    Tree = root;
+
+    Level = depth;
+    DeepestLevel = depth;
+
+    SetDataSet(pd);
+
+    dirs.clear();
+    builtSize = 0;
+
+    if (Tree == nullptr) {
+        return;
+    }
+
+    Collect(Tree);
+
+    // die ausdehnungen nach dem anpassen gelten als die des aufbaus
+
+    std::size_t ind = 0;
+    double size = 0;
+
+    RefitNode(Tree, pd, ind, size);
+
+    builtSize = size;
+}
+
+void RefitOBBTree::Copy (RefitOBBTree *other, vtkPolyData *pd) {
+    int depth = 0;
+
+    SetTree(other->Tree != nullptr ? CopyNode(other->Tree, nullptr, pd, 0, depth) : nullptr, depth, pd);
+}
+
+void RefitOBBTree::Merge (vtkPolyData *pd, RefitOBBTree *treeA, const CellMapType &mapA, RefitOBBTree *treeB, const CellMapType &mapB) {
+    int depth = 0;
+
+    vtkOBBNode *rootA = treeA->Tree != nullptr ? CopyNode(treeA->Tree, &mapA, pd, 1, depth) : nullptr,
+        *rootB = treeB->Tree != nullptr ? CopyNode(treeB->Tree, &mapB, pd, 1, depth) : nullptr;
+
+    vtkOBBNode *root = rootA != nullptr ? rootA : rootB;
+
+    if (rootA != nullptr && rootB != nullptr) {
+        // die wurzel hat die achsen des koordinatensystems, ihre ausdehnung ergibt sich beim anpassen
+
+        root = new vtkOBBNode;
+
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                root->Axes[i][j] = i == j ? 1 : 0;
+            }
+        }
+
+        root->Kids = new vtkOBBNode*[2];
+        root->Kids[0] = rootA;
+        root->Kids[1] = rootB;
+
+        rootA->Parent = root;
+        rootB->Parent = root;
+    }
+
+    if (root != nullptr) {
+        root->Parent = nullptr;
+    }
+
+    SetTree(root, depth, pd);
+}
+
+CachedTree::CachedTree () : tree(nullptr), polys(nullptr), timePolys(0), numPts(0), refitted(false) {}
+
+CachedTree::~CachedTree () {
+    if (polys != nullptr) {
+        polys->Delete();
+    }
+
+    if (tree != nullptr) {
+        tree->Delete();
+    }
+}
+
+bool CachedTree::SameTopology (vtkPolyData *pd, vtkMTimeType time) {
+    if (tree == nullptr || pd->GetNumberOfPoints() != numPts || pd->GetNumberOfPolys() != polys->GetNumberOfCells()) {
+        return false;
+    }
+
+    if (time == timePolys) {
+        return true;
+    }
+
+    vtkCellArray *other = pd->GetPolys();
+
+    vtkIdType i, numA, numB;
+    const vtkIdType *polyA, *polyB;
+
+    for (i = 0; i < polys->GetNumberOfCells(); i++) {
+        polys->GetCellAtId(i, numA, polyA);
+        other->GetCellAtId(i, numB, polyB);
+
+        if (numA != numB || !std::equal(polyA, polyA+numA, polyB)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+RefitOBBTree* CachedTree::Get (vtkPolyData *pd, vtkMTimeType time, double threshold) {
+    // die zellen werden von PreparePolyData als polys abgelegt, andere typen gibt es hier nicht
+
+    refitted = threshold > 0 && SameTopology(pd, time) && tree->Refit(pd, threshold);
+
+    if (!refitted) {
+        if (tree == nullptr) {
+            tree = RefitOBBTree::New();
+            tree->SetNumberOfCellsPerNode(1);
+
+            polys = vtkCellArray::New();
+        }
+
+        tree->Build(pd);
+
+        polys->DeepCopy(pd->GetPolys());
+        numPts = pd->GetNumberOfPoints();
+    }
+
+    timePolys = time;
+
+    return tree;
+}
+
+void CachedTree::Adopt (RefitOBBTree *other, vtkPolyData *pd, vtkMTimeType time) {
+    if (SameTopology(pd, time)) {
+        // der eigene baum passt bereits
+        return;
+    }
+
+    if (tree == nullptr) {
+        tree = RefitOBBTree::New();
+        tree->SetNumberOfCellsPerNode(1);
+
+        polys = vtkCellArray::New();
+    }
+
+    // kopiert, da other weiter zu seinem datensatz gehört
+    tree->Copy(other, pd);
+
+    polys->DeepCopy(pd->GetPolys());
+    numPts = pd->GetNumberOfPoints();
+
+    timePolys = time;
+}
+
+vtkStandardNewMacro(SpatialIndex);
+
+vtkInformationKeyMacro(SpatialIndex, INDEX, ObjectBase);
+
+void SpatialIndex::Attach (vtkPolyData *pd, RefitOBBTree *tree) {
+    SpatialIndex *index = SpatialIndex::New();
+
+    // der baum hielte sonst pd über DataSet, pd ihn über die information, und keiner von beiden würde freigegeben;
+    // wer ihn übernimmt, kopiert ihn ohnehin auf den eigenen datensatz (CachedTree::Adopt)
+    tree->SetDataSet(nullptr);
+
+    index->tree = tree;
+    index->timePolys = pd->GetPolys()->GetMTime();
+    index->numCells = pd->GetNumberOfCells();
+
+    pd->GetInformation()->Set(INDEX(), index);
+
+    index->Delete();
+}
+
+void SpatialIndex::Detach (vtkPolyData *pd) {
+    pd->GetInformation()->Remove(INDEX());
+}
+
+RefitOBBTree* SpatialIndex::Find (vtkPolyData *pd) {
+    SpatialIndex *index = SpatialIndex::SafeDownCast(pd->GetInformation()->Get(INDEX()));
+
+    // nur polys, sonst ordnet PreparePolyData die zellen anders an
+
+    if (index == nullptr
+        || index->timePolys != pd->GetPolys()->GetMTime()
+        || index->numCells != pd->GetNumberOfCells()
+        || pd->GetNumberOfPolys() != pd->GetNumberOfCells()) {
+
+        return nullptr;
+    }
+
+    return index->tree;
+}
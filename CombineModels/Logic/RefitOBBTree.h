@@ -0,0 +1,146 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __RefitOBBTree_h
+#define __RefitOBBTree_h
+
+#include <array>
+#include <vector>
+
+#include <vtkOBBTree.h>
+#include <vtkSmartPointer.h>
+
+class vtkPolyData;
+class vtkPoints;
+class vtkCellArray;
+class vtkInformationObjectBaseKey;
+
+// zellen eines baums, auf die zellen von pd verteilt (z.b. die teile geschnittener zellen)
+typedef std::vector<std::vector<vtkIdType>> CellMapType;
+
+// obb-tree, der sich an verschobene punkte anpassen lässt, ohne neu aufgebaut zu werden
+//
+// die achsen jedes knotens bleiben beim anpassen erhalten, nur die ausdehnung wird von den blättern
+// aufwärts neu bestimmt, die zellen müssen dieselben sein wie beim aufbau
+
+class RefitOBBTree : public vtkOBBTree {
+    typedef std::array<double, 9> DirsType;
+
+    // normierte achsen der knoten in preorder
+    std::vector<DirsType> dirs;
+
+    // summe der kantenlängen aller knoten direkt nach dem aufbau
+    double builtSize;
+
+    void Collect (vtkOBBNode *node);
+    void RefitNode (vtkOBBNode *node, vtkPolyData *pd, std::size_t &ind, double &size);
+
+    vtkOBBNode* CopyNode (const vtkOBBNode *node, const CellMapType *map, vtkPolyData *pd, int level, int &depth);
+    vtkOBBNode* SplitCells (std::vector<vtkIdType> &cells, const vtkOBBNode *node, vtkPolyData *pd, int level, int &depth);
+    void SetTree (vtkOBBNode *root, int depth, vtkPolyData *pd);
+
+public:
+    vtkTypeMacro(RefitOBBTree, vtkOBBTree);
+    static RefitOBBTree* New ();
+
+    void Build (vtkPolyData *pd);
+
+    vtkOBBNode* GetRoot () { return Tree; }
+
+    // liefert false, wenn die knoten danach um mehr als den faktor threshold größer sind als beim aufbau
+    bool Refit (vtkPolyData *pd, double threshold);
+
+    // übernimmt den baum von other für pd, das dieselben zellen haben muss
+    void Copy (RefitOBBTree *other, vtkPolyData *pd);
+
+    // setzt den baum aus den bäumen zweier eingaben zusammen, deren zellen über die maps auf die zellen von pd verteilt sind
+    //
+    // teilbäume ohne zellen entfallen, nur blätter mit mehreren zellen werden entlang ihrer längsten achse neu geteilt,
+    // danach werden alle knoten an pd angepasst
+    void Merge (vtkPolyData *pd, RefitOBBTree *treeA, const CellMapType &mapA, RefitOBBTree *treeB, const CellMapType &mapB);
+
+protected:
+    RefitOBBTree () : builtSize(0) {}
+    ~RefitOBBTree () {}
+
+private:
+    RefitOBBTree (const RefitOBBTree&) = delete;
+    void operator= (const RefitOBBTree&) = delete;
+};
+
+// hält den baum einer eingabe über mehrere durchläufe
+//
+// bleiben die zellen gleich, wird der baum nur angepasst, ob sie gleich geblieben sind, wird an der MTime
+// des zell-arrays der eingabe und notfalls am inhalt erkannt
+
+class CachedTree {
+    RefitOBBTree *tree;
+    vtkCellArray *polys;
+
+    vtkMTimeType timePolys;
+    vtkIdType numPts;
+
+    bool refitted;
+
+    bool SameTopology (vtkPolyData *pd, vtkMTimeType time);
+
+public:
+    CachedTree ();
+    ~CachedTree ();
+
+    CachedTree (const CachedTree&) = delete;
+    CachedTree& operator= (const CachedTree&) = delete;
+
+    // bei threshold 0 wird immer neu aufgebaut
+    RefitOBBTree* Get (vtkPolyData *pd, vtkMTimeType time, double threshold);
+
+    bool WasRefitted () const { return refitted; }
+
+    // übernimmt einen fertigen baum, der zu den zellen von pd passt, der nächste aufruf von Get passt ihn nur noch an
+    void Adopt (RefitOBBTree *other, vtkPolyData *pd, vtkMTimeType time);
+};
+
+// hängt einen baum an die information eines datensatzes, damit nachfolgende filter ihn übernehmen können
+//
+// der baum gilt nur, solange die polys des datensatzes dieselben sind wie beim anhängen; abgelegt wird er ohne
+// DataSet, gebunden wird er erst beim übernehmen
+
+class SpatialIndex : public vtkObject {
+    vtkSmartPointer<RefitOBBTree> tree;
+
+    vtkMTimeType timePolys;
+    vtkIdType numCells;
+
+public:
+    vtkTypeMacro(SpatialIndex, vtkObject);
+    static SpatialIndex* New ();
+
+    static vtkInformationObjectBaseKey* INDEX ();
+
+    static void Attach (vtkPolyData *pd, RefitOBBTree *tree);
+    static void Detach (vtkPolyData *pd);
+
+    // nullptr, wenn pd keinen passenden baum hat
+    static RefitOBBTree* Find (vtkPolyData *pd);
+
+protected:
+    SpatialIndex () : timePolys(0), numCells(0) {}
+    ~SpatialIndex () {}
+
+private:
+    SpatialIndex (const SpatialIndex&) = delete;
+    void operator= (const SpatialIndex&) = delete;
+};
+
+#endif
@@ -0,0 +1,395 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "Sink.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <iomanip>
+
+#include <vtkPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIntArray.h>
+#include <vtkIdList.h>
+#include <vtkPoints.h>
+#include <vtkPolygon.h>
+#include <vtkTriangle.h>
+
+namespace {
+
+bool IsBigEndian () {
+    const std::uint16_t v = 1;
+    return *reinterpret_cast<const unsigned char*>(&v) == 0;
+}
+
+// schreibt little endian
+template<typename T>
+void Put (std::ostream &out, T v) {
+    char b[sizeof(T)];
+    std::memcpy(b, &v, sizeof(T));
+
+    if (IsBigEndian()) {
+        std::reverse(b, b+sizeof(T));
+    }
+
+    out.write(b, sizeof(T));
+}
+
+std::string Base64 (const unsigned char *data, std::size_t size) {
+    static const char *chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string res;
+    res.reserve((size+2)/3*4);
+
+    std::size_t i;
+
+    for (i = 0; i+2 < size; i += 3) {
+        std::uint32_t v = (data[i] << 16) | (data[i+1] << 8) | data[i+2];
+
+        res += chars[(v >> 18) & 63];
+        res += chars[(v >> 12) & 63];
+        res += chars[(v >> 6) & 63];
+        res += chars[v & 63];
+    }
+
+    if (i+1 == size) {
+        std::uint32_t v = data[i] << 16;
+
+        res += chars[(v >> 18) & 63];
+        res += chars[(v >> 12) & 63];
+        res += "==";
+    } else if (i+2 == size) {
+        std::uint32_t v = (data[i] << 16) | (data[i+1] << 8);
+
+        res += chars[(v >> 18) & 63];
+        res += chars[(v >> 12) & 63];
+        res += chars[(v >> 6) & 63];
+        res += '=';
+    }
+
+    return res;
+}
+
+}
+
+StlSink::StlSink (const std::string &_fileName) : fileName(_fileName) {
+    polygon = vtkSmartPointer<vtkPolygon>::New();
+    tris = vtkSmartPointer<vtkIdList>::New();
+}
+
+bool StlSink::Begin () {
+    numPts = 0;
+    numCells = 0;
+
+    out.open(fileName, std::ios::binary | std::ios::trunc);
+
+    if (!out) {
+        return false;
+    }
+
+    char header[80] = {};
+    std::strncpy(header, "CombineModels", sizeof(header));
+
+    out.write(header, 80);
+
+    // anzahl wird in End() nachgetragen
+    Put<std::uint32_t>(out, 0);
+
+    return out.good();
+}
+
+bool StlSink::Add (vtkPolyData *pd) {
+    vtkPoints *pts = pd->GetPoints();
+
+    if (pts == nullptr) {
+        return true;
+    }
+
+    vtkCellArray *polys = pd->GetPolys();
+
+    vtkIdType n, i, j;
+    const vtkIdType *poly;
+
+    double a[3], b[3], c[3], normal[3];
+
+    auto WriteTri = [&] (vtkIdType idA, vtkIdType idB, vtkIdType idC) {
+        pts->GetPoint(idA, a);
+        pts->GetPoint(idB, b);
+        pts->GetPoint(idC, c);
+
+        vtkTriangle::ComputeNormal(a, b, c, normal);
+
+        for (j = 0; j < 3; j++) {
+            Put<float>(out, static_cast<float>(normal[j]));
+        }
+
+        for (const double *p : {a, b, c}) {
+            for (j = 0; j < 3; j++) {
+                Put<float>(out, static_cast<float>(p[j]));
+            }
+        }
+
+        Put<std::uint16_t>(out, 0);
+
+        numCells++;
+    };
+
+    for (polys->InitTraversal(); polys->GetNextCell(n, poly);) {
+        if (n == 3) {
+            WriteTri(poly[0], poly[1], poly[2]);
+
+        } else if (n > 3) {
+            polygon->GetPointIds()->SetNumberOfIds(n);
+            polygon->GetPoints()->SetNumberOfPoints(n);
+
+            for (i = 0; i < n; i++) {
+                polygon->GetPointIds()->SetId(i, poly[i]);
+                polygon->GetPoints()->SetPoint(i, pts->GetPoint(poly[i]));
+            }
+
+            tris->Reset();
+            polygon->Triangulate(tris);
+
+            for (i = 0; i+2 < tris->GetNumberOfIds(); i += 3) {
+                WriteTri(poly[tris->GetId(i)], poly[tris->GetId(i+1)], poly[tris->GetId(i+2)]);
+            }
+        }
+    }
+
+    numPts += pts->GetNumberOfPoints();
+
+    return out.good();
+}
+
+bool StlSink::End () {
+    out.seekp(80);
+    Put<std::uint32_t>(out, static_cast<std::uint32_t>(numCells));
+
+    out.close();
+
+    return !out.fail();
+}
+
+PlySink::PlySink (const std::string &_fileName) : fileName(_fileName) {}
+
+bool PlySink::Begin () {
+    numPts = 0;
+    numCells = 0;
+
+    out.open(fileName, std::ios::binary | std::ios::trunc);
+
+    if (!out) {
+        return false;
+    }
+
+    // die flächen kommen erst nach allen punkten, bis dahin stehen sie neben der datei statt im speicher
+
+    facesName = fileName+".faces";
+
+    faces.open(facesName, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+
+    if (!faces) {
+        out.close();
+        return false;
+    }
+
+    out << "ply\n"
+        << "format binary_little_endian 1.0\n"
+        << "comment CombineModels\n";
+
+    // platzhalter fester breite für die anzahlen
+    countsPos = out.tellp();
+
+    out << "element vertex " << std::setw(20) << 0 << "\n"
+        << "property double x\n"
+        << "property double y\n"
+        << "property double z\n"
+        << "element face " << std::setw(20) << 0 << "\n"
+        << "property list int int vertex_indices\n"
+        << "end_header\n";
+
+    return out.good();
+}
+
+bool PlySink::Add (vtkPolyData *pd) {
+    vtkPoints *pts = pd->GetPoints();
+
+    if (pts == nullptr) {
+        return true;
+    }
+
+    vtkIdType n, i, num = pts->GetNumberOfPoints();
+    const vtkIdType *poly;
+
+    double pt[3];
+
+    for (i = 0; i < num; i++) {
+        pts->GetPoint(i, pt);
+
+        Put<double>(out, pt[0]);
+        Put<double>(out, pt[1]);
+        Put<double>(out, pt[2]);
+    }
+
+    vtkCellArray *polys = pd->GetPolys();
+
+    for (polys->InitTraversal(); polys->GetNextCell(n, poly);) {
+        Put<std::int32_t>(faces, static_cast<std::int32_t>(n));
+
+        for (i = 0; i < n; i++) {
+            Put<std::int32_t>(faces, static_cast<std::int32_t>(numPts+poly[i]));
+        }
+    }
+
+    numPts += num;
+    numCells += pd->GetNumberOfPolys();
+
+    return out.good() && faces.good();
+}
+
+bool PlySink::End () {
+    bool ok = faces.good();
+
+    if (ok && numCells > 0) {
+        faces.flush();
+        faces.seekg(0);
+
+        out << faces.rdbuf();
+    }
+
+    faces.close();
+    std::remove(facesName.c_str());
+
+    out.seekp(countsPos);
+
+    out << "element vertex " << std::setw(20) << numPts << "\n"
+        << "property double x\n"
+        << "property double y\n"
+        << "property double z\n"
+        << "element face " << std::setw(20) << numCells << "\n";
+
+    out.close();
+
+    return ok && !out.fail();
+}
+
+VtpSink::VtpSink (const std::string &_fileName) : fileName(_fileName) {}
+
+void VtpSink::WriteArray (const char *type, const char *name, int comps, const void *data, std::size_t size) {
+    std::vector<unsigned char> buf(sizeof(std::uint64_t)+size);
+
+    std::uint64_t s = size;
+    std::memcpy(buf.data(), &s, sizeof(s));
+    std::memcpy(buf.data()+sizeof(s), data, size);
+
+    out << "        <DataArray type=\"" << type << "\"";
+
+    if (name != nullptr) {
+        out << " Name=\"" << name << "\"";
+    }
+
+    out << " NumberOfComponents=\"" << comps << "\" format=\"binary\">\n"
+        << "          " << Base64(buf.data(), buf.size()) << "\n"
+        << "        </DataArray>\n";
+}
+
+bool VtpSink::Begin () {
+    numPts = 0;
+    numCells = 0;
+
+    out.open(fileName, std::ios::binary | std::ios::trunc);
+
+    if (!out) {
+        return false;
+    }
+
+    out << "<?xml version=\"1.0\"?>\n"
+        << "<VTKFile type=\"PolyData\" version=\"1.0\" byte_order=\"" << (IsBigEndian() ? "BigEndian" : "LittleEndian") << "\" header_type=\"UInt64\">\n"
+        << "  <PolyData>\n";
+
+    return out.good();
+}
+
+bool VtpSink::Add (vtkPolyData *pd) {
+    vtkPoints *pts = pd->GetPoints();
+
+    if (pts == nullptr) {
+        return true;
+    }
+
+    vtkIdType n, i, num = pts->GetNumberOfPoints(),
+        numPolys = pd->GetNumberOfPolys();
+
+    const vtkIdType *poly;
+
+    out << "    <Piece NumberOfPoints=\"" << num << "\" NumberOfVerts=\"0\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"" << numPolys << "\">\n"
+        << "      <CellData>\n";
+
+    for (const char *name : {"OrigCellIdsA", "OrigCellIdsB"}) {
+        vtkIntArray *ids = vtkIntArray::SafeDownCast(pd->GetCellData()->GetArray(name));
+
+        if (ids != nullptr && ids->GetNumberOfTuples() == numPolys) {
+            WriteArray("Int32", name, 1, ids->GetPointer(0), numPolys*sizeof(int));
+        }
+    }
+
+    out << "      </CellData>\n"
+        << "      <Points>\n";
+
+    std::vector<double> coords(3*num);
+
+    for (i = 0; i < num; i++) {
+        pts->GetPoint(i, &coords[3*i]);
+    }
+
+    WriteArray("Float64", nullptr, 3, coords.data(), coords.size()*sizeof(double));
+
+    std::vector<double>().swap(coords);
+
+    out << "      </Points>\n"
+        << "      <Polys>\n";
+
+    std::vector<std::int64_t> conn, offsets;
+    offsets.reserve(numPolys);
+
+    vtkCellArray *polys = pd->GetPolys();
+
+    for (polys->InitTraversal(); polys->GetNextCell(n, poly);) {
+        conn.insert(conn.end(), poly, poly+n);
+        offsets.push_back(static_cast<std::int64_t>(conn.size()));
+    }
+
+    WriteArray("Int64", "connectivity", 1, conn.data(), conn.size()*sizeof(std::int64_t));
+    WriteArray("Int64", "offsets", 1, offsets.data(), offsets.size()*sizeof(std::int64_t));
+
+    out << "      </Polys>\n"
+        << "    </Piece>\n";
+
+    numPts += num;
+    numCells += numPolys;
+
+    return out.good();
+}
+
+bool VtpSink::End () {
+    out << "  </PolyData>\n"
+        << "</VTKFile>\n";
+
+    out.close();
+
+    return !out.fail();
+}
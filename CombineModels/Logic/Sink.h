@@ -0,0 +1,98 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __Sink_h
+#define __Sink_h
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include <vtkType.h>
+#include <vtkSmartPointer.h>
+
+class vtkPolyData;
+class vtkPolygon;
+class vtkIdList;
+
+// nimmt die regionen des ergebnisses entgegen, sobald sie feststehen
+//
+// der vtkPolyDataBooleanFilter ruft Add() je eingabe einmal mit deren übernommenen regionen auf, samt der
+// zell-arrays OrigCellIdsA und OrigCellIdsB; die punkte verschiedener aufrufe werden nicht zusammengeführt
+
+class Sink {
+public:
+    Sink () : numPts(0), numCells(0) {}
+    virtual ~Sink () {}
+
+    virtual bool Begin () = 0;
+    virtual bool Add (vtkPolyData *pd) = 0;
+    virtual bool End () = 0;
+
+    vtkIdType GetNumberOfPoints () const { return numPts; }
+    vtkIdType GetNumberOfCells () const { return numCells; }
+
+protected:
+    vtkIdType numPts, numCells;
+};
+
+// binäre stl, polygone werden trianguliert
+class StlSink : public Sink {
+    std::string fileName;
+    std::ofstream out;
+
+    vtkSmartPointer<vtkPolygon> polygon;
+    vtkSmartPointer<vtkIdList> tris;
+
+public:
+    StlSink (const std::string &_fileName);
+
+    bool Begin () override;
+    bool Add (vtkPolyData *pd) override;
+    bool End () override;
+};
+
+// binäre ply, die flächen müssen nach allen punkten kommen, sie werden daher in eine datei neben dem ziel
+// geschrieben und in End() angehängt
+class PlySink : public Sink {
+    std::string fileName, facesName;
+    std::ofstream out;
+    std::fstream faces;
+
+    std::streampos countsPos;
+
+public:
+    PlySink (const std::string &_fileName);
+
+    bool Begin () override;
+    bool Add (vtkPolyData *pd) override;
+    bool End () override;
+};
+
+// vtp mit einem Piece je region
+class VtpSink : public Sink {
+    std::string fileName;
+    std::ofstream out;
+
+    void WriteArray (const char *type, const char *name, int comps, const void *data, std::size_t size);
+
+public:
+    VtpSink (const std::string &_fileName);
+
+    bool Begin () override;
+    bool Add (vtkPolyData *pd) override;
+    bool End () override;
+};
+
+#endif
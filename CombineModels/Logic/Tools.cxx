@@ -19,6 +19,7 @@ limitations under the License.
 #include <cfloat>
 
 #include "Tools.h"
+#include "Predicates.h"
 
 double Normalize (double *v, const int n) {
     double l;
@@ -61,28 +62,27 @@ bool Ld (double *a, double *b, double *c, double *r) {
 }
 
 double Cross (double *a, double *b, double *c) {
-    // kreuzprodukt der vektoren ab und ac
-    return (b[1]-a[1])*(c[0]-a[0])-(b[0]-a[0])*(c[1]-a[1]);
+    // kreuzprodukt der vektoren ab und ac, mit exaktem vorzeichen
+    return -Orient2d(a, b, c);
 }
 
 std::shared_ptr<D> Intersect (const double *o, const double *r, const double *pA, const double *pB) {
     double oB[] = {o[0]+r[0], o[1]+r[1]};
 
-    double m11 = oB[0]-o[0],
-        m12 = pA[0]-pB[0],
-        m21 = oB[1]-o[1],
-        m22 = pA[1]-pB[1],
-        v1 = pA[0]-o[0],
-        v2 = pA[1]-o[1];
+    // seiten von pA und pB zur geraden und von o zur kante, die vorzeichen sind exakt
 
-    double det = m11*m22-m12*m21;
+    double sA = Orient2d(o, oB, pA),
+        sB = Orient2d(o, oB, pB),
+        q = Orient2d(pA, pB, o);
+
+    double det = sA-sB;
 
     if (std::abs(det) < E) {
         return nullptr;
     }
 
-    double t1 = (v1*m22-m12*v2)/det,
-        t2 = (m11*v2-v1*m21)/det;
+    double t1 = -q/det,
+        t2 = sA/det;
 
     if (t2 > -E && t2 < 1-E) {
         double s[] = {pA[0]+t2*(pB[0]-pA[0]), pA[1]+t2*(pB[1]-pA[1])};
@@ -93,21 +93,20 @@ std::shared_ptr<D> Intersect (const double *o, const double *r, const double *pA
 }
 
 std::shared_ptr<D> Intersect2 (const double *oA, const double *oB, const double *pA, const double *pB, const Bnds &bnds) {
-    double m11 = oB[0]-oA[0],
-        m12 = pA[0]-pB[0],
-        m21 = oB[1]-oA[1],
-        m22 = pA[1]-pB[1],
-        v1 = pA[0]-oA[0],
-        v2 = pA[1]-oA[1];
+    // wie bei Intersect, liegen die enden einer strecke auf verschiedenen seiten der anderen, ist das auch für t exakt
+
+    double sA = Orient2d(oA, oB, pA),
+        sB = Orient2d(oA, oB, pB),
+        q = Orient2d(pA, pB, oA);
 
-    double det = m11*m22-m12*m21;
+    double det = sA-sB;
 
     if (std::abs(det) < E) {
         return nullptr;
     }
 
-    double t1 = (v1*m22-m12*v2)/det,
-        t2 = (m11*v2-v1*m21)/det;
+    double t1 = -q/det,
+        t2 = sA/det;
 
     // if ((t1 > -E && t1 < 1+E)
     //     && (t2 > E && t2 < 1+E)) {
@@ -267,4 +266,4 @@ void GetSect (int tagA, int tagB, PolyType &poly) {
     })+1, poly.end());
 }
 
-int Point::_tag;
+std::atomic<int> Point::_tag(0);
@@ -27,6 +27,7 @@ limitations under the License.
 #include <algorithm>
 #include <cfloat>
 #include <exception>
+#include <atomic>
 
 #include <vtkType.h> // for vtkIdType
 
@@ -59,7 +60,8 @@ public:
 typedef std::vector<int> IdsType;
 
 class Point {
-    static int _tag;
+    // mehrere filter können gleichzeitig in verschiedenen threads laufen
+    static std::atomic<int> _tag;
 public:
     Point (double _x, double _y, int _id = NO_USE) : id(_id), tag(_tag++) {
         pt[0] = _x;
@@ -22,7 +22,9 @@ limitations under the License.
 #include <vtkIdList.h>
 #include <vtkMath.h>
 #include <vtkPolyData.h>
+#include <vtkCellArray.h>
 #include <vtkDataWriter.h>
+#include <vtkTriangleFilter.h>
 
 void ComputeNormal (vtkPoints *pts, double *n, vtkIdList *poly) {
     n[0] = 0; n[1] = 0; n[2] = 0;
@@ -223,3 +225,64 @@ void ComputeNormal (vtkPoints *pts, double *n, vtkIdType num, const vtkIdType *p
 
     vtkMath::Normalize(n);
 }
+
+void Triangulate (vtkPolyData *pd, vtkPolyData *tris) {
+    vtkTriangleFilter *tf = vtkTriangleFilter::New();
+    tf->SetInputData(pd);
+    tf->PassLinesOff();
+    tf->PassVertsOff();
+    tf->Update();
+
+    tris->ShallowCopy(tf->GetOutput());
+
+    tf->Delete();
+}
+
+void AddVolumes (vtkPolyData *pd, vtkDataArray *regions, const double *ref, std::vector<double> &vols, std::vector<double> &areas) {
+    vtkCellArray *polys = pd->GetPolys();
+
+    vtkIdType i, j, num;
+    const vtkIdType *poly;
+
+    double p0[3], a[3], b[3], c[3], n[3];
+
+    for (i = 0; i < polys->GetNumberOfCells(); i++) {
+        polys->GetCellAtId(i, num, poly);
+
+        if (num < 3) {
+            continue;
+        }
+
+        std::size_t reg = regions != nullptr ? static_cast<std::size_t>(regions->GetTuple1(poly[0])) : 0;
+
+        if (reg >= vols.size()) {
+            vols.resize(reg+1, 0);
+            areas.resize(reg+1, 0);
+        }
+
+        pd->GetPoint(poly[0], p0);
+        vtkMath::Subtract(p0, ref, p0);
+
+        // summe der kreuzprodukte, bei ebenen polygonen auch bei konkaven exakt
+        double sum[] = {0, 0, 0};
+
+        for (j = 1; j < num-1; j++) {
+            pd->GetPoint(poly[j], a);
+            pd->GetPoint(poly[j+1], b);
+
+            vtkMath::Subtract(a, ref, a);
+            vtkMath::Subtract(b, ref, b);
+
+            vtkMath::Cross(a, b, c);
+            vols[reg] += vtkMath::Dot(p0, c)/6;
+
+            vtkMath::Subtract(a, p0, a);
+            vtkMath::Subtract(b, p0, b);
+
+            vtkMath::Cross(a, b, n);
+            vtkMath::Add(sum, n, sum);
+        }
+
+        areas[reg] += vtkMath::Norm(sum)/2;
+    }
+}
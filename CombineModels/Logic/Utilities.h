@@ -18,8 +18,10 @@ limitations under the License.
 #define __Utilities_h
 
 #include <iostream>
+#include <vector>
 
 #include <vtkPolyData.h>
+#include <vtkDataArray.h>
 #include <vtkKdTreePointLocator.h>
 #include <vtkPoints.h>
 #include <vtkIdList.h>
@@ -27,14 +29,27 @@ limitations under the License.
 
 #include "Tools.h"
 
+// punkte, die näher als SNAP_TOL beieinander liegen, gelten als identisch, ebenso liegt ein punkt, der näher an
+// einer geraden liegt, auf ihr
+#define SNAP_TOL 1e-6
+
 double GetAngle (double *vA, double *vB, double *n);
 double GetD (double *a, double *b);
 
 /* VTK */
 void ComputeNormal (vtkPoints *pts, double *n, vtkIdList *poly = nullptr);
-void FindPoints (vtkKdTreePointLocator *pl, const double *pt, vtkIdList *pts, double tol = 1e-6);
+void FindPoints (vtkKdTreePointLocator *pl, const double *pt, vtkIdList *pts, double tol = SNAP_TOL);
 void WriteVTK (const char *name, vtkPolyData *pd);
 
+// nur die polygone, in dreiecke zerlegt
+void Triangulate (vtkPolyData *pd, vtkPolyData *tris);
+
+// vorzeichenbehaftetes volumen (bezogen auf ref) und fläche der polygone, aufgeteilt nach den punkt-skalaren regions
+//
+// die polygone werden als fächer zerlegt, bei nullptr kommt alles in die erste region; geschlossene,
+// nach außen orientierte oberflächen haben ein positives volumen, das dann nicht mehr von ref abhängt
+void AddVolumes (vtkPolyData *pd, vtkDataArray *regions, const double *ref, std::vector<double> &vols, std::vector<double> &areas);
+
 inline void ComputeNormal2 (vtkPolyData *pd, double *n, vtkIdType num, const vtkIdType *poly) {
     n[0] = 0; n[1] = 0; n[2] = 0;
 
@@ -0,0 +1,344 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <sstream>
+#include <numeric>
+
+#include <vtkPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkIdList.h>
+#include <vtkMatrix4x4.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
+
+#include "Validation.h"
+#include "RefitOBBTree.h"
+#include "ClosestPoints.h"
+#include "Utilities.h"
+
+namespace {
+
+// beide punkte aufsteigend, dazu das polygon
+typedef std::array<vtkIdType, 3> EdgeType;
+
+vtkIdType Find (std::vector<vtkIdType> &parents, vtkIdType i) {
+    while (parents[i] != i) {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+
+    return i;
+}
+
+bool CheckEdges (vtkPolyData *pd, std::string &msg) {
+    vtkCellArray *polys = pd->GetPolys(),
+        *strips = pd->GetStrips();
+
+    vtkIdType i, numPolys = polys->GetNumberOfCells(), numCells = numPolys+strips->GetNumberOfCells();
+
+    // jedes polygon schreibt seine kanten ab dieser stelle, ein strip die seiner dreiecke; die strips werden
+    // wie in vtkPolyData hinter den polygonen gezählt
+
+    std::vector<vtkIdType> offsets(numCells+1, 0);
+
+    for (i = 0; i < numPolys; i++) {
+        offsets[i+1] = offsets[i]+polys->GetCellSize(i);
+    }
+
+    for (i = numPolys; i < numCells; i++) {
+        offsets[i+1] = offsets[i]+3*std::max<vtkIdType>(0, strips->GetCellSize(i-numPolys)-2);
+    }
+
+    std::vector<EdgeType> edges(offsets.back());
+
+    vtkSMPTools::For(0, numCells, [&](vtkIdType first, vtkIdType last) {
+        vtkSmartPointer<vtkIdList> cell = vtkSmartPointer<vtkIdList>::New();
+
+        for (vtkIdType j = first; j < last; j++) {
+            if (j < numPolys) {
+                polys->GetCellAtId(j, cell);
+
+                vtkIdType num = cell->GetNumberOfIds();
+
+                for (vtkIdType k = 0; k < num; k++) {
+                    vtkIdType a = cell->GetId(k),
+                        b = cell->GetId((k+1)%num);
+
+                    edges[offsets[j]+k] = EdgeType{std::min(a, b), std::max(a, b), j};
+                }
+
+            } else {
+                strips->GetCellAtId(j-numPolys, cell);
+
+                for (vtkIdType k = 0; k+2 < cell->GetNumberOfIds(); k++) {
+                    vtkIdType tri[] = {cell->GetId(k), cell->GetId(k+1), cell->GetId(k+2)};
+
+                    EdgeType *e = edges.data()+offsets[j]+3*k;
+
+                    if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) {
+                        // verbindende dreiecke ohne fläche haben keine kanten
+                        e[0] = e[1] = e[2] = EdgeType{tri[0], tri[0], j};
+                        continue;
+                    }
+
+                    for (int l = 0; l < 3; l++) {
+                        vtkIdType a = tri[l],
+                            b = tri[(l+1)%3];
+
+                        e[l] = EdgeType{std::min(a, b), std::max(a, b), j};
+                    }
+                }
+            }
+        }
+    });
+
+    // gleiche kanten liegen danach hintereinander, die polygone bleiben für eine eindeutige meldung aufsteigend
+    vtkSMPTools::Sort(edges.begin(), edges.end());
+
+    vtkIdType numNonManifold = 0, firstCount = 0;
+
+    EdgeType firstNonManifold{-1, -1, -1};
+
+    std::vector<EdgeType> boundary;
+
+    std::vector<EdgeType>::const_iterator itr = edges.begin(), next;
+
+    while (itr != edges.end()) {
+        next = itr;
+
+        while (next != edges.end() && (*next)[0] == (*itr)[0] && (*next)[1] == (*itr)[1]) {
+            next++;
+        }
+
+        vtkIdType count = next-itr;
+
+        if ((*itr)[0] == (*itr)[1]) {
+            // doppelte punkte in einem polygon sind hier keine kanten
+
+        } else if (count == 1) {
+            boundary.push_back(*itr);
+
+        } else if (count > 2) {
+            if (numNonManifold++ == 0) {
+                firstNonManifold = *itr;
+                firstCount = count;
+            }
+        }
+
+        itr = next;
+    }
+
+    std::ostringstream out;
+
+    if (numNonManifold > 0) {
+        out << numNonManifold << " non-manifold edge(s), the first is ("
+            << firstNonManifold[0] << ", " << firstNonManifold[1] << ") shared by "
+            << firstCount << " polygons starting with polygon " << firstNonManifold[2];
+
+        msg = out.str();
+
+        return false;
+    }
+
+    if (!boundary.empty()) {
+        // die randkanten werden zu schleifen vereint, jede hat dann genau einen wurzelpunkt
+
+        std::vector<vtkIdType> parents(pd->GetNumberOfPoints());
+        std::iota(parents.begin(), parents.end(), 0);
+
+        for (const EdgeType &edge : boundary) {
+            parents[Find(parents, edge[0])] = Find(parents, edge[1]);
+        }
+
+        vtkIdType numLoops = 0;
+
+        for (const EdgeType &edge : boundary) {
+            for (int i = 0; i < 2; i++) {
+                if (parents[edge[i]] == edge[i]) {
+                    // nur einmal zählen
+                    parents[edge[i]] = -1;
+                    numLoops++;
+                }
+            }
+        }
+
+        const EdgeType &firstBoundary = boundary.front();
+
+        double pt[3];
+        pd->GetPoint(firstBoundary[0], pt);
+
+        out << "not closed, " << numLoops << " open boundary loop(s) with " << boundary.size()
+            << " boundary edge(s), the first is (" << firstBoundary[0] << ", " << firstBoundary[1]
+            << ") of polygon " << firstBoundary[2]
+            << " at [" << pt[0] << ", " << pt[1] << ", " << pt[2] << "]";
+
+        msg = out.str();
+
+        return false;
+    }
+
+    return true;
+}
+
+typedef std::vector<std::pair<vtkOBBNode*, vtkOBBNode*>> NodePairsType;
+
+int CollectPairs (vtkOBBNode *nodeA, vtkOBBNode *nodeB, vtkMatrix4x4 *vtkNotUsed(mat), void *caller) {
+    // jedes paar kommt in beiden reihenfolgen
+    if (nodeA <= nodeB) {
+        static_cast<NodePairsType*>(caller)->emplace_back(nodeA, nodeB);
+    }
+
+    return 0;
+}
+
+bool InterTris (const double *pts, const vtkIdType *polyA, const vtkIdType *polyB, double *x) {
+    int shared = 0, sharedA = -1, sharedB = -1;
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            if (polyA[i] == polyB[j]) {
+                shared++;
+                sharedA = i;
+                sharedB = j;
+            }
+        }
+    }
+
+    TriType triA, triB;
+
+    for (int i = 0; i < 3; i++) {
+        std::copy_n(pts+3*polyA[i], 3, triA[i]);
+        std::copy_n(pts+3*polyB[i], 3, triB[i]);
+    }
+
+    if (shared == 0) {
+        double y[3];
+        return TriTriDistance(triA, triB, x, y) == 0;
+    }
+
+    if (shared == 1) {
+        // der gemeinsame punkt zählt nicht, also nur die jeweils gegenüberliegende kante
+
+        const double *pA = triA[(sharedA+1)%3], *qA = triA[(sharedA+2)%3],
+            *pB = triB[(sharedB+1)%3], *qB = triB[(sharedB+2)%3];
+
+        return InterSegTri(pA, qA, triB[0], triB[1], triB[2], x)
+            || InterSegTri(pB, qB, triA[0], triA[1], triA[2], x);
+    }
+
+    return false;
+}
+
+bool CheckSelfIntersections (vtkPolyData *pd, std::string &msg) {
+    vtkSmartPointer<vtkPolyData> tris = vtkSmartPointer<vtkPolyData>::New();
+    Triangulate(pd, tris);
+
+    if (tris->GetNumberOfCells() == 0) {
+        return true;
+    }
+
+    // die threads lesen nur aus diesen kopien
+
+    vtkIdType i, numPts = tris->GetNumberOfPoints(), numTris = tris->GetNumberOfPolys();
+
+    std::vector<double> pts(3*numPts);
+
+    for (i = 0; i < numPts; i++) {
+        tris->GetPoint(i, pts.data()+3*i);
+    }
+
+    std::vector<vtkIdType> polys(3*numTris);
+
+    vtkIdType num;
+    const vtkIdType *poly;
+
+    for (i = 0; i < numTris; i++) {
+        tris->GetPolys()->GetCellAtId(i, num, poly);
+        std::copy_n(poly, 3, polys.data()+3*i);
+    }
+
+    // der baum wird wie im vtkPolyDataContactFilter mit sich selbst geschnitten, die blätterpaare werden danach parallel geprüft
+
+    vtkSmartPointer<RefitOBBTree> obb = vtkSmartPointer<RefitOBBTree>::New();
+    obb->Build(tris);
+
+    vtkSmartPointer<vtkMatrix4x4> mat = vtkSmartPointer<vtkMatrix4x4>::New();
+
+    NodePairsType pairs;
+    obb->IntersectWithOBBTree(obb, mat, CollectPairs, &pairs);
+
+    typedef std::array<double, 3> PtType;
+
+    vtkIdType numPairs = static_cast<vtkIdType>(pairs.size());
+
+    std::vector<char> found(numPairs, 0);
+    std::vector<PtType> locs(numPairs);
+
+    vtkSMPTools::For(0, numPairs, [&](vtkIdType first, vtkIdType last) {
+        double x[3];
+
+        for (vtkIdType k = first; k < last; k++) {
+            vtkIdList *cellsA = pairs[k].first->Cells,
+                *cellsB = pairs[k].second->Cells;
+
+            if (cellsA == nullptr || cellsB == nullptr) {
+                continue;
+            }
+
+            bool same = pairs[k].first == pairs[k].second;
+
+            for (vtkIdType a = 0; a < cellsA->GetNumberOfIds() && !found[k]; a++) {
+                for (vtkIdType b = same ? a+1 : 0; b < cellsB->GetNumberOfIds(); b++) {
+                    if (InterTris(pts.data(), polys.data()+3*cellsA->GetId(a), polys.data()+3*cellsB->GetId(b), x)) {
+                        found[k] = 1;
+                        std::copy_n(x, 3, locs[k].data());
+
+                        break;
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<char>::const_iterator itr = std::find(found.begin(), found.end(), 1);
+
+    if (itr != found.end()) {
+        const PtType &x = locs[itr-found.begin()];
+
+        std::ostringstream out;
+        out << "self-intersecting, the first intersection is near ["
+            << x[0] << ", " << x[1] << ", " << x[2] << "]";
+
+        msg = out.str();
+
+        return false;
+    }
+
+    return true;
+}
+
+}
+
+bool ValidatePolyData (vtkPolyData *pd, std::string &msg) {
+    if (pd->GetNumberOfPolys() == 0 && pd->GetNumberOfStrips() == 0) {
+        msg = "no polygons";
+
+        return false;
+    }
+
+    return CheckEdges(pd, msg) && CheckSelfIntersections(pd, msg);
+}
@@ -0,0 +1,32 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __Validation_h
+#define __Validation_h
+
+#include <string>
+
+class vtkPolyData;
+
+// prüft vor dem schneiden, ob sich eine eingabe überhaupt für eine boolesche operation eignet
+//
+// jede kante muss zu genau zwei polygonen gehören, offene ränder werden zu schleifen zusammengefasst und gezählt;
+// selbstschnitte werden über einen obb-tree der dreiecke gesucht, wobei dreiecke mit einem gemeinsamen punkt nur
+// über ihre gegenüberliegenden kanten geprüft werden und benachbarte dreiecke gar nicht
+//
+// liefert false und in msg eine beschreibung des ersten gefundenen fehlers
+
+bool ValidatePolyData (vtkPolyData *pd, std::string &msg);
+
+#endif
@@ -515,9 +515,7 @@ void DouglasPeucker (const PolyType &poly, const CurvsType curvs, FeatureTagsTyp
 
 }
 
-void Simplify (const PolyType &poly, SavedPtsPtr &savedPts, SpecTagsPtr &specTags, PolyType &res, int skip, bool rev) {
-    PolyType poly2;
-
+SimplifyCache::SimplifyCache (const PolyType &_poly) : poly(_poly) {
     PolyType::const_iterator itr, itr2, itr3;
 
     for (itr = poly.begin(); itr != poly.end(); ++itr) {
@@ -530,6 +528,8 @@ void Simplify (const PolyType &poly, SavedPtsPtr &savedPts, SpecTagsPtr &specTag
         if (!IsNear(itr->pt, itr2->pt)) {
             poly2.push_back(*itr);
         }
+
+        inds.emplace(itr->tag, static_cast<int>(itr-poly.begin()));
     }
 
     std::vector<Curv> curvs;
@@ -590,21 +590,15 @@ void Simplify (const PolyType &poly, SavedPtsPtr &savedPts, SpecTagsPtr &specTag
     GetSect(a, b, polyA);
     GetSect(b, a, polyB);
 
-    FeatureTagsType tags;
-
     DouglasPeucker(polyA, _curvs, tags);
     DouglasPeucker(polyB, _curvs, tags);
 
-    tags.insert(skip);
-
     /*for (auto tag : tags) {
         std::cout << tag << std::endl;
     }*/
 
     // sucht nach bestimmten punkten außerhalb der tags
 
-    SpecTagsPtr _specTags(new SpecTagsType);
-
     std::set<Point> pts;
 
     for (auto &p : poly2) {
@@ -615,7 +609,88 @@ void Simplify (const PolyType &poly, SavedPtsPtr &savedPts, SpecTagsPtr &specTag
 
     for (auto &p : poly2) {
         if (tags.count(p.tag) == 0 && pts.count(p) == 1) {
-            _specTags->insert(p.tag);
+            specTags.insert(p.tag);
+        }
+    }
+
+    cw = TestCW(poly);
+}
+
+const VertsType4& SimplifyCache::GetSaved (int tagA, int tagB) {
+    auto itr = sects.find({tagA, tagB});
+
+    if (itr != sects.end()) {
+        return itr->second;
+    }
+
+    VertsType4 &verts = sects[{tagA, tagB}];
+
+    // der abschnitt von a bis b auf poly, ohne poly zu kopieren
+
+    int num = poly.size(),
+        i = inds.at(tagA),
+        j = i;
+
+    while (poly[j].tag != tagB) {
+        j = (j+1)%num;
+    }
+
+    if ((j-i+num)%num+1 > 2) {
+        const Point &a = poly[i],
+            &b = poly[j];
+
+        double n[] = {b.x-a.x, b.y-a.y},
+            l = Normalize(n);
+
+        double d = a.x*n[0]+a.y*n[1];
+
+        for (int k = (i+1)%num; k != j; k = (k+1)%num) {
+            const Point &_p = poly[k];
+
+            double t = _p.x*n[0]+_p.y*n[1]-d;
+
+            //assert(t/l > 0 && t/l < 1);
+
+            Vert4 v(_p, t/l);
+
+            v.pt[0] = a.x+t*n[0];
+            v.pt[1] = a.y+t*n[1];
+
+            verts.push_back(std::move(v));
+        }
+    }
+
+    return verts;
+}
+
+void Simplify (const PolyType &poly, SavedPtsPtr &savedPts, SpecTagsPtr &specTags, PolyType &res, int skip, bool rev) {
+    SimplifyCache cache(poly);
+    Simplify(cache, savedPts, specTags, res, skip, rev);
+}
+
+void Simplify (SimplifyCache &cache, SavedPtsPtr &savedPts, SpecTagsPtr &specTags, PolyType &res, int skip, bool rev) {
+    const PolyType &poly2 = cache.poly2;
+    const FeatureTagsType &tags = cache.tags;
+
+    PolyType::const_iterator itr, itr2;
+
+    // skip kommt zu den tags hinzu, punkte an gleicher stelle wie skip werden dadurch zu specTags
+
+    SpecTagsPtr _specTags(new SpecTagsType(cache.specTags));
+
+    itr = std::find_if(poly2.begin(), poly2.end(), [&skip](const Point &p) {
+        return p.tag == skip;
+    });
+
+    if (itr != poly2.end() && tags.count(skip) == 0) {
+        const Point &s = *itr;
+
+        _specTags->erase(skip);
+
+        for (auto &p : poly2) {
+            if (p.tag != skip && tags.count(p.tag) == 0 && !(p < s) && !(s < p)) {
+                _specTags->insert(p.tag);
+            }
         }
     }
 
@@ -623,8 +698,8 @@ void Simplify (const PolyType &poly, SavedPtsPtr &savedPts, SpecTagsPtr &specTag
         specTags.swap(_specTags);
     }
 
-    std::copy_if(poly2.begin(), poly2.end(), std::back_inserter(res), [&tags, &specTags](const Point &p) {
-        return tags.count(p.tag) == 1 || (specTags && specTags->count(p.tag) == 1);
+    std::copy_if(poly2.begin(), poly2.end(), std::back_inserter(res), [&tags, &specTags, &skip](const Point &p) {
+        return tags.count(p.tag) == 1 || p.tag == skip || (specTags && specTags->count(p.tag) == 1);
     });
 
     /*for (auto &r : res) {
@@ -633,11 +708,9 @@ void Simplify (const PolyType &poly, SavedPtsPtr &savedPts, SpecTagsPtr &specTag
 
     vtkbool_throw(res.size() > 2, "Simplify", "too few points left");
 
-    // sichert die gelöschten punkte
+    // sichert die gelöschten punkte, die abschnitte werden zwischen den aufrufen geteilt
 
     if (savedPts) {
-        std::vector<PolyType> sects;
-
         for (itr = res.begin(); itr != res.end(); ++itr) {
             itr2 = itr+1;
 
@@ -645,49 +718,22 @@ void Simplify (const PolyType &poly, SavedPtsPtr &savedPts, SpecTagsPtr &specTag
                 itr2 = res.begin();
             }
 
-            PolyType sect(poly); // kopiert
-            GetSect(itr->tag, itr2->tag, sect);
-
-            sects.push_back(std::move(sect));
-        }
-
-        for (auto &sect : sects) {
-            if (sect.size() > 2) {
-                const Point &a = *sect.begin(),
-                    &b = *sect.rbegin();
-
-                double n[] = {b.x-a.x, b.y-a.y},
-                    l = Normalize(n);
+            const VertsType4 &saved = cache.GetSaved(itr->tag, itr2->tag);
 
-                double d = a.x*n[0]+a.y*n[1];
-
-                VertsType4 verts;
-
-                for (itr = sect.begin()+1; itr != sect.end()-1; ++itr) {
-                    const Point &_p = *itr;
-
-                    double t = _p.x*n[0]+_p.y*n[1]-d;
-
-                    //assert(t/l > 0 && t/l < 1);
-
-                    Vert4 v(_p, t/l);
-
-                    v.pt[0] = a.x+t*n[0];
-                    v.pt[1] = a.y+t*n[1];
+            if (saved.empty()) {
+                continue;
+            }
 
-                    if (rev) {
-                        v.t = 1-v.t;
-                    }
+            if (rev) {
+                VertsType4 verts(saved.rbegin(), saved.rend());
 
-                    verts.push_back(std::move(v));
+                for (auto &v : verts) {
+                    v.t = 1-v.t;
                 }
 
-                if (rev) {
-                    std::reverse(verts.begin(), verts.end());
-                    (*savedPts)[{b.tag, a.tag}] = verts;
-                } else {
-                    (*savedPts)[{a.tag, b.tag}] = verts;
-                }
+                (*savedPts)[{itr2->tag, itr->tag}] = verts;
+            } else {
+                (*savedPts)[{itr->tag, itr2->tag}] = saved;
             }
         }
     }
@@ -867,7 +913,15 @@ void GetVisPoly_wrapper (PolyType &poly, PolyType &res, int ind) {
         p.id = i++;
     }
 
-    vtkbool_throw(TestCW(poly), "GetVisPoly_wrapper", "poly not clockwise");
+    SimplifyCache cache(poly);
+
+    GetVisPoly_wrapper(cache, res, ind);
+}
+
+void GetVisPoly_wrapper (SimplifyCache &cache, PolyType &res, int ind) {
+    const PolyType &poly = cache.poly;
+
+    vtkbool_throw(cache.cw, "GetVisPoly_wrapper", "poly not clockwise");
 
     /*std::cout << "?" << std::endl
         << "?X " << ind << std::endl
@@ -881,7 +935,7 @@ void GetVisPoly_wrapper (PolyType &poly, PolyType &res, int ind) {
 
     SpecTagsPtr specTags(new SpecTagsType);
 
-    Simplify(poly, savedPts, specTags, poly2, x.tag, true);
+    Simplify(cache, savedPts, specTags, poly2, x.tag, true);
 
     // Align(poly2, x);
 
@@ -161,7 +161,26 @@ typedef std::shared_ptr<SavedPtsType> SavedPtsPtr;
 typedef std::set<int> SpecTagsType;
 typedef std::shared_ptr<SpecTagsType> SpecTagsPtr;
 
+// der vom eckpunkt unabhängige teil von Simplify, wird von allen abfragen zum selben polygon geteilt
+class SimplifyCache {
+    std::map<int, int> inds;
+    std::map<Pair, VertsType4> sects;
+
+public:
+    SimplifyCache (const PolyType &_poly);
+
+    const PolyType &poly;
+    PolyType poly2;
+    FeatureTagsType tags;
+    SpecTagsType specTags;
+    bool cw;
+
+    // gelöschte punkte zwischen a und b, in der richtung von poly
+    const VertsType4& GetSaved (int tagA, int tagB);
+};
+
 void Simplify (const PolyType &poly, SavedPtsPtr &savedPts, SpecTagsPtr &specTags, PolyType &res, int skip, bool rev);
+void Simplify (SimplifyCache &cache, SavedPtsPtr &savedPts, SpecTagsPtr &specTags, PolyType &res, int skip, bool rev);
 
 // void Align (PolyType &poly, const Point &p);
 
@@ -174,6 +193,7 @@ void SimpleRestore (const PolyType &poly, const SavedPtsType &savedPts, PolyType
 void GetVisPoly (PolyType &poly, Tracker &tr, PolyType &res, int ind = 0);
 
 void GetVisPoly_wrapper (PolyType &poly, PolyType &res, int ind);
+void GetVisPoly_wrapper (SimplifyCache &cache, PolyType &res, int ind);
 
 #endif
 
@@ -0,0 +1,50 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+
+#include <vtkObjectFactory.h>
+
+#include "vtkBooleanExecutionPolicy.h"
+
+vtkStandardNewMacro(vtkBooleanExecutionPolicy);
+
+vtkBooleanExecutionPolicy::vtkBooleanExecutionPolicy () {
+
+    NumberOfThreads = 0;
+    Backend = nullptr;
+
+    Deterministic = true;
+
+    PolygonGrain = 0;
+    PairGrain = 0;
+
+    MemoryBudget = 0;
+
+}
+
+vtkBooleanExecutionPolicy::~vtkBooleanExecutionPolicy () {
+    SetBackend(nullptr);
+}
+
+vtkIdType vtkBooleanExecutionPolicy::GetBatchSize (std::size_t size, vtkIdType num) {
+    if (MemoryBudget <= 0 || size == 0) {
+        return num;
+    }
+
+    double max = MemoryBudget*1024*1024/size;
+
+    // mindestens eins, damit es überhaupt vorangeht
+    return std::max<vtkIdType>(1, static_cast<vtkIdType>(std::min<double>(max, num)));
+}
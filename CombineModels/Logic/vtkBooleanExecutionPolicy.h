@@ -0,0 +1,105 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __vtkBooleanExecutionPolicy_h
+#define __vtkBooleanExecutionPolicy_h
+
+#include "vtkSlicerCombineModelsModuleLogicExport.h"
+
+#include <vtkObject.h>
+
+#ifndef __VTK_WRAP__
+#include <vtkSMPTools.h>
+#endif // __VTK_WRAP__
+
+// steuert die parallelen schritte des vtkPolyDataBooleanFilter und des vtkPolyDataContactFilter
+//
+// anzahl der threads und backend gelten nur während eines durchlaufs des filters (über vtkSMPTools::LocalScope),
+// mehrere jobs in einem prozess können sich also verschieden beschränken; eine policy kann an mehrere filter gehen
+
+class VTK_SLICER_COMBINEMODELS_MODULE_LOGIC_EXPORT vtkBooleanExecutionPolicy : public vtkObject {
+    int NumberOfThreads;
+    char *Backend;
+
+    bool Deterministic;
+
+    vtkIdType PolygonGrain, PairGrain;
+
+    double MemoryBudget;
+
+public:
+    vtkTypeMacro(vtkBooleanExecutionPolicy, vtkObject);
+    static vtkBooleanExecutionPolicy* New ();
+
+    // 0 lässt vtkSMPTools entscheiden
+    vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+    vtkGetMacro(NumberOfThreads, int);
+
+    // Sequential, STDThread, TBB oder OpenMP, sofern in VTK vorhanden; nullptr behält das aktuelle
+    vtkSetStringMacro(Backend);
+    vtkGetStringMacro(Backend);
+
+    // die ergebnisse sind unabhängig von der anzahl der threads und gleichen denen eines seriellen durchlaufs,
+    // ohne werden die teilergebnisse thread für thread übernommen, was das sammeln spart
+    vtkSetMacro(Deterministic, bool);
+    vtkGetMacro(Deterministic, bool);
+    vtkBooleanMacro(Deterministic, bool);
+
+    // körnung der schleifen über polygone bzw. zellpaare, 0 lässt vtkSMPTools entscheiden
+    vtkSetClampMacro(PolygonGrain, vtkIdType, 0, VTK_ID_MAX);
+    vtkGetMacro(PolygonGrain, vtkIdType);
+
+    vtkSetClampMacro(PairGrain, vtkIdType, 0, VTK_ID_MAX);
+    vtkGetMacro(PairGrain, vtkIdType);
+
+    // obergrenze für die zwischenpuffer der parallelen schritte in MB, darüber wird in mehreren runden gearbeitet;
+    // 0 heißt ohne grenze
+    vtkSetClampMacro(MemoryBudget, double, 0, VTK_DOUBLE_MAX);
+    vtkGetMacro(MemoryBudget, double);
+
+#ifndef __VTK_WRAP__
+    // führt f mit den threads und dem backend der policy aus
+    template <typename Func>
+    void Execute (Func &&f) {
+        vtkSMPTools::Config config(NumberOfThreads, Backend != nullptr ? Backend : vtkSMPTools::GetBackend(), false);
+        vtkSMPTools::LocalScope(config, f);
+    }
+
+    // wie vtkSMPTools::For, mit der körnung grain, sofern sie nicht 0 ist
+    template <typename Func>
+    static void For (vtkIdType first, vtkIdType last, vtkIdType grain, Func &&f) {
+        if (grain > 0) {
+            vtkSMPTools::For(first, last, grain, f);
+        } else {
+            vtkSMPTools::For(first, last, f);
+        }
+    }
+
+    // anzahl der elemente der größe size, die in das budget passen, bzw. num ohne budget
+    vtkIdType GetBatchSize (std::size_t size, vtkIdType num);
+#endif // __VTK_WRAP__
+
+protected:
+    vtkBooleanExecutionPolicy ();
+    ~vtkBooleanExecutionPolicy ();
+
+    void PrintSelf (ostream&, vtkIndent) override {};
+
+private:
+    vtkBooleanExecutionPolicy (const vtkBooleanExecutionPolicy&) = delete;
+    void operator= (const vtkBooleanExecutionPolicy&) = delete;
+
+};
+
+#endif
@@ -0,0 +1,306 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cmath>
+#include <algorithm>
+
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkPoints.h>
+#include <vtkImageData.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkPointData.h>
+#include <vtkFlyingEdges3D.h>
+#include <vtkSmartPointer.h>
+#include <vtkSMPTools.h>
+
+#include "vtkBooleanPreviewFilter.h"
+
+namespace {
+
+// kantenfunktion mit kanonischer reihenfolge der endpunkte, damit benachbarte dreiecke
+// auf der gemeinsamen kante exakt entgegengesetzte werte erhalten
+double Edge (const double *a, const double *b, const double *p) {
+    bool swap = a[0] > b[0] || (a[0] == b[0] && a[1] > b[1]);
+
+    const double *u = swap ? b : a,
+        *v = swap ? a : b;
+
+    double e = (v[0]-u[0])*(p[1]-u[1])-(v[1]-u[1])*(p[0]-u[0]);
+
+    return swap ? -e : e;
+}
+
+// top-left-regel: bei e == 0 gehört die kante nur zu einer der beiden seiten
+bool Owns (const double *a, const double *b) {
+    return a[1] < b[1] || (a[1] == b[1] && a[0] > b[0]);
+}
+
+class Tri {
+public:
+    double yz[3][2];
+    double x[3];
+};
+
+}
+
+vtkStandardNewMacro(vtkBooleanPreviewFilter);
+
+vtkBooleanPreviewFilter::vtkBooleanPreviewFilter () {
+
+    SetNumberOfInputPorts(2);
+    SetNumberOfOutputPorts(1);
+
+    OperMode = OPER_UNION;
+    Resolution = 128;
+
+}
+
+void vtkBooleanPreviewFilter::Rasterize (vtkPolyData *pd, std::uint8_t bit, std::vector<std::uint8_t> &mask, const double *origin, double spacing, const int *dims) {
+
+    // dreiecke aufstellen, polygone als fächer, was für die paritätsregel genügt
+
+    std::vector<Tri> tris;
+
+    vtkPoints *pts = pd->GetPoints();
+    vtkCellArray *polys = pd->GetPolys();
+
+    if (pts == nullptr) {
+        return;
+    }
+
+    vtkIdType n, i;
+    const vtkIdType *poly;
+
+    double a[3], b[3], c[3];
+
+    for (polys->InitTraversal(); polys->GetNextCell(n, poly);) {
+        pts->GetPoint(poly[0], a);
+
+        for (i = 1; i+1 < n; i++) {
+            pts->GetPoint(poly[i], b);
+            pts->GetPoint(poly[i+1], c);
+
+            Tri tri;
+
+            const double *abc[] = {a, b, c};
+
+            for (int j = 0; j < 3; j++) {
+                tri.yz[j][0] = abc[j][1];
+                tri.yz[j][1] = abc[j][2];
+                tri.x[j] = abc[j][0];
+            }
+
+            tris.push_back(tri);
+        }
+    }
+
+    // dreiecke den z-schichten zuordnen
+
+    std::vector<std::vector<int>> slices(dims[2]);
+
+    for (std::size_t t = 0; t < tris.size(); t++) {
+        const Tri &tri = tris[t];
+
+        double zMin = std::min({tri.yz[0][1], tri.yz[1][1], tri.yz[2][1]}),
+            zMax = std::max({tri.yz[0][1], tri.yz[1][1], tri.yz[2][1]});
+
+        int kMin = std::max(0, static_cast<int>(std::ceil((zMin-origin[2])/spacing))),
+            kMax = std::min(dims[2]-1, static_cast<int>(std::floor((zMax-origin[2])/spacing)));
+
+        for (int k = kMin; k <= kMax; k++) {
+            slices[k].push_back(static_cast<int>(t));
+        }
+    }
+
+    const std::size_t sliceSize = static_cast<std::size_t>(dims[0])*dims[1];
+
+    vtkSMPTools::For(0, dims[2], [&](vtkIdType first, vtkIdType last) {
+        std::vector<std::vector<double>> rows(dims[1]);
+
+        double p[2];
+
+        for (vtkIdType k = first; k < last; k++) {
+            for (auto &row : rows) {
+                row.clear();
+            }
+
+            p[1] = origin[2]+k*spacing;
+
+            for (int t : slices[k]) {
+                Tri tri = tris[t];
+
+                // gegen den uhrzeigersinn ausrichten
+                double area = Edge(tri.yz[0], tri.yz[1], tri.yz[2]);
+
+                if (area == 0) {
+                    continue;
+                } else if (area < 0) {
+                    std::swap(tri.yz[1][0], tri.yz[2][0]);
+                    std::swap(tri.yz[1][1], tri.yz[2][1]);
+                    std::swap(tri.x[1], tri.x[2]);
+                    area = -area;
+                }
+
+                double yMin = std::min({tri.yz[0][0], tri.yz[1][0], tri.yz[2][0]}),
+                    yMax = std::max({tri.yz[0][0], tri.yz[1][0], tri.yz[2][0]});
+
+                int jMin = std::max(0, static_cast<int>(std::ceil((yMin-origin[1])/spacing))),
+                    jMax = std::min(dims[1]-1, static_cast<int>(std::floor((yMax-origin[1])/spacing)));
+
+                for (int j = jMin; j <= jMax; j++) {
+                    p[0] = origin[1]+j*spacing;
+
+                    double w[3];
+                    bool inside = true;
+
+                    for (int e = 0; e < 3 && inside; e++) {
+                        const double *u = tri.yz[(e+1)%3],
+                            *v = tri.yz[(e+2)%3];
+
+                        w[e] = Edge(u, v, p);
+
+                        inside = w[e] > 0 || (w[e] == 0 && Owns(u, v));
+                    }
+
+                    if (inside) {
+                        rows[j].push_back((w[0]*tri.x[0]+w[1]*tri.x[1]+w[2]*tri.x[2])/area);
+                    }
+                }
+            }
+
+            std::uint8_t *slice = mask.data()+k*sliceSize;
+
+            for (int j = 0; j < dims[1]; j++) {
+                std::vector<double> &row = rows[j];
+
+                std::sort(row.begin(), row.end());
+
+                for (std::size_t r = 0; r+1 < row.size(); r += 2) {
+                    int iA = std::max(0, static_cast<int>(std::ceil((row[r]-origin[0])/spacing))),
+                        iB = std::min(dims[0], static_cast<int>(std::ceil((row[r+1]-origin[0])/spacing)));
+
+                    for (int x = iA; x < iB; x++) {
+                        slice[j*dims[0]+x] |= bit;
+                    }
+                }
+            }
+        }
+    });
+
+}
+
+int vtkBooleanPreviewFilter::RequestData (vtkInformation *vtkNotUsed(request), vtkInformationVector **inputVector, vtkInformationVector *outputVector) {
+
+    vtkInformation *inInfoA = inputVector[0]->GetInformationObject(0);
+    vtkInformation *inInfoB = inputVector[1]->GetInformationObject(0);
+
+    vtkPolyData *pdA = vtkPolyData::SafeDownCast(inInfoA->Get(vtkDataObject::DATA_OBJECT()));
+    vtkPolyData *pdB = vtkPolyData::SafeDownCast(inInfoB->Get(vtkDataObject::DATA_OBJECT()));
+
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData *output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    if (pdA->GetNumberOfPolys() == 0 || pdB->GetNumberOfPolys() == 0) {
+        vtkErrorMacro("One of the inputs does not contain any polygons.");
+        return 1;
+    }
+
+    // gemeinsames gitter über beide eingaben, mit rand, damit die oberfläche geschlossen bleibt
+
+    double bndsA[6], bndsB[6], bnds[6];
+
+    pdA->GetBounds(bndsA);
+    pdB->GetBounds(bndsB);
+
+    double ext = 0;
+
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        bnds[2*i] = std::min(bndsA[2*i], bndsB[2*i]);
+        bnds[2*i+1] = std::max(bndsA[2*i+1], bndsB[2*i+1]);
+
+        ext = std::max(ext, bnds[2*i+1]-bnds[2*i]);
+    }
+
+    if (ext <= 0) {
+        vtkErrorMacro("Inputs have no extent.");
+        return 1;
+    }
+
+    double spacing = ext/Resolution,
+        origin[3];
+
+    int dims[3];
+
+    for (i = 0; i < 3; i++) {
+        origin[i] = bnds[2*i]-1.5*spacing;
+        dims[i] = static_cast<int>(std::ceil((bnds[2*i+1]-bnds[2*i])/spacing))+4;
+    }
+
+    std::vector<std::uint8_t> mask(static_cast<std::size_t>(dims[0])*dims[1]*dims[2], 0);
+
+    Rasterize(pdA, 1, mask, origin, spacing, dims);
+    Rasterize(pdB, 2, mask, origin, spacing, dims);
+
+    // bitweise verknüpfung
+
+    std::uint8_t want = 3, care = 3;
+
+    if (OperMode == OPER_UNION) {
+        care = 0;
+    } else if (OperMode == OPER_DIFFERENCE) {
+        want = 1;
+    } else if (OperMode == OPER_DIFFERENCE2) {
+        want = 2;
+    }
+
+    vtkSmartPointer<vtkUnsignedCharArray> scalars = vtkSmartPointer<vtkUnsignedCharArray>::New();
+    scalars->SetName("Mask");
+    scalars->SetNumberOfValues(static_cast<vtkIdType>(mask.size()));
+
+    unsigned char *s = scalars->GetPointer(0);
+
+    vtkSMPTools::For(0, static_cast<vtkIdType>(mask.size()), [&](vtkIdType first, vtkIdType last) {
+        for (vtkIdType v = first; v < last; v++) {
+            // bei der vereinigung genügt ein gesetztes bit
+            s[v] = (care == 0 ? mask[v] != 0 : (mask[v] & care) == want) ? 255 : 0;
+        }
+    });
+
+    std::vector<std::uint8_t>().swap(mask);
+
+    vtkSmartPointer<vtkImageData> img = vtkSmartPointer<vtkImageData>::New();
+    img->SetDimensions(dims);
+    img->SetOrigin(origin);
+    img->SetSpacing(spacing, spacing, spacing);
+    img->GetPointData()->SetScalars(scalars);
+
+    vtkSmartPointer<vtkFlyingEdges3D> fe = vtkSmartPointer<vtkFlyingEdges3D>::New();
+    fe->SetInputData(img);
+    fe->SetValue(0, 127.5);
+    fe->ComputeNormalsOn();
+    fe->ComputeGradientsOff();
+    fe->ComputeScalarsOff();
+    fe->Update();
+
+    output->ShallowCopy(fe->GetOutput());
+
+    return 1;
+
+}
@@ -0,0 +1,68 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __vtkBooleanPreviewFilter_h
+#define __vtkBooleanPreviewFilter_h
+
+#include "vtkSlicerCombineModelsModuleLogicExport.h"
+
+#include <vector>
+#include <cstdint>
+
+#include <vtkPolyDataAlgorithm.h>
+
+#include "vtkPolyDataBooleanFilter.h"
+
+// angenäherte boolesche operation über ein gemeinsames voxelgitter
+//
+// beide geschlossenen oberflächen werden zeilenweise nach der paritätsregel in eine bitmaske gerastert
+// (bit 0 für A, bit 1 für B), bitweise verknüpft und mit vtkFlyingEdges3D wieder in eine oberfläche überführt
+
+class VTK_SLICER_COMBINEMODELS_MODULE_LOGIC_EXPORT vtkBooleanPreviewFilter : public vtkPolyDataAlgorithm {
+    int OperMode;
+    int Resolution;
+
+    void Rasterize (vtkPolyData *pd, std::uint8_t bit, std::vector<std::uint8_t> &mask, const double *origin, double spacing, const int *dims);
+
+public:
+    vtkTypeMacro(vtkBooleanPreviewFilter, vtkPolyDataAlgorithm);
+    static vtkBooleanPreviewFilter* New ();
+
+    vtkSetClampMacro(OperMode, int, OPER_UNION, OPER_DIFFERENCE2);
+    vtkGetMacro(OperMode, int);
+
+    void SetOperModeToUnion () { SetOperMode(OPER_UNION); }
+    void SetOperModeToIntersection () { SetOperMode(OPER_INTERSECTION); }
+    void SetOperModeToDifference () { SetOperMode(OPER_DIFFERENCE); }
+    void SetOperModeToDifference2 () { SetOperMode(OPER_DIFFERENCE2); }
+
+    // anzahl der voxel entlang der längsten achse
+    vtkSetClampMacro(Resolution, int, 8, 2048);
+    vtkGetMacro(Resolution, int);
+
+protected:
+    vtkBooleanPreviewFilter ();
+    ~vtkBooleanPreviewFilter () {}
+
+    int RequestData (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector) override;
+
+    void PrintSelf (ostream&, vtkIndent) override {};
+
+private:
+    vtkBooleanPreviewFilter (const vtkBooleanPreviewFilter&) = delete;
+    void operator= (const vtkBooleanPreviewFilter&) = delete;
+
+};
+
+#endif
@@ -0,0 +1,288 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cmath>
+#include <algorithm>
+
+#include <vtkObjectFactory.h>
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkMath.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBooleanPrimitive.h"
+
+vtkStandardNewMacro(vtkBooleanPrimitive);
+
+vtkBooleanPrimitive::vtkBooleanPrimitive () {
+
+    Type = PRIM_SPHERE;
+
+    Center[0] = 0; Center[1] = 0; Center[2] = 0;
+    Axis[0] = 0; Axis[1] = 0; Axis[2] = 1;
+    Lengths[0] = 1; Lengths[1] = 1; Lengths[2] = 1;
+
+    Radius = .5;
+    Height = 1;
+
+    Resolution = 48;
+
+}
+
+void vtkBooleanPrimitive::GetFrame (double *e1, double *e2, double *e3) {
+    e3[0] = Axis[0];
+    e3[1] = Axis[1];
+    e3[2] = Axis[2];
+
+    if (vtkMath::Normalize(e3) < 1e-12) {
+        e3[0] = 0; e3[1] = 0; e3[2] = 1;
+    }
+
+    // e3 x e1 = e2, also rechtshändig
+    vtkMath::Perpendiculars(e3, e1, e2, 0);
+}
+
+double vtkBooleanPrimitive::SignedDistance (const double pt[3]) {
+    double e1[3], e2[3], e3[3], v[3];
+
+    GetFrame(e1, e2, e3);
+
+    vtkMath::Subtract(pt, Center, v);
+
+    // abstand zu einem achsenparallelen quader bzw. zylinder mit den halben ausdehnungen q
+    auto Dist = [](const double *q, int n) {
+        double out = 0, in = -VTK_DOUBLE_MAX;
+
+        for (int i = 0; i < n; i++) {
+            out += std::max(q[i], 0.)*std::max(q[i], 0.);
+            in = std::max(in, q[i]);
+        }
+
+        return std::sqrt(out)+std::min(in, 0.);
+    };
+
+    if (Type == PRIM_PLANE) {
+        return vtkMath::Dot(v, e3);
+
+    } else if (Type == PRIM_SPHERE) {
+        return vtkMath::Norm(v)-Radius;
+
+    } else if (Type == PRIM_BOX) {
+        double q[] = {
+            std::abs(vtkMath::Dot(v, e1))-Lengths[0]/2,
+            std::abs(vtkMath::Dot(v, e2))-Lengths[1]/2,
+            std::abs(vtkMath::Dot(v, e3))-Lengths[2]/2
+        };
+
+        return Dist(q, 3);
+
+    }
+
+    double a = vtkMath::Dot(v, e3),
+        r = std::sqrt(std::max(vtkMath::Dot(v, v)-a*a, 0.));
+
+    double q[] = {r-Radius, std::abs(a)-Height/2};
+
+    return Dist(q, 2);
+}
+
+double vtkBooleanPrimitive::GetTolerance () {
+    if (Type == PRIM_SPHERE || Type == PRIM_CYLINDER) {
+        // stichhöhe eines segments, bei der kugel auch quer dazu
+        double phi = 2*vtkMath::Pi()/Resolution;
+        return Radius*(1-std::cos(phi/2)*(Type == PRIM_SPHERE ? std::cos(phi/2) : 1));
+    }
+
+    return 0;
+}
+
+void vtkBooleanPrimitive::AddBox (vtkPolyData *pd, const double *c, const double *e1, const double *e2, const double *e3, const double *half) {
+    vtkPoints *pts = pd->GetPoints();
+    vtkCellArray *polys = pd->GetPolys();
+
+    vtkIdType first = pts->GetNumberOfPoints();
+
+    double pt[3];
+
+    int i, j;
+
+    // index = x+2*y+4*z, jeweils 1 für die positive seite
+    for (i = 0; i < 8; i++) {
+        double s[] = {i & 1 ? 1. : -1., i & 2 ? 1. : -1., i & 4 ? 1. : -1.};
+
+        for (j = 0; j < 3; j++) {
+            pt[j] = c[j]+s[0]*half[0]*e1[j]+s[1]*half[1]*e2[j]+s[2]*half[2]*e3[j];
+        }
+
+        pts->InsertNextPoint(pt);
+    }
+
+    // gegen den uhrzeigersinn von außen gesehen
+    const vtkIdType faces[6][4] = {
+        {4, 5, 7, 6},
+        {0, 2, 3, 1},
+        {1, 3, 7, 5},
+        {0, 4, 6, 2},
+        {2, 6, 7, 3},
+        {0, 1, 5, 4}
+    };
+
+    vtkIdType face[4];
+
+    for (i = 0; i < 6; i++) {
+        for (j = 0; j < 4; j++) {
+            face[j] = first+faces[i][j];
+        }
+
+        polys->InsertNextCell(4, face);
+    }
+}
+
+void vtkBooleanPrimitive::GetPolyData (const double bounds[6], vtkPolyData *pd) {
+    pd->Initialize();
+
+    vtkSmartPointer<vtkPoints> pts = vtkSmartPointer<vtkPoints>::New();
+    pts->SetDataTypeToDouble();
+
+    vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
+
+    pd->SetPoints(pts);
+    pd->SetPolys(polys);
+
+    double e1[3], e2[3], e3[3];
+
+    GetFrame(e1, e2, e3);
+
+    int i, j, k;
+
+    if (Type == PRIM_PLANE) {
+        // quader, dessen oberseite in der ebene liegt und der A in alle richtungen überragt
+
+        double c[3], d[3], diag = 0;
+
+        for (i = 0; i < 3; i++) {
+            c[i] = (bounds[2*i]+bounds[2*i+1])/2;
+            diag += (bounds[2*i+1]-bounds[2*i])*(bounds[2*i+1]-bounds[2*i]);
+        }
+
+        double l = std::max(std::sqrt(diag), 1.);
+
+        vtkMath::Subtract(c, Center, d);
+
+        double h = vtkMath::Dot(d, e3);
+
+        for (i = 0; i < 3; i++) {
+            c[i] -= (h+l)*e3[i];
+        }
+
+        double half[] = {l, l, l};
+
+        AddBox(pd, c, e1, e2, e3, half);
+
+    } else if (Type == PRIM_BOX) {
+        double half[] = {Lengths[0]/2, Lengths[1]/2, Lengths[2]/2};
+
+        AddBox(pd, Center, e1, e2, e3, half);
+
+    } else if (Type == PRIM_CYLINDER) {
+        int n = Resolution;
+
+        double pt[3], a;
+
+        for (k = 0; k < 2; k++) {
+            double z = k == 0 ? -Height/2 : Height/2;
+
+            for (i = 0; i < n; i++) {
+                a = 2*vtkMath::Pi()*i/n;
+
+                for (j = 0; j < 3; j++) {
+                    pt[j] = Center[j]+Radius*(std::cos(a)*e1[j]+std::sin(a)*e2[j])+z*e3[j];
+                }
+
+                pts->InsertNextPoint(pt);
+            }
+        }
+
+        // mantel
+        for (i = 0; i < n; i++) {
+            vtkIdType quad[] = {i, (i+1)%n, n+(i+1)%n, n+i};
+            polys->InsertNextCell(4, quad);
+        }
+
+        // deckel als jeweils ein polygon
+        polys->InsertNextCell(n);
+        for (i = n-1; i >= 0; i--) {
+            polys->InsertCellPoint(i);
+        }
+
+        polys->InsertNextCell(n);
+        for (i = 0; i < n; i++) {
+            polys->InsertCellPoint(n+i);
+        }
+
+    } else {
+        int n = Resolution,
+            m = std::max(2, n/2);
+
+        double pt[3], theta, phi;
+
+        for (j = 0; j < 3; j++) {
+            pt[j] = Center[j]+Radius*e3[j];
+        }
+
+        vtkIdType north = pts->InsertNextPoint(pt);
+
+        for (k = 1; k < m; k++) {
+            theta = vtkMath::Pi()*k/m;
+
+            for (i = 0; i < n; i++) {
+                phi = 2*vtkMath::Pi()*i/n;
+
+                for (j = 0; j < 3; j++) {
+                    pt[j] = Center[j]+Radius*(std::sin(theta)*(std::cos(phi)*e1[j]+std::sin(phi)*e2[j])+std::cos(theta)*e3[j]);
+                }
+
+                pts->InsertNextPoint(pt);
+            }
+        }
+
+        for (j = 0; j < 3; j++) {
+            pt[j] = Center[j]-Radius*e3[j];
+        }
+
+        vtkIdType south = pts->InsertNextPoint(pt);
+
+        auto Ind = [&](int ring, int seg) -> vtkIdType {
+            return 1+(ring-1)*n+seg%n;
+        };
+
+        for (i = 0; i < n; i++) {
+            vtkIdType tri[] = {north, Ind(1, i), Ind(1, i+1)};
+            polys->InsertNextCell(3, tri);
+        }
+
+        for (k = 1; k < m-1; k++) {
+            for (i = 0; i < n; i++) {
+                vtkIdType quad[] = {Ind(k, i), Ind(k+1, i), Ind(k+1, i+1), Ind(k, i+1)};
+                polys->InsertNextCell(4, quad);
+            }
+        }
+
+        for (i = 0; i < n; i++) {
+            vtkIdType tri[] = {south, Ind(m-1, i+1), Ind(m-1, i)};
+            polys->InsertNextCell(3, tri);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __vtkBooleanPrimitive_h
+#define __vtkBooleanPrimitive_h
+
+#include "vtkSlicerCombineModelsModuleLogicExport.h"
+
+#include <vtkObject.h>
+
+class vtkPolyData;
+
+#define PRIM_PLANE 0
+#define PRIM_BOX 1
+#define PRIM_SPHERE 2
+#define PRIM_CYLINDER 3
+
+// vernetztes primitiv als operand B für den vtkPolyDataBooleanFilter, mit analytischem aussortieren
+//
+// geschnitten wird gegen die vernetzung aus wenigen, gut geformten polygonen (vierecke, die deckel als ein polygon),
+// die schnittpunkte liegen also auf ihr und nicht auf der exakten oberfläche; exakt ist nur der abstand, mit dem der
+// vtkPolyDataContactFilter die zellen aus A aussortiert, die der vernetzung nicht nahe kommen können
+//
+// über die vernetzung wird wie bei jedem anderen B ein obb-tree angelegt, er umfasst aber nur wenige polygone; die
+// deckel von zylinder und quader sind ebenso vernetzt, ein kreis z.b. als n-eck mit Resolution ecken
+//
+// eine ebene ist der halbraum entgegen der normalen, sie wird als quader vernetzt, der A seitlich überragt
+
+class VTK_SLICER_COMBINEMODELS_MODULE_LOGIC_EXPORT vtkBooleanPrimitive : public vtkObject {
+    int Type;
+    double Center[3], Axis[3], Lengths[3];
+    double Radius, Height;
+    int Resolution;
+
+    void GetFrame (double *e1, double *e2, double *e3);
+    void AddBox (vtkPolyData *pd, const double *c, const double *e1, const double *e2, const double *e3, const double *half);
+
+public:
+    vtkTypeMacro(vtkBooleanPrimitive, vtkObject);
+    static vtkBooleanPrimitive* New ();
+
+    vtkSetClampMacro(Type, int, PRIM_PLANE, PRIM_CYLINDER);
+    vtkGetMacro(Type, int);
+
+    void SetTypeToPlane () { SetType(PRIM_PLANE); }
+    void SetTypeToBox () { SetType(PRIM_BOX); }
+    void SetTypeToSphere () { SetType(PRIM_SPHERE); }
+    void SetTypeToCylinder () { SetType(PRIM_CYLINDER); }
+
+    // punkt auf der ebene bzw. mittelpunkt
+    vtkSetVector3Macro(Center, double);
+    vtkGetVector3Macro(Center, double);
+
+    // normale der ebene, achse des zylinders, dritte achse des quaders
+    vtkSetVector3Macro(Axis, double);
+    vtkGetVector3Macro(Axis, double);
+
+    // kantenlängen des quaders
+    vtkSetVector3Macro(Lengths, double);
+    vtkGetVector3Macro(Lengths, double);
+
+    vtkSetMacro(Radius, double);
+    vtkGetMacro(Radius, double);
+
+    vtkSetMacro(Height, double);
+    vtkGetMacro(Height, double);
+
+    // anzahl der segmente am umfang von kugel und zylinder
+    vtkSetClampMacro(Resolution, int, 3, 1024);
+    vtkGetMacro(Resolution, int);
+
+    // vorzeichenbehafteter abstand, innen negativ
+    double SignedDistance (const double pt[3]);
+
+    // maximale abweichung der vernetzung von der exakten oberfläche
+    double GetTolerance ();
+
+    // bounds von A werden nur für die ebene benötigt
+    void GetPolyData (const double bounds[6], vtkPolyData *pd);
+
+protected:
+    vtkBooleanPrimitive ();
+    ~vtkBooleanPrimitive () {}
+
+    void PrintSelf (ostream&, vtkIndent) override {};
+
+private:
+    vtkBooleanPrimitive (const vtkBooleanPrimitive&) = delete;
+    void operator= (const vtkBooleanPrimitive&) = delete;
+
+};
+
+#endif
@@ -0,0 +1,763 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cstring>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <tuple>
+#include <atomic>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPolyData.h>
+#include <vtkPoints.h>
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkSmartPointer.h>
+#include <vtkSMPTools.h>
+
+#include "vtkMappedMeshReader.h"
+
+namespace {
+
+class MappedFile {
+public:
+    MappedFile (const char *fileName) : data(nullptr), size(0) {
+#ifdef _WIN32
+        file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        mapping = nullptr;
+
+        if (file == INVALID_HANDLE_VALUE) {
+            return;
+        }
+
+        LARGE_INTEGER s;
+
+        if (!GetFileSizeEx(file, &s) || s.QuadPart == 0) {
+            return;
+        }
+
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (mapping == nullptr) {
+            return;
+        }
+
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+        if (data != nullptr) {
+            size = static_cast<std::size_t>(s.QuadPart);
+        }
+#else
+        fd = open(fileName, O_RDONLY);
+
+        if (fd < 0) {
+            return;
+        }
+
+        struct stat st;
+
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            return;
+        }
+
+        void *p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (p != MAP_FAILED) {
+            data = static_cast<const char*>(p);
+            size = static_cast<std::size_t>(st.st_size);
+
+            // die datei wird einmal von vorne nach hinten gelesen
+            madvise(p, size, MADV_SEQUENTIAL);
+        }
+#endif
+    }
+
+    ~MappedFile () {
+#ifdef _WIN32
+        if (data != nullptr) {
+            UnmapViewOfFile(data);
+        }
+        if (mapping != nullptr) {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file);
+        }
+#else
+        if (data != nullptr) {
+            munmap(const_cast<char*>(data), size);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+    }
+
+    MappedFile (const MappedFile&) = delete;
+    MappedFile& operator= (const MappedFile&) = delete;
+
+    const char *data;
+    std::size_t size;
+
+private:
+#ifdef _WIN32
+    HANDLE file, mapping;
+#else
+    int fd;
+#endif
+};
+
+bool IsBigEndian () {
+    const std::uint16_t v = 1;
+    return *reinterpret_cast<const unsigned char*>(&v) == 0;
+}
+
+template<typename T>
+T Get (const char *p, bool swap) {
+    T v;
+
+    if (swap) {
+        char b[sizeof(T)];
+        std::reverse_copy(p, p+sizeof(T), b);
+        std::memcpy(&v, b, sizeof(T));
+    } else {
+        std::memcpy(&v, p, sizeof(T));
+    }
+
+    return v;
+}
+
+enum class PlyType {
+    NONE, INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64
+};
+
+PlyType GetPlyType (const std::string &s) {
+    if (s == "char" || s == "int8") {
+        return PlyType::INT8;
+    } else if (s == "uchar" || s == "uint8") {
+        return PlyType::UINT8;
+    } else if (s == "short" || s == "int16") {
+        return PlyType::INT16;
+    } else if (s == "ushort" || s == "uint16") {
+        return PlyType::UINT16;
+    } else if (s == "int" || s == "int32") {
+        return PlyType::INT32;
+    } else if (s == "uint" || s == "uint32") {
+        return PlyType::UINT32;
+    } else if (s == "float" || s == "float32") {
+        return PlyType::FLOAT32;
+    } else if (s == "double" || s == "float64") {
+        return PlyType::FLOAT64;
+    }
+
+    return PlyType::NONE;
+}
+
+std::size_t GetPlySize (PlyType t) {
+    switch (t) {
+        case PlyType::INT8:
+        case PlyType::UINT8:
+            return 1;
+        case PlyType::INT16:
+        case PlyType::UINT16:
+            return 2;
+        case PlyType::INT32:
+        case PlyType::UINT32:
+        case PlyType::FLOAT32:
+            return 4;
+        case PlyType::FLOAT64:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+double GetPlyValue (const char *p, PlyType t, bool swap) {
+    switch (t) {
+        case PlyType::INT8:
+            return static_cast<double>(Get<std::int8_t>(p, swap));
+        case PlyType::UINT8:
+            return static_cast<double>(Get<std::uint8_t>(p, swap));
+        case PlyType::INT16:
+            return static_cast<double>(Get<std::int16_t>(p, swap));
+        case PlyType::UINT16:
+            return static_cast<double>(Get<std::uint16_t>(p, swap));
+        case PlyType::INT32:
+            return static_cast<double>(Get<std::int32_t>(p, swap));
+        case PlyType::UINT32:
+            return static_cast<double>(Get<std::uint32_t>(p, swap));
+        case PlyType::FLOAT32:
+            return static_cast<double>(Get<float>(p, swap));
+        case PlyType::FLOAT64:
+            return Get<double>(p, swap);
+        default:
+            return 0;
+    }
+}
+
+class PlyProp {
+public:
+    PlyProp () : type(PlyType::NONE), countType(PlyType::NONE), offset(0) {}
+
+    std::string name;
+    PlyType type, countType;
+    std::size_t offset;
+
+    bool IsList () const {
+        return countType != PlyType::NONE;
+    }
+};
+
+class PlyElem {
+public:
+    PlyElem () : count(0), stride(0), fixed(true) {}
+
+    std::string name;
+    std::size_t count, stride;
+    bool fixed;
+
+    std::vector<PlyProp> props;
+
+    const PlyProp* Find (const std::string &name) const {
+        for (auto &p : props) {
+            if (p.name == name) {
+                return &p;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// obergrenze für den header, den CanReadFile nach dem format absucht
+const std::streamoff MAX_PLY_HEADER = 1 << 16;
+
+// eine binäre stl darf nach den dreiecken weitere bytes enthalten, aber nicht weniger als angekündigt
+bool IsStlSize (std::size_t size, std::uint32_t numTris) {
+    return size >= 84 && size-84 >= 50*static_cast<std::size_t>(numTris);
+}
+
+class StlKey {
+public:
+    float pt[3];
+    vtkIdType i;
+
+    bool operator< (const StlKey &other) const {
+        return std::tie(pt[0], pt[1], pt[2], i) < std::tie(other.pt[0], other.pt[1], other.pt[2], other.i);
+    }
+
+    bool SamePt (const StlKey &other) const {
+        return pt[0] == other.pt[0] && pt[1] == other.pt[1] && pt[2] == other.pt[2];
+    }
+};
+
+}
+
+vtkStandardNewMacro(vtkMappedMeshReader);
+
+vtkMappedMeshReader::vtkMappedMeshReader () {
+
+    FileName = nullptr;
+
+    SetNumberOfInputPorts(0);
+    SetNumberOfOutputPorts(1);
+
+}
+
+vtkMappedMeshReader::~vtkMappedMeshReader () {
+
+    SetFileName(nullptr);
+
+}
+
+int vtkMappedMeshReader::CanReadFile (const char *fileName) {
+
+    std::ifstream f(fileName, std::ios::binary | std::ios::ate);
+
+    if (!f) {
+        return 0;
+    }
+
+    std::streamoff size = f.tellg();
+
+    f.seekg(0);
+
+    char head[84] = {};
+    f.read(head, std::min<std::streamoff>(size, 84));
+
+    if (size >= 4 && std::strncmp(head, "ply", 3) == 0) {
+        // comment und obj_info können beliebig vor dem format stehen, gelesen wird bis end_header
+
+        f.clear();
+        f.seekg(0);
+
+        std::string line;
+        std::streamoff read = 0;
+
+        while (read < MAX_PLY_HEADER && std::getline(f, line)) {
+            read += static_cast<std::streamoff>(line.size())+1;
+
+            if (line.compare(0, 13, "format binary") == 0) {
+                return 1;
+            }
+
+            if (line.compare(0, 10, "end_header") == 0) {
+                break;
+            }
+        }
+
+        return 0;
+    }
+
+    if (size >= 84) {
+        return IsStlSize(static_cast<std::size_t>(size), Get<std::uint32_t>(head+80, IsBigEndian()));
+    }
+
+    return 0;
+
+}
+
+int vtkMappedMeshReader::RequestData (vtkInformation *vtkNotUsed(request), vtkInformationVector **vtkNotUsed(inputVector), vtkInformationVector *outputVector) {
+
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData *output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    if (FileName == nullptr) {
+        vtkErrorMacro("No FileName specified.");
+        return 0;
+    }
+
+    MappedFile file(FileName);
+
+    if (file.data == nullptr) {
+        vtkErrorMacro("Could not map file " << FileName << ".");
+        return 0;
+    }
+
+    if (file.size >= 4 && std::strncmp(file.data, "ply", 3) == 0) {
+        return ReadPLY(file.data, file.size, output);
+    }
+
+    return ReadSTL(file.data, file.size, output);
+
+}
+
+int vtkMappedMeshReader::ReadSTL (const char *data, std::size_t size, vtkPolyData *pd) {
+
+    bool swap = IsBigEndian();
+
+    if (size < 84) {
+        vtkErrorMacro("File " << FileName << " is too short for a binary STL.");
+        return 0;
+    }
+
+    vtkIdType i, numTris = static_cast<vtkIdType>(Get<std::uint32_t>(data+80, swap));
+
+    if (!IsStlSize(size, static_cast<std::uint32_t>(numTris))) {
+        vtkErrorMacro("File " << FileName << " is not a binary STL (ASCII STL is not supported).");
+        return 0;
+    }
+
+    // dekodieren, jeder eckpunkt bekommt seinen platz in der konnektivität
+
+    std::vector<StlKey> keys(3*numTris);
+
+    std::atomic<bool> nonFinite(false);
+
+    vtkSMPTools::For(0, numTris, [&](vtkIdType first, vtkIdType last) {
+        for (vtkIdType t = first; t < last; t++) {
+            const char *tri = data+84+50*t+12;
+
+            for (int j = 0; j < 3; j++) {
+                StlKey &key = keys[3*t+j];
+
+                key.pt[0] = Get<float>(tri+12*j, swap);
+                key.pt[1] = Get<float>(tri+12*j+4, swap);
+                key.pt[2] = Get<float>(tri+12*j+8, swap);
+                key.i = 3*t+j;
+
+                if (!std::isfinite(key.pt[0]) || !std::isfinite(key.pt[1]) || !std::isfinite(key.pt[2])) {
+                    nonFinite = true;
+                }
+            }
+        }
+    });
+
+    // mit NaN wäre die ordnung der sortierung nicht mehr strikt schwach
+    if (nonFinite) {
+        vtkErrorMacro("File " << FileName << " contains non-finite vertex coordinates.");
+        return 0;
+    }
+
+    // exaktes verschweißen über eine sortierung, entspricht dem vtkMergePoints im vtkSTLReader
+
+    vtkSMPTools::Sort(keys.begin(), keys.end());
+
+    auto conn = vtkSmartPointer<vtkIdTypeArray>::New();
+    conn->SetNumberOfValues(3*numTris);
+
+    auto coords = vtkSmartPointer<vtkFloatArray>::New();
+    coords->SetNumberOfComponents(3);
+    coords->Allocate(3*numTris);
+
+    vtkIdType numPts = -1;
+
+    for (i = 0; i < 3*numTris; i++) {
+        const StlKey &key = keys[i];
+
+        if (i == 0 || !key.SamePt(keys[i-1])) {
+            coords->InsertNextTypedTuple(key.pt);
+            numPts++;
+        }
+
+        conn->SetValue(key.i, numPts);
+    }
+
+    std::vector<StlKey>().swap(keys);
+
+    coords->Squeeze();
+
+    auto offsets = vtkSmartPointer<vtkIdTypeArray>::New();
+    offsets->SetNumberOfValues(numTris+1);
+
+    vtkSMPTools::For(0, numTris+1, [&](vtkIdType first, vtkIdType last) {
+        for (vtkIdType t = first; t < last; t++) {
+            offsets->SetValue(t, 3*t);
+        }
+    });
+
+    auto pts = vtkSmartPointer<vtkPoints>::New();
+    pts->SetData(coords);
+
+    auto polys = vtkSmartPointer<vtkCellArray>::New();
+    polys->SetData(offsets, conn);
+
+    pd->SetPoints(pts);
+    pd->SetPolys(polys);
+
+    return 1;
+
+}
+
+int vtkMappedMeshReader::ReadPLY (const char *data, std::size_t size, vtkPolyData *pd) {
+
+    // header lesen
+
+    const char *end = nullptr;
+
+    for (const char *p = data; p+10 <= data+size; p++) {
+        if (std::strncmp(p, "end_header", 10) == 0) {
+            end = p+10;
+            break;
+        }
+    }
+
+    if (end == nullptr) {
+        vtkErrorMacro("File " << FileName << " has no valid PLY header.");
+        return 0;
+    }
+
+    while (end < data+size && *end != '\n') {
+        end++;
+    }
+
+    end++;
+
+    std::istringstream header(std::string(data, end-data));
+    std::string line, word;
+
+    std::vector<PlyElem> elems;
+    bool swap = false, binary = false;
+
+    while (std::getline(header, line)) {
+        std::istringstream ls(line);
+        ls >> word;
+
+        if (word == "format") {
+            ls >> word;
+
+            if (word == "binary_little_endian") {
+                binary = true;
+                swap = IsBigEndian();
+            } else if (word == "binary_big_endian") {
+                binary = true;
+                swap = !IsBigEndian();
+            }
+
+        } else if (word == "element") {
+            PlyElem elem;
+            ls >> elem.name >> elem.count;
+            elems.push_back(elem);
+
+        } else if (word == "property" && !elems.empty()) {
+            PlyElem &elem = elems.back();
+            PlyProp prop;
+
+            ls >> word;
+
+            if (word == "list") {
+                std::string countType, itemType;
+                ls >> countType >> itemType >> prop.name;
+
+                prop.countType = GetPlyType(countType);
+                prop.type = GetPlyType(itemType);
+
+                elem.fixed = false;
+            } else {
+                prop.type = GetPlyType(word);
+                ls >> prop.name;
+            }
+
+            if (prop.type == PlyType::NONE || (prop.IsList() && prop.countType == PlyType::NONE)) {
+                vtkErrorMacro("File " << FileName << " has an unsupported PLY property type.");
+                return 0;
+            }
+
+            prop.offset = elem.stride;
+            elem.stride += prop.IsList() ? 0 : GetPlySize(prop.type);
+            elem.props.push_back(prop);
+        }
+    }
+
+    if (!binary) {
+        vtkErrorMacro("File " << FileName << " is not a binary PLY (ASCII PLY is not supported).");
+        return 0;
+    }
+
+    const char *pos = end;
+
+    const char *vertData = nullptr;
+
+    const PlyElem *vertElem = nullptr,
+        *faceElem = nullptr;
+
+    std::vector<const char*> faceStarts;
+
+    // ob noch num bytes ab pos in der datei liegen, ohne über das ende hinaus zu rechnen
+    auto Fits = [&](const char *p, std::size_t num) {
+        return p <= data+size && num <= static_cast<std::size_t>(data+size-p);
+    };
+
+    for (auto &elem : elems) {
+        if (elem.name == "vertex") {
+            vertData = pos;
+            vertElem = &elem;
+        } else if (elem.name == "face") {
+            faceElem = &elem;
+        }
+
+        if (elem.fixed) {
+            if (elem.stride != 0 && elem.count > static_cast<std::size_t>(data+size-pos)/elem.stride) {
+                vtkErrorMacro("File " << FileName << " is truncated.");
+                return 0;
+            }
+
+            pos += elem.count*elem.stride;
+        } else {
+            // elemente mit listen haben variable länge, die anfänge werden seriell bestimmt
+
+            bool isFace = &elem == faceElem;
+
+            if (isFace) {
+                faceStarts.reserve(elem.count+1);
+            }
+
+            for (std::size_t j = 0; j < elem.count; j++) {
+                if (isFace) {
+                    faceStarts.push_back(pos);
+                }
+
+                // jede eigenschaft des datensatzes wird vor dem lesen geprüft, bei listen auch die einträge
+
+                for (auto &prop : elem.props) {
+                    std::size_t num = GetPlySize(prop.IsList() ? prop.countType : prop.type);
+
+                    if (prop.IsList()) {
+                        if (!Fits(pos, num)) {
+                            vtkErrorMacro("File " << FileName << " is truncated.");
+                            return 0;
+                        }
+
+                        double n = GetPlyValue(pos, prop.countType, swap);
+
+                        if (n < 0) {
+                            vtkErrorMacro("File " << FileName << " has a negative list length.");
+                            return 0;
+                        }
+
+                        num += static_cast<std::size_t>(n)*GetPlySize(prop.type);
+                    }
+
+                    if (!Fits(pos, num)) {
+                        vtkErrorMacro("File " << FileName << " is truncated.");
+                        return 0;
+                    }
+
+                    pos += num;
+                }
+            }
+
+            if (isFace) {
+                faceStarts.push_back(pos);
+            }
+        }
+    }
+
+    if (vertElem == nullptr || faceElem == nullptr || !vertElem->fixed) {
+        vtkErrorMacro("File " << FileName << " does not contain a supported vertex and face element.");
+        return 0;
+    }
+
+    const PlyProp *propX = vertElem->Find("x"),
+        *propY = vertElem->Find("y"),
+        *propZ = vertElem->Find("z");
+
+    const PlyProp *propInds = faceElem->Find("vertex_indices");
+
+    if (propInds == nullptr) {
+        propInds = faceElem->Find("vertex_index");
+    }
+
+    if (propX == nullptr || propY == nullptr || propZ == nullptr || propInds == nullptr || !propInds->IsList()) {
+        vtkErrorMacro("File " << FileName << " lacks vertex coordinates or face indices.");
+        return 0;
+    }
+
+    // punkte
+
+    vtkIdType numPts = static_cast<vtkIdType>(vertElem->count),
+        numPolys = static_cast<vtkIdType>(faceElem->count);
+
+    const std::size_t stride = vertElem->stride;
+    const PlyProp *xyz[] = {propX, propY, propZ};
+
+    vtkSmartPointer<vtkDataArray> coords;
+
+    if (propX->type == PlyType::FLOAT64 || propY->type == PlyType::FLOAT64 || propZ->type == PlyType::FLOAT64) {
+        coords = vtkSmartPointer<vtkDoubleArray>::New();
+    } else {
+        coords = vtkSmartPointer<vtkFloatArray>::New();
+    }
+
+    coords->SetNumberOfComponents(3);
+    coords->SetNumberOfTuples(numPts);
+
+    vtkSMPTools::For(0, numPts, [&](vtkIdType first, vtkIdType last) {
+        for (vtkIdType v = first; v < last; v++) {
+            const char *vert = vertData+v*stride;
+
+            for (int j = 0; j < 3; j++) {
+                coords->SetComponent(v, j, GetPlyValue(vert+xyz[j]->offset, xyz[j]->type, swap));
+            }
+        }
+    });
+
+    // polygone, bei festen eigenschaften vor der liste kann der offset direkt verwendet werden
+
+    std::size_t indsOffset = 0;
+
+    for (auto &prop : faceElem->props) {
+        if (&prop == propInds) {
+            break;
+        }
+
+        if (prop.IsList()) {
+            indsOffset = std::string::npos;
+            break;
+        }
+
+        indsOffset += GetPlySize(prop.type);
+    }
+
+    if (indsOffset == std::string::npos) {
+        vtkErrorMacro("File " << FileName << " has list properties in front of the face indices.");
+        return 0;
+    }
+
+    const std::size_t countSize = GetPlySize(propInds->countType),
+        indSize = GetPlySize(propInds->type);
+
+    auto offsets = vtkSmartPointer<vtkIdTypeArray>::New();
+    offsets->SetNumberOfValues(numPolys+1);
+
+    vtkIdType f, numConn = 0;
+
+    for (f = 0; f < numPolys; f++) {
+        offsets->SetValue(f, numConn);
+        numConn += static_cast<vtkIdType>(GetPlyValue(faceStarts[f]+indsOffset, propInds->countType, swap));
+    }
+
+    offsets->SetValue(numPolys, numConn);
+
+    auto conn = vtkSmartPointer<vtkIdTypeArray>::New();
+    conn->SetNumberOfValues(numConn);
+
+    // indizes außerhalb der punkte würden erst weiter hinten in der pipeline zu zugriffen außerhalb der arrays führen
+
+    std::atomic<bool> invalid(false);
+
+    vtkSMPTools::For(0, numPolys, [&](vtkIdType first, vtkIdType last) {
+        for (vtkIdType g = first; g < last; g++) {
+            const char *inds = faceStarts[g]+indsOffset+countSize;
+
+            vtkIdType a = offsets->GetValue(g),
+                b = offsets->GetValue(g+1);
+
+            for (vtkIdType k = a; k < b; k++) {
+                double ind = GetPlyValue(inds+(k-a)*indSize, propInds->type, swap);
+
+                if (ind < 0 || ind >= static_cast<double>(numPts)) {
+                    invalid = true;
+                    conn->SetValue(k, 0);
+                } else {
+                    conn->SetValue(k, static_cast<vtkIdType>(ind));
+                }
+            }
+        }
+    });
+
+    if (invalid) {
+        vtkErrorMacro("File " << FileName << " has face indices outside of the " << numPts << " vertices.");
+        return 0;
+    }
+
+    auto pts = vtkSmartPointer<vtkPoints>::New();
+    pts->SetData(coords);
+
+    auto polys = vtkSmartPointer<vtkCellArray>::New();
+    polys->SetData(offsets, conn);
+
+    pd->SetPoints(pts);
+    pd->SetPolys(polys);
+
+    return 1;
+
+}
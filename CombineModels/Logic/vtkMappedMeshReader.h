@@ -0,0 +1,59 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __vtkMappedMeshReader_h
+#define __vtkMappedMeshReader_h
+
+#include "vtkSlicerCombineModelsModuleLogicExport.h"
+
+#include <string>
+
+#include <vtkPolyDataAlgorithm.h>
+
+// liest binäre stl- und ply-dateien über eine speicherabbildung ein
+//
+// die dreiecke werden parallel dekodiert, gleiche punkte der stl werden exakt (ohne toleranz) zusammengeführt,
+// das toleranzbehaftete verschweißen bleibt dem vtkCleanPolyData im vtkPolyDataBooleanFilter überlassen
+
+class VTK_SLICER_COMBINEMODELS_MODULE_LOGIC_EXPORT vtkMappedMeshReader : public vtkPolyDataAlgorithm {
+    char *FileName;
+
+    int ReadSTL (const char *data, std::size_t size, vtkPolyData *pd);
+    int ReadPLY (const char *data, std::size_t size, vtkPolyData *pd);
+
+public:
+    vtkTypeMacro(vtkMappedMeshReader, vtkPolyDataAlgorithm);
+    static vtkMappedMeshReader* New ();
+
+    vtkSetStringMacro(FileName);
+    vtkGetStringMacro(FileName);
+
+    // liefert 1, wenn die datei eine binäre stl oder ply ist
+    static int CanReadFile (const char *fileName);
+
+protected:
+    vtkMappedMeshReader ();
+    ~vtkMappedMeshReader ();
+
+    int RequestData (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector) override;
+
+    void PrintSelf (ostream&, vtkIndent) override {};
+
+private:
+    vtkMappedMeshReader (const vtkMappedMeshReader&) = delete;
+    void operator= (const vtkMappedMeshReader&) = delete;
+
+};
+
+#endif
@@ -0,0 +1,400 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <numeric>
+#include <array>
+#include <string>
+
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPolyData.h>
+#include <vtkCellData.h>
+#include <vtkPointData.h>
+#include <vtkIdList.h>
+#include <vtkCommand.h>
+#include <vtkTransform.h>
+#include <vtkTransformPolyDataFilter.h>
+#include <vtkAppendPolyData.h>
+#include <vtkStaticCellLocator.h>
+#include <vtkOBBTree.h>
+#include <vtkSMPTools.h>
+
+#include "vtkMultiPoseDifferenceFilter.h"
+#include "vtkPolyDataBooleanFilter.h"
+#include "RefitOBBTree.h"
+
+namespace {
+
+typedef std::array<double, 6> BoundsType;
+
+class ErrorObserver : public vtkCommand {
+public:
+    static ErrorObserver* New () { return new ErrorObserver; }
+
+    void Execute (vtkObject *vtkNotUsed(caller), unsigned long vtkNotUsed(event), void *data) override {
+        failed = true;
+
+        if (data != nullptr && msg.empty()) {
+            msg = static_cast<const char*>(data);
+        }
+    }
+
+    bool failed = false;
+    std::string msg;
+};
+
+bool Overlap (const double *a, const double *b) {
+    return a[0] <= b[1] && a[1] >= b[0]
+        && a[2] <= b[3] && a[3] >= b[2]
+        && a[4] <= b[5] && a[5] >= b[4];
+}
+
+vtkSmartPointer<vtkPolyData> Append (vtkPolyData *a, vtkPolyData *b) {
+    vtkSmartPointer<vtkAppendPolyData> app = vtkSmartPointer<vtkAppendPolyData>::New();
+    app->AddInputData(a);
+    app->AddInputData(b);
+    app->Update();
+
+    vtkSmartPointer<vtkPolyData> pd = vtkSmartPointer<vtkPolyData>::New();
+    pd->ShallowCopy(app->GetOutput());
+
+    return pd;
+}
+
+// ob b ganz in a liegt, berühren sich beide nicht, genügt dafür ein punkt
+bool Contains (vtkPolyData *a, vtkPolyData *b) {
+    if (b->GetNumberOfPoints() == 0) {
+        return false;
+    }
+
+    vtkSmartPointer<vtkOBBTree> obb = vtkSmartPointer<vtkOBBTree>::New();
+    obb->SetDataSet(a);
+    obb->BuildLocator();
+
+    double pt[3];
+    b->GetPoint(0, pt);
+
+    return obb->InsideOrOutside(pt) == -1;
+}
+
+// vereinigt beide, berühren sie sich nicht, werden sie nur aneinandergehängt bzw. bleibt von ineinander liegenden
+// nur die äußere; schlägt die vereinigung fehl, ist das ergebnis leer und msg enthält den grund
+vtkSmartPointer<vtkPolyData> Unite (vtkPolyData *a, vtkPolyData *b, std::string &msg) {
+    double bndsA[6], bndsB[6];
+
+    a->GetBounds(bndsA);
+    b->GetBounds(bndsB);
+
+    if (!Overlap(bndsA, bndsB)) {
+        return Append(a, b);
+    }
+
+    vtkSmartPointer<ErrorObserver> errors = vtkSmartPointer<ErrorObserver>::New();
+
+    vtkSmartPointer<vtkPolyDataBooleanFilter> bf = vtkSmartPointer<vtkPolyDataBooleanFilter>::New();
+    bf->AddObserver(vtkCommand::ErrorEvent, errors);
+    bf->SetInputData(0, a);
+    bf->SetInputData(1, b);
+    bf->SetOperModeToUnion();
+    bf->AttachIndexOn();
+    bf->Update();
+
+    if (errors->failed) {
+        // die bounds überlappen, die oberflächen aber nicht, z.b. bei diagonal versetzten lagen
+
+        if (errors->msg.find("Inputs have no contact") != std::string::npos) {
+            if (Contains(a, b)) {
+                return a;
+            }
+
+            if (Contains(b, a)) {
+                return b;
+            }
+
+            return Append(a, b);
+        }
+
+        msg = errors->msg;
+        return nullptr;
+    }
+
+    if (bf->GetOutput()->GetNumberOfCells() == 0) {
+        msg = "Union is empty";
+        return nullptr;
+    }
+
+    vtkSmartPointer<vtkPolyData> pd = vtkSmartPointer<vtkPolyData>::New();
+    pd->ShallowCopy(bf->GetOutput());
+
+    // die arrays des filters würden beim nächsten durchlauf nur stören
+    pd->GetCellData()->Initialize();
+    pd->GetPointData()->Initialize();
+
+    // die kopie hat dieselben zellen, der baum geht an die nächste vereinigung weiter
+
+    RefitOBBTree *index = SpatialIndex::Find(bf->GetOutput());
+
+    if (index != nullptr) {
+        SpatialIndex::Attach(pd, index);
+    }
+
+    return pd;
+}
+
+}
+
+vtkStandardNewMacro(vtkMultiPoseDifferenceFilter);
+
+vtkMultiPoseDifferenceFilter::vtkMultiPoseDifferenceFilter () {
+
+    SetNumberOfInputPorts(2);
+    SetNumberOfOutputPorts(1);
+
+    NumberOfUsedPoses = 0;
+    NumberOfClusters = 0;
+
+}
+
+void vtkMultiPoseDifferenceFilter::AddPose (vtkMatrix4x4 *matrix) {
+    vtkSmartPointer<vtkMatrix4x4> pose = vtkSmartPointer<vtkMatrix4x4>::New();
+    pose->DeepCopy(matrix);
+
+    Poses.push_back(pose);
+
+    Modified();
+}
+
+void vtkMultiPoseDifferenceFilter::RemoveAllPoses () {
+    Poses.clear();
+
+    Modified();
+}
+
+int vtkMultiPoseDifferenceFilter::RequestData (vtkInformation *vtkNotUsed(request), vtkInformationVector **inputVector, vtkInformationVector *outputVector) {
+
+    vtkInformation *inInfoA = inputVector[0]->GetInformationObject(0);
+    vtkInformation *inInfoB = inputVector[1]->GetInformationObject(0);
+
+    vtkPolyData *pdA = vtkPolyData::SafeDownCast(inInfoA->Get(vtkDataObject::DATA_OBJECT()));
+    vtkPolyData *pdB = vtkPolyData::SafeDownCast(inInfoB->Get(vtkDataObject::DATA_OBJECT()));
+
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData *output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    NumberOfUsedPoses = 0;
+    NumberOfClusters = 0;
+
+    double bndsA[6], bndsB[6];
+
+    pdA->GetBounds(bndsA);
+    pdB->GetBounds(bndsB);
+
+    // aussortieren
+
+    vtkSmartPointer<vtkStaticCellLocator> loc = vtkSmartPointer<vtkStaticCellLocator>::New();
+    loc->SetDataSet(pdA);
+    loc->BuildLocator();
+
+    vtkSmartPointer<vtkIdList> cells = vtkSmartPointer<vtkIdList>::New();
+
+    std::vector<int> used;
+    std::vector<BoundsType> bnds;
+
+    int i, j, k;
+
+    auto SamePose = [&](int p, int q) {
+        for (int r = 0; r < 16; r++) {
+            if (Poses[p]->GetElement(r/4, r%4) != Poses[q]->GetElement(r/4, r%4)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (i = 0; i < static_cast<int>(Poses.size()); i++) {
+        // eine wiederholte lage, z.b. ein verweilender bohrer, würde mit sich selbst vereinigt, was an den
+        // deckungsgleichen flächen scheitert
+
+        if (std::any_of(used.begin(), used.end(), [&](int u) { return SamePose(u, i); })) {
+            continue;
+        }
+
+        BoundsType b = {VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN, VTK_DOUBLE_MAX, VTK_DOUBLE_MIN};
+
+        // bounds der transformierten bounds
+
+        for (j = 0; j < 8; j++) {
+            double in[] = {bndsB[j & 1], bndsB[2+(j >> 1 & 1)], bndsB[4+(j >> 2 & 1)], 1}, out[4];
+
+            Poses[i]->MultiplyPoint(in, out);
+
+            for (k = 0; k < 3; k++) {
+                b[2*k] = std::min(b[2*k], out[k]);
+                b[2*k+1] = std::max(b[2*k+1], out[k]);
+            }
+        }
+
+        if (!Overlap(b.data(), bndsA)) {
+            continue;
+        }
+
+        loc->FindCellsWithinBounds(b.data(), cells);
+
+        if (cells->GetNumberOfIds() == 0) {
+            continue;
+        }
+
+        used.push_back(i);
+        bnds.push_back(b);
+    }
+
+    NumberOfUsedPoses = static_cast<int>(used.size());
+
+    if (used.empty()) {
+        output->ShallowCopy(pdA);
+        return 1;
+    }
+
+    // gruppen überlappender lagen
+
+    std::vector<int> parents(used.size());
+    std::iota(parents.begin(), parents.end(), 0);
+
+    auto Find = [&](int a) {
+        while (parents[a] != a) {
+            a = parents[a] = parents[parents[a]];
+        }
+        return a;
+    };
+
+    for (i = 0; i < static_cast<int>(used.size()); i++) {
+        for (j = i+1; j < static_cast<int>(used.size()); j++) {
+            if (Overlap(bnds[i].data(), bnds[j].data())) {
+                parents[Find(j)] = Find(i);
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> clusters;
+    std::vector<int> clusterIds(used.size(), -1);
+
+    for (i = 0; i < static_cast<int>(used.size()); i++) {
+        int root = Find(i);
+
+        if (clusterIds[root] == -1) {
+            clusterIds[root] = static_cast<int>(clusters.size());
+            clusters.emplace_back();
+        }
+
+        // die reihenfolge der lagen bleibt erhalten, benachbarte lagen eines pfads überlappen sich meistens
+        clusters[clusterIds[root]].push_back(used[i]);
+    }
+
+    NumberOfClusters = static_cast<int>(clusters.size());
+
+    // die lagen werden vorab transformiert, da sich die filter sonst parallel am selben eingang registrieren
+
+    std::vector<std::vector<vtkSmartPointer<vtkPolyData>>> parts(clusters.size());
+
+    for (i = 0; i < static_cast<int>(clusters.size()); i++) {
+        for (int pose : clusters[i]) {
+            vtkSmartPointer<vtkTransform> transform = vtkSmartPointer<vtkTransform>::New();
+            transform->SetMatrix(Poses[pose]);
+
+            vtkSmartPointer<vtkTransformPolyDataFilter> tf = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+            tf->SetInputData(pdB);
+            tf->SetTransform(transform);
+            tf->SetOutputPointsPrecision(DOUBLE_PRECISION);
+            tf->Update();
+
+            vtkSmartPointer<vtkPolyData> part = vtkSmartPointer<vtkPolyData>::New();
+            part->ShallowCopy(tf->GetOutput());
+
+            parts[i].push_back(part);
+        }
+    }
+
+    // vereinigung innerhalb der gruppen, die gruppen sind voneinander unabhängig
+
+    std::vector<vtkSmartPointer<vtkPolyData>> tools(clusters.size());
+
+    // die meldungen werden erst danach ausgegeben, vtkErrorMacro ist in den threads nicht sicher
+    std::vector<std::string> msgs(clusters.size());
+
+    vtkSMPTools::For(0, static_cast<vtkIdType>(clusters.size()), [&](vtkIdType first, vtkIdType last) {
+        for (vtkIdType c = first; c < last; c++) {
+            std::vector<vtkSmartPointer<vtkPolyData>> &group = parts[c];
+
+            // paarweise, damit die zwischenergebnisse klein bleiben
+
+            bool failed = false;
+
+            while (group.size() > 1 && !failed) {
+                std::vector<vtkSmartPointer<vtkPolyData>> next;
+
+                for (std::size_t p = 0; p+1 < group.size() && !failed; p += 2) {
+                    next.push_back(Unite(group[p], group[p+1], msgs[c]));
+                    failed = next.back() == nullptr;
+                }
+
+                if (group.size()%2 == 1) {
+                    next.push_back(group.back());
+                }
+
+                group.swap(next);
+            }
+
+            // bleibt leer, der fehler wird danach gemeldet
+            if (!failed) {
+                tools[c] = group.front();
+            }
+        }
+    });
+
+    for (i = 0; i < static_cast<int>(clusters.size()); i++) {
+        if (tools[i] == nullptr) {
+            vtkErrorMacro("Union of the tool poses in cluster " << i << " failed: " << msgs[i] << ".");
+            return 0;
+        }
+    }
+
+    // die gruppen überlappen sich nicht und bilden zusammen den zweiten operanden
+
+    vtkSmartPointer<vtkAppendPolyData> app = vtkSmartPointer<vtkAppendPolyData>::New();
+
+    for (auto &tool : tools) {
+        app->AddInputData(tool);
+    }
+
+    vtkSmartPointer<ErrorObserver> errors = vtkSmartPointer<ErrorObserver>::New();
+
+    vtkSmartPointer<vtkPolyDataBooleanFilter> bf = vtkSmartPointer<vtkPolyDataBooleanFilter>::New();
+    bf->AddObserver(vtkCommand::ErrorEvent, errors);
+    bf->SetInputData(0, pdA);
+    bf->SetInputConnection(1, app->GetOutputPort());
+    bf->SetOperModeToDifference();
+    bf->Update();
+
+    if (errors->failed) {
+        vtkErrorMacro("Difference with the united tool poses failed: " << errors->msg << ".");
+        return 0;
+    }
+
+    output->ShallowCopy(bf->GetOutput());
+
+    return 1;
+
+}
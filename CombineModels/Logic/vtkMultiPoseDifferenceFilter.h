@@ -0,0 +1,67 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __vtkMultiPoseDifferenceFilter_h
+#define __vtkMultiPoseDifferenceFilter_h
+
+#include "vtkSlicerCombineModelsModuleLogicExport.h"
+
+#include <vector>
+
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+#include <vtkMatrix4x4.h>
+
+// zieht das werkzeug (zweiter eingang) in allen gegebenen lagen vom ersten eingang ab
+//
+// lagen, deren bounds keine zelle von A berühren, und wiederholte lagen werden verworfen, die übrigen werden nach
+// überlappenden bounds gruppiert, innerhalb einer gruppe vereinigt und alle gruppen in einem einzigen durchlauf von A
+// abgezogen; lagen einer gruppe, deren oberflächen sich nicht berühren, werden aneinandergehängt bzw. bleibt von
+// ineinander liegenden nur die äußere
+//
+// schlägt eine der vereinigungen oder die differenz fehl, wird der fehler gemeldet und es gibt kein ergebnis
+
+class VTK_SLICER_COMBINEMODELS_MODULE_LOGIC_EXPORT vtkMultiPoseDifferenceFilter : public vtkPolyDataAlgorithm {
+    std::vector<vtkSmartPointer<vtkMatrix4x4>> Poses;
+
+    int NumberOfUsedPoses, NumberOfClusters;
+
+public:
+    vtkTypeMacro(vtkMultiPoseDifferenceFilter, vtkPolyDataAlgorithm);
+    static vtkMultiPoseDifferenceFilter* New ();
+
+    // die matrix wird kopiert, es werden nur starre lagen erwartet
+    void AddPose (vtkMatrix4x4 *matrix);
+    void RemoveAllPoses ();
+    int GetNumberOfPoses () { return static_cast<int>(Poses.size()); }
+
+    // ergebnisse des letzten durchlaufs
+    vtkGetMacro(NumberOfUsedPoses, int);
+    vtkGetMacro(NumberOfClusters, int);
+
+protected:
+    vtkMultiPoseDifferenceFilter ();
+    ~vtkMultiPoseDifferenceFilter () {}
+
+    int RequestData (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector) override;
+
+    void PrintSelf (ostream&, vtkIndent) override {};
+
+private:
+    vtkMultiPoseDifferenceFilter (const vtkMultiPoseDifferenceFilter&) = delete;
+    void operator= (const vtkMultiPoseDifferenceFilter&) = delete;
+
+};
+
+#endif
@@ -21,7 +21,9 @@ limitations under the License.
 #include <map>
 #include <deque>
 #include <vector>
+#include <array>
 #include <set>
+#include <string>
 #include <algorithm>
 #include <cmath>
 #include <functional>
@@ -36,6 +38,7 @@ limitations under the License.
 #include <vtkPointData.h>
 #include <vtkMath.h>
 #include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
 #include <vtkCell.h>
 #include <vtkAppendPolyData.h>
 #include <vtkKdTreePointLocator.h>
@@ -47,6 +50,9 @@ limitations under the License.
 #include "vtkPolyDataContactFilter.h"
 
 #include "Utilities.h"
+#include "Validation.h"
+#include "RefitOBBTree.h"
+#include "AppendBuffer.h"
 
 #include "Merger.h"
 #include "Decomposer.h"
@@ -68,8 +74,6 @@ vtkPolyDataBooleanFilter::vtkPolyDataBooleanFilter () {
     timePdA = 0;
     timePdB = 0;
 
-    contLines = vtkPolyData::New();
-
     modPdA = vtkPolyData::New();
     modPdB = vtkPolyData::New();
 
@@ -79,29 +83,90 @@ vtkPolyDataBooleanFilter::vtkPolyDataBooleanFilter () {
     cellIdsA = vtkIntArray::New();
     cellIdsB = vtkIntArray::New();
 
+    contFilter = vtkPolyDataContactFilter::New();
+
     OperMode = OPER_UNION;
 
     MergeRegs = false;
     DecPolys = true;
 
+    PairSearchTileSize = 0;
+
+    ResultSink = nullptr;
+
+    primPd = vtkPolyData::New();
+    timePrim = 0;
+
+    Localized = false;
+    LocalMargin = 0;
+
+    // wird erst bei bedarf erzeugt
+    localFilter = nullptr;
+
+    cleanPdA = vtkPolyData::New();
+    localPd = vtkPolyData::New();
+    restPd = vtkPolyData::New();
+    localIds = vtkIdList::New();
+
+    timeCleanA = 0;
+    timeValidA = 0;
+    timeValidB = 0;
+
+    SnapRounding = false;
+    SnapResolution = 1 << 20;
+
+    gridSpacing = 0;
+
+    SeamWelding = false;
+    ComputeVolumes = false;
+    ValidateInputs = false;
+    AttachIndex = false;
+
+    Volume = 0;
+    Area = 0;
+    IntersectionVolume = 0;
+
 }
 
 vtkPolyDataBooleanFilter::~vtkPolyDataBooleanFilter () {
 
+    if (localFilter != nullptr) {
+        localFilter->Delete();
+    }
+
+    localIds->Delete();
+    restPd->Delete();
+    localPd->Delete();
+    cleanPdA->Delete();
+
+    primPd->Delete();
+
     cellIdsA->Delete();
     cellIdsB->Delete();
 
+    contFilter->Delete();
+
     cellDataB->Delete();
     cellDataA->Delete();
 
     modPdB->Delete();
     modPdA->Delete();
 
-    contLines->Delete();
+}
+
+int vtkPolyDataBooleanFilter::ProcessRequest (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector) {
+    if (Policy != nullptr && request->Has(vtkDemandDrivenPipeline::REQUEST_DATA())) {
+        int ret = 1;
 
+        Policy->Execute([&]() { ret = ExecuteRequest(request, inputVector, outputVector); });
+
+        return ret;
+    }
+
+    return ExecuteRequest(request, inputVector, outputVector);
 }
 
-int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector) {
+int vtkPolyDataBooleanFilter::ExecuteRequest (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector) {
 
     if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA())) {
 
@@ -109,7 +174,30 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
         vtkInformation *inInfoB = inputVector[1]->GetInformationObject(0);
 
         vtkPolyData *pdA = vtkPolyData::SafeDownCast(inInfoA->Get(vtkDataObject::DATA_OBJECT()));
-        vtkPolyData *pdB = vtkPolyData::SafeDownCast(inInfoB->Get(vtkDataObject::DATA_OBJECT()));
+        vtkPolyData *pdB = inInfoB != nullptr ? vtkPolyData::SafeDownCast(inInfoB->Get(vtkDataObject::DATA_OBJECT())) : nullptr;
+
+        Volume = 0;
+        Area = 0;
+        IntersectionVolume = 0;
+
+        regionVolumes.clear();
+        regionAreas.clear();
+
+        if (Primitive != nullptr) {
+            // die ebene hängt von den bounds von A ab
+
+            if (Primitive->GetMTime() > timePrim || pdA->GetMTime() > timePdA) {
+                Primitive->GetPolyData(pdA->GetBounds(), primPd);
+                timePrim = Primitive->GetMTime();
+            }
+
+            pdB = primPd;
+
+        } else if (pdB == nullptr) {
+            vtkErrorMacro("Second input or primitive is missing.");
+
+            return 1;
+        }
 
         vtkInformation *outInfoA = outputVector->GetInformationObject(0);
         vtkInformation *outInfoB = outputVector->GetInformationObject(1);
@@ -117,28 +205,67 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
         resultA = vtkPolyData::SafeDownCast(outInfoA->Get(vtkDataObject::DATA_OBJECT()));
         resultB = vtkPolyData::SafeDownCast(outInfoB->Get(vtkDataObject::DATA_OBJECT()));
 
+        // der baum eines vorherigen durchlaufs passt nicht mehr zum neuen ergebnis
+        SpatialIndex::Detach(resultA);
+
+        // das gitter hängt von beiden eingaben ab, die aufteilung von A ließe sich daher nicht wiederverwenden
+
+        if (Localized && Primitive == nullptr && ResultSink == nullptr && !MergeRegs && !SnapRounding) {
+            ProcessLocalized(pdA, pdB);
+
+            return 1;
+        }
+
 // #ifdef DEBUG
         using clock = std::chrono::steady_clock;
         std::vector<clock::duration> times;
         clock::time_point start;
 // #endif
 
-        if (pdA->GetMTime() > timePdA || pdB->GetMTime() > timePdB) {
+        double spacing = SnapRounding ? GetGridSpacing(pdA, pdB) : 0;
+
+        if (pdA->GetMTime() > timePdA || pdB->GetMTime() > timePdB || spacing != gridSpacing) {
+
+            gridSpacing = spacing;
 
-            // eventuell vorhandene regionen vereinen
+            vtkSmartPointer<vtkPolyData> inA = pdA,
+                inB = pdB;
+
+            if (spacing > 0) {
+                inA = vtkSmartPointer<vtkPolyData>::New();
+                inB = vtkSmartPointer<vtkPolyData>::New();
+
+                SnapToGrid(pdA, spacing, inA);
+                SnapToGrid(pdB, spacing, inB);
+            }
+
+            // eventuell vorhandene regionen vereinen, auf dem gitter sind gleiche punkte exakt gleich
 
             vtkSmartPointer<vtkCleanPolyData> cleanA = vtkSmartPointer<vtkCleanPolyData>::New();
             cleanA->SetOutputPointsPrecision(DOUBLE_PRECISION);
-            cleanA->SetTolerance(1e-6);
-            cleanA->SetInputData(pdA);
+            cleanA->SetTolerance(spacing > 0 ? 0 : 1e-6);
+            cleanA->SetInputData(inA);
             cleanA->Update();
 
             vtkSmartPointer<vtkCleanPolyData> cleanB = vtkSmartPointer<vtkCleanPolyData>::New();
             cleanB->SetOutputPointsPrecision(DOUBLE_PRECISION);
-            cleanB->SetTolerance(1e-6);
-            cleanB->SetInputData(pdB);
+            cleanB->SetTolerance(spacing > 0 ? 0 : 1e-6);
+            cleanB->SetInputData(inB);
             cleanB->Update();
 
+            // ein baum an einer eingabe gilt auch für die bereinigte, solange dabei keine zelle entfallen ist
+
+            auto ForwardIndex = [](vtkPolyData *in, vtkPolyData *cleaned) {
+                RefitOBBTree *index = SpatialIndex::Find(in);
+
+                if (index != nullptr && cleaned->GetNumberOfCells() == in->GetNumberOfCells()) {
+                    SpatialIndex::Attach(cleaned, index);
+                }
+            };
+
+            ForwardIndex(pdA, cleanA->GetOutput());
+            ForwardIndex(pdB, cleanB->GetOutput());
+
 #ifdef DEBUG
             std::cout << "Exporting modPdA.vtk" << std::endl;
             WriteVTK("modPdA.vtk", cleanA->GetOutput());
@@ -147,6 +274,10 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
             WriteVTK("modPdB.vtk", cleanB->GetOutput());
 #endif
 
+            if (ValidateInputs && !CheckInputs(cleanA->GetOutput(), cleanB->GetOutput())) {
+                return 1;
+            }
+
             // CellData sichern
 
             cellDataA->DeepCopy(cleanA->GetOutput()->GetCellData());
@@ -159,20 +290,32 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
             start = clock::now();
 // #endif
 
-            vtkSmartPointer<vtkPolyDataContactFilter> cl = vtkSmartPointer<vtkPolyDataContactFilter>::New();
+            vtkPolyDataContactFilter *cl = contFilter;
             cl->SetInputConnection(0, cleanA->GetOutputPort());
             cl->SetInputConnection(1, cleanB->GetOutputPort());
+            cl->SetPairSearchTileSize(PairSearchTileSize);
+            cl->SetPrimitive(Primitive);
+            cl->SetPolicy(Policy);
             cl->Update();
 
 // #ifdef DEBUG
             times.push_back(clock::now()-start);
 // #endif
 
-            contLines->DeepCopy(cl->GetOutput());
+            // zwischen den schritten kann der filter über AbortExecute abgebrochen werden, die zwischenstände
+            // gelten dann nicht als aktuell und werden beim nächsten durchlauf neu berechnet
+
+            UpdateProgress(.3);
+
+            if (GetAbortExecute()) {
+                return 1;
+            }
+
+            contLines.Init(cl->GetOutput());
 
 #ifdef DEBUG
             std::cout << "Exporting contLines.vtk" << std::endl;
-            WriteVTK("contLines.vtk", contLines);
+            WriteVTK("contLines.vtk", cl->GetOutput());
 
             std::cout << "Exporting modPdA_1.vtk" << std::endl;
             WriteVTK("modPdA_1.vtk", cl->GetOutput(1));
@@ -184,34 +327,32 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
             modPdA->DeepCopy(cl->GetOutput(1));
             modPdB->DeepCopy(cl->GetOutput(2));
 
-            if (contLines->GetNumberOfCells() == 0) {
+            if (contLines.GetNumberOfLines() == 0) {
                 vtkErrorMacro("Inputs have no contact.");
 
                 return 1;
             }
 
-            // in den CellDatas steht drin, welche polygone einander schneiden
+            // je linie steht drin, welche polygone einander schneiden
 
-            vtkIntArray *contsA = vtkIntArray::SafeDownCast(contLines->GetCellData()->GetScalars("cA"));
-            vtkIntArray *contsB = vtkIntArray::SafeDownCast(contLines->GetCellData()->GetScalars("cB"));
+            const ContsType &contsA = contLines.contsA,
+                &contsB = contLines.contsB;
 
-            vtkIntArray *sourcesA = vtkIntArray::SafeDownCast(contLines->GetCellData()->GetScalars("sourcesA"));
-            vtkIntArray *sourcesB = vtkIntArray::SafeDownCast(contLines->GetCellData()->GetScalars("sourcesB"));
+            const SourcesType &sourcesA = contLines.sourcesA,
+                &sourcesB = contLines.sourcesB;
 
-            int i, numPts = contLines->GetNumberOfPoints();
+            int i, numPts = contLines.GetNumberOfPoints();
 
-            vtkIdList *cells = vtkIdList::New();
+            IdsType cells;
 
             for (i = 0; i < numPts; i++) {
-                contLines->GetPointCells(i, cells);
+                contLines.GetLines(i, cells);
 
-                if (cells->GetNumberOfIds() == 1) {
+                if (cells.size() == 1) {
                     break;
                 }
             }
 
-            cells->Delete();
-
             if (i < numPts) {
                 vtkErrorMacro("Contact ends suddenly at point " << i << ".");
 
@@ -278,6 +419,12 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
             times.push_back(clock::now()-start);
 // #endif
 
+            UpdateProgress(.5);
+
+            if (GetAbortExecute()) {
+                return 1;
+            }
+
 #ifdef DEBUG
             std::cout << "Exporting modPdA_2.vtk" << std::endl;
             WriteVTK("modPdA_2.vtk", modPdA);
@@ -290,8 +437,11 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
             start = clock::now();
 // #endif
 
-            RestoreOrigPoints(modPdA, polyStripsA);
-            RestoreOrigPoints(modPdB, polyStripsB);
+            contIdsA.clear();
+            contIdsB.clear();
+
+            RestoreOrigPoints(modPdA, polyStripsA, contIdsA);
+            RestoreOrigPoints(modPdB, polyStripsB, contIdsB);
 
 // #ifdef DEBUG
             times.push_back(clock::now()-start);
@@ -309,8 +459,8 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
             start = clock::now();
 // #endif
 
-            ResolveOverlaps(modPdA, contsA, polyStripsA);
-            ResolveOverlaps(modPdB, contsB, polyStripsB);
+            ResolveOverlaps(modPdA, contsA, polyStripsA, contIdsA);
+            ResolveOverlaps(modPdB, contsB, polyStripsB, contIdsB);
 
 // #ifdef DEBUG
             times.push_back(clock::now()-start);
@@ -328,8 +478,8 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
             start = clock::now();
 // #endif
 
-            AddAdjacentPoints(modPdA, contsA, polyStripsA);
-            AddAdjacentPoints(modPdB, contsB, polyStripsB);
+            AddAdjacentPoints(modPdA, contsA, polyStripsA, contIdsA);
+            AddAdjacentPoints(modPdB, contsB, polyStripsB, contIdsB);
 
 // #ifdef DEBUG
             times.push_back(clock::now()-start);
@@ -347,8 +497,8 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
             start = clock::now();
 // #endif
 
-            DisjoinPolys(modPdA, polyStripsA);
-            DisjoinPolys(modPdB, polyStripsB);
+            DisjoinPolys(modPdA, polyStripsA, contIdsA);
+            DisjoinPolys(modPdB, polyStripsB, contIdsB);
 
 // #ifdef DEBUG
             times.push_back(clock::now()-start);
@@ -366,13 +516,19 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
             start = clock::now();
 // #endif
 
-            MergePoints(modPdA, polyStripsA);
-            MergePoints(modPdB, polyStripsB);
+            MergePoints(modPdA, polyStripsA, contIdsA);
+            MergePoints(modPdB, polyStripsB, contIdsB);
 
 // #ifdef DEBUG
             times.push_back(clock::now()-start);
 // #endif
 
+            UpdateProgress(.7);
+
+            if (GetAbortExecute()) {
+                return 1;
+            }
+
 #ifdef DEBUG
             std::cout << "Exporting modPdA_7.vtk" << std::endl;
             WriteVTK("modPdA_7.vtk", modPdA);
@@ -384,11 +540,11 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
             involvedA.clear();
             involvedB.clear();
 
-            int numLines = contLines->GetNumberOfCells();
+            int numLines = contLines.GetNumberOfLines();
 
             for (int i = 0; i < numLines; i++) {
-                involvedA.insert(contsA->GetValue(i));
-                involvedB.insert(contsB->GetValue(i));
+                involvedA.insert(contsA[i]);
+                involvedB.insert(contsB[i]);
             }
 
             relsA.clear();
@@ -410,6 +566,12 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
         times.push_back(clock::now()-start);
 // #endif
 
+        UpdateProgress(.9);
+
+        if (GetAbortExecute()) {
+            return 1;
+        }
+
 #ifdef DEBUG
         std::cout << "Exporting modPdA_8.vtk" << std::endl;
         WriteVTK("modPdA_8.vtk", modPdA);
@@ -433,26 +595,521 @@ int vtkPolyDataBooleanFilter::ProcessRequest(vtkInformation *request, vtkInforma
 // #endif
 
 
-// #ifdef DEBUG
-        double sum = std::chrono::duration_cast<std::chrono::duration<double>>(std::accumulate(times.begin(), times.end(), clock::duration())).count();
+        Timings.clear();
 
-        std::vector<clock::duration>::const_iterator itr;
-        for (itr = times.begin(); itr != times.end(); itr++) {
-            double time = std::chrono::duration_cast<std::chrono::duration<double>>(*itr).count();
+        for (auto &time : times) {
+            Timings.push_back(std::chrono::duration_cast<std::chrono::duration<double>>(time).count());
+        }
 
-            std::cout << "Time " << (itr-times.begin())
-                << ": " << time << "s (" << (time/sum*100) << "%)"
+#ifdef DEBUG
+        double sum = std::accumulate(Timings.begin(), Timings.end(), 0.);
+
+        std::vector<double>::const_iterator itr;
+        for (itr = Timings.begin(); itr != Timings.end(); itr++) {
+            std::cout << "Time " << (itr-Timings.begin())
+                << ": " << *itr << "s (" << (*itr/sum*100) << "%)"
                 << std::endl;
         }
-// #endif
+#endif
+
+    }
+
+    return 1;
+
+}
+
+// wurzel der komponente eines punkts, die pfade werden dabei verkürzt
+vtkIdType FindRoot (std::vector<vtkIdType> &parents, vtkIdType i) {
+    while (parents[i] != i) {
+        i = parents[i] = parents[parents[i]];
+    }
+
+    return i;
+}
+
+void vtkPolyDataBooleanFilter::SplitLocal (vtkPolyData *pd) {
+
+    // zellen, deren bounds den bereich schneiden, kommen nach localPd, alle anderen nach restPd
+
+    vtkIdType numCells = pd->GetNumberOfCells(),
+        numPts = pd->GetNumberOfPoints();
+
+    vtkIdList *restIds = vtkIdList::New();
+
+    localIds->Reset();
+
+    double b[6];
+
+    for (vtkIdType i = 0; i < numCells; i++) {
+        pd->GetCellBounds(i, b);
+
+        if (b[0] <= localBnds[1] && b[1] >= localBnds[0]
+            && b[2] <= localBnds[3] && b[3] >= localBnds[2]
+            && b[4] <= localBnds[5] && b[5] >= localBnds[4]) {
+
+            localIds->InsertNextId(i);
+        } else {
+            restIds->InsertNextId(i);
+        }
+    }
+
+    auto Extract = [&](vtkIdList *ids, vtkPolyData *out, std::vector<vtkIdType> &map) {
+        map.assign(numPts, -1);
+
+        vtkPoints *pts = vtkPoints::New();
+        pts->SetDataTypeToDouble();
+
+        vtkCellArray *polys = vtkCellArray::New();
+
+        out->Initialize();
+        out->SetPoints(pts);
+        out->SetPolys(polys);
+
+        out->GetPointData()->CopyAllocate(pd->GetPointData());
+        out->GetCellData()->CopyAllocate(pd->GetCellData());
+
+        vtkIdList *cell = vtkIdList::New();
+
+        for (vtkIdType i = 0; i < ids->GetNumberOfIds(); i++) {
+            vtkIdType cellId = ids->GetId(i);
+
+            pd->GetCellPoints(cellId, cell);
+
+            for (vtkIdType j = 0; j < cell->GetNumberOfIds(); j++) {
+                vtkIdType &id = map[cell->GetId(j)];
+
+                if (id == -1) {
+                    id = pts->InsertNextPoint(pd->GetPoint(cell->GetId(j)));
+                    out->GetPointData()->CopyData(pd->GetPointData(), cell->GetId(j), id);
+                }
+
+                cell->SetId(j, id);
+            }
+
+            out->GetCellData()->CopyData(pd->GetCellData(), cellId, polys->InsertNextCell(cell));
+        }
+
+        cell->Delete();
+        polys->Delete();
+        pts->Delete();
+    };
+
+    std::vector<vtkIdType> localMap, restMap;
+
+    Extract(localIds, localPd, localMap);
+    Extract(restIds, restPd, restMap);
+
+    // der innere filter nummeriert die punkte neu, ihre koordinaten bleiben aber erhalten
+
+    seamPts.clear();
+
+    double pt[3];
+
+    for (vtkIdType i = 0; i < numPts; i++) {
+        if (localMap[i] != -1 && restMap[i] != -1) {
+            pd->GetPoint(i, pt);
+            seamPts.emplace(std::array<double, 3>{pt[0], pt[1], pt[2]}, restMap[i]);
+        }
+    }
+
+    // die komponenten von restPd ändern sich nicht, SpliceLocal verbindet sie nur noch mit denen des ausschnitts
+
+    restRoots.resize(restPd->GetNumberOfPoints());
+    std::iota(restRoots.begin(), restRoots.end(), 0);
+
+    vtkCellArray *polys = restPd->GetPolys();
+
+    vtkIdType num;
+    const vtkIdType *poly;
+
+    for (vtkIdType i = 0; i < polys->GetNumberOfCells(); i++) {
+        polys->GetCellAtId(i, num, poly);
+
+        for (vtkIdType j = 1; j < num; j++) {
+            restRoots[FindRoot(restRoots, poly[j])] = FindRoot(restRoots, poly[0]);
+        }
+    }
+
+    for (vtkIdType i = 0; i < restPd->GetNumberOfPoints(); i++) {
+        restRoots[i] = FindRoot(restRoots, i);
+    }
+
+    // der rest erhält die arrays, die auch CombineRegions anlegt
+
+    vtkIntArray *origCellIdsA = vtkIntArray::New();
+    origCellIdsA->SetName("OrigCellIdsA");
+
+    vtkIntArray *origCellIdsB = vtkIntArray::New();
+    origCellIdsB->SetName("OrigCellIdsB");
+
+    for (vtkIdType i = 0; i < restIds->GetNumberOfIds(); i++) {
+        origCellIdsA->InsertNextValue(restIds->GetId(i));
+        origCellIdsB->InsertNextValue(-1);
+    }
+
+    restPd->GetCellData()->AddArray(origCellIdsA);
+    restPd->GetCellData()->AddArray(origCellIdsB);
+
+    origCellIdsB->Delete();
+    origCellIdsA->Delete();
+
+    restIds->Delete();
+
+}
+
+bool vtkPolyDataBooleanFilter::CheckInputs (vtkPolyData *pdA, vtkPolyData *pdB) {
+    std::string msg;
+
+    if (!ValidatePolyData(pdA, msg)) {
+        vtkErrorMacro("First input is not valid: " << msg << ".");
+
+        return false;
+    }
+
+    // ein primitiv ist immer geschlossen
+    if (Primitive == nullptr && !ValidatePolyData(pdB, msg)) {
+        vtkErrorMacro("Second input is not valid: " << msg << ".");
+
+        return false;
+    }
+
+    return true;
+}
+
+double vtkPolyDataBooleanFilter::GetGridSpacing (vtkPolyData *pdA, vtkPolyData *pdB) {
+    double bndsA[6], bndsB[6];
+
+    pdA->GetBounds(bndsA);
+    pdB->GetBounds(bndsB);
+
+    double ext = 0;
+
+    for (int i = 0; i < 3; i++) {
+        ext = std::max(ext, std::max(bndsA[2*i+1], bndsB[2*i+1])-std::min(bndsA[2*i], bndsB[2*i]));
+    }
+
+    if (ext == 0) {
+        return 0;
+    }
+
+    // kleinste zweierpotenz, die die gewünschte auflösung noch einhält
+    return std::ldexp(1., static_cast<int>(std::ceil(std::log2(ext/SnapResolution))));
+}
+
+void vtkPolyDataBooleanFilter::SnapToGrid (vtkPolyData *pd, double spacing, vtkPolyData *snapped) {
+    vtkPoints *pts = vtkPoints::New();
+    pts->SetDataTypeToDouble();
+    pts->SetNumberOfPoints(pd->GetNumberOfPoints());
+
+    double pt[3];
+
+    for (vtkIdType i = 0; i < pd->GetNumberOfPoints(); i++) {
+        pd->GetPoint(i, pt);
+
+        // division und multiplikation mit einer zweierpotenz sind exakt
+        for (int j = 0; j < 3; j++) {
+            pt[j] = std::nearbyint(pt[j]/spacing)*spacing;
+        }
+
+        pts->SetPoint(i, pt);
+    }
+
+    snapped->ShallowCopy(pd);
+    snapped->SetPoints(pts);
+
+    pts->Delete();
+}
+
+void vtkPolyDataBooleanFilter::ProcessLocalized (vtkPolyData *pdA, vtkPolyData *pdB) {
+
+    // A wird nur nach einer änderung bereinigt und geprüft, der innere filter bekommt nur einen offenen ausschnitt davon
+
+    bool changed = pdA->GetMTime() > timeCleanA;
+
+    if (changed) {
+        vtkCleanPolyData *cleanA = vtkCleanPolyData::New();
+        cleanA->SetOutputPointsPrecision(DOUBLE_PRECISION);
+        cleanA->SetTolerance(1e-6);
+        cleanA->SetInputData(pdA);
+        cleanA->Update();
+
+        cleanPdA->ShallowCopy(cleanA->GetOutput());
+
+        cleanA->Delete();
+
+        timeCleanA = pdA->GetMTime();
+    }
+
+    std::string msg;
+
+    if (ValidateInputs && pdA->GetMTime() > timeValidA) {
+        if (!ValidatePolyData(cleanPdA, msg)) {
+            vtkErrorMacro("First input is not valid: " << msg << ".");
+
+            return;
+        }
+
+        timeValidA = pdA->GetMTime();
+    }
+
+    // B ist klein, wird aber ebenso nur nach einer änderung geprüft
+
+    if (ValidateInputs && pdB->GetMTime() > timeValidB) {
+        vtkCleanPolyData *cleanB = vtkCleanPolyData::New();
+        cleanB->SetOutputPointsPrecision(DOUBLE_PRECISION);
+        cleanB->SetTolerance(1e-6);
+        cleanB->SetInputData(pdB);
+        cleanB->Update();
+
+        bool valid = ValidatePolyData(cleanB->GetOutput(), msg);
+
+        cleanB->Delete();
+
+        if (!valid) {
+            vtkErrorMacro("Second input is not valid: " << msg << ".");
+
+            return;
+        }
+
+        timeValidB = pdB->GetMTime();
+    }
+
+    double bndsB[6];
+    pdB->GetBounds(bndsB);
+
+    // die aufteilung wird wiederverwendet, solange B im bereich liegt, der dann die alte und die neue lage von B umfasst
+
+    bool reuse = !changed && localPd->GetNumberOfCells() > 0;
+
+    double ext = 0;
+
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        reuse = reuse && bndsB[2*i] >= localBnds[2*i] && bndsB[2*i+1] <= localBnds[2*i+1];
+        ext = std::max(ext, bndsB[2*i+1]-bndsB[2*i]);
+    }
+
+    if (!reuse) {
+        double margin = LocalMargin > 0 ? LocalMargin : ext/4;
+
+        for (i = 0; i < 3; i++) {
+            localBnds[2*i] = bndsB[2*i]-margin;
+            localBnds[2*i+1] = bndsB[2*i+1]+margin;
+        }
+
+        SplitLocal(cleanPdA);
+    }
+
+    if (localFilter == nullptr) {
+        localFilter = vtkPolyDataBooleanFilter::New();
+    }
+
+    localFilter->SetInputData(0, localPd);
+    localFilter->SetInputData(1, pdB);
+    localFilter->SetOperMode(OperMode);
+    localFilter->SetDecPolys(DecPolys);
+    localFilter->SetPairSearchTileSize(PairSearchTileSize);
+    localFilter->SetSeamWelding(SeamWelding);
+    localFilter->SetComputeVolumes(ComputeVolumes);
+    localFilter->SetPolicy(Policy);
+    localFilter->Update();
+
+    // B liegt ganz im bereich, die schnittmenge ist also vollständig
+    IntersectionVolume = localFilter->IntersectionVolume;
+
+    Timings = localFilter->Timings;
+
+    // OrigCellIdsA beziehen sich auf localPd
+
+    vtkPolyData *local = vtkPolyData::New();
+    local->ShallowCopy(localFilter->GetOutput(0));
+
+    vtkIntArray *localCellIds = vtkIntArray::SafeDownCast(local->GetCellData()->GetArray("OrigCellIdsA"));
+
+    if (localCellIds != nullptr) {
+        vtkIntArray *origCellIdsA = vtkIntArray::New();
+        origCellIdsA->SetName("OrigCellIdsA");
+        origCellIdsA->SetNumberOfValues(localCellIds->GetNumberOfValues());
+
+        for (vtkIdType j = 0; j < localCellIds->GetNumberOfValues(); j++) {
+            int id = localCellIds->GetValue(j);
+            origCellIdsA->SetValue(j, id < 0 ? id : localIds->GetId(id));
+        }
+
+        local->GetCellData()->AddArray(origCellIdsA);
+        origCellIdsA->Delete();
+    }
+
+    if (OperMode == OPER_UNION || OperMode == OPER_DIFFERENCE) {
+        SpliceLocal(local);
+
+        if (ComputeVolumes) {
+            // die regionen sind erst jetzt wieder geschlossen
+            SumVolumes(resultA, resultA->GetPointData()->GetScalars());
+        }
+
+    } else {
+        // die teile von A außerhalb von B entfallen ohnehin
+        resultA->ShallowCopy(local);
+
+        regionVolumes = localFilter->regionVolumes;
+        regionAreas = localFilter->regionAreas;
+
+        Volume = localFilter->Volume;
+        Area = localFilter->Area;
+    }
+
+    resultB->ShallowCopy(localFilter->GetOutput(1));
+
+    local->Delete();
+
+}
+
+void vtkPolyDataBooleanFilter::SpliceLocal (vtkPolyData *local) {
+
+    // restPd bleibt vorne, von local kommen die punkte hinzu, die nicht an der grenze liegen; bereinigt wird nichts mehr
+
+    vtkIdType i, j, num, numRestPts = restPd->GetNumberOfPoints();
+    const vtkIdType *poly;
+
+    resultA->Initialize();
+
+    vtkPoints *pts = vtkPoints::New();
+    pts->DeepCopy(restPd->GetPoints());
+
+    vtkCellArray *polys = vtkCellArray::New();
+    polys->DeepCopy(restPd->GetPolys());
+
+    resultA->SetPoints(pts);
+    resultA->SetPolys(polys);
+
+    // übernommen werden die arrays, die beide teile haben
+
+    typedef std::vector<std::pair<vtkAbstractArray*, vtkAbstractArray*>> ArraysType;
+
+    auto Join = [](vtkFieldData *rest, vtkFieldData *loc, vtkFieldData *out, ArraysType &arrays) {
+        for (int k = 0; k < rest->GetNumberOfArrays(); k++) {
+            vtkAbstractArray *arr = rest->GetAbstractArray(k);
+
+            if (arr->GetName() == nullptr || std::string(arr->GetName()) == "RegionId") {
+                continue;
+            }
+
+            vtkAbstractArray *src = loc->GetAbstractArray(arr->GetName());
+
+            if (src == nullptr || src->GetDataType() != arr->GetDataType()
+                || src->GetNumberOfComponents() != arr->GetNumberOfComponents()) {
+                continue;
+            }
+
+            vtkAbstractArray *joined = arr->NewInstance();
+            joined->DeepCopy(arr);
+
+            out->AddArray(joined);
+            arrays.emplace_back(joined, src);
+
+            joined->Delete();
+        }
+    };
+
+    ArraysType ptArrays, cellArrays;
+
+    Join(restPd->GetPointData(), local->GetPointData(), resultA->GetPointData(), ptArrays);
+    Join(restPd->GetCellData(), local->GetCellData(), resultA->GetCellData(), cellArrays);
+
+    std::vector<vtkIdType> map(local->GetNumberOfPoints());
+
+    double pt[3];
+
+    for (i = 0; i < local->GetNumberOfPoints(); i++) {
+        local->GetPoint(i, pt);
+
+        auto itr = seamPts.find(std::array<double, 3>{pt[0], pt[1], pt[2]});
+
+        if (itr != seamPts.end()) {
+            map[i] = itr->second;
+        } else {
+            map[i] = pts->InsertNextPoint(pt);
+
+            for (auto &arrays : ptArrays) {
+                arrays.first->InsertTuple(map[i], i, arrays.second);
+            }
+        }
+    }
+
+    // die komponenten des rests werden über die zellen des ausschnitts verbunden
+
+    std::vector<vtkIdType> parents(restRoots);
+
+    parents.resize(pts->GetNumberOfPoints());
+    std::iota(parents.begin()+numRestPts, parents.end(), numRestPts);
+
+    vtkCellArray *localPolys = local->GetPolys();
+
+    std::vector<vtkIdType> cell;
+
+    for (i = 0; i < localPolys->GetNumberOfCells(); i++) {
+        localPolys->GetCellAtId(i, num, poly);
+
+        cell.resize(num);
+
+        for (j = 0; j < num; j++) {
+            cell[j] = map[poly[j]];
+
+            if (j > 0) {
+                parents[FindRoot(parents, cell[j])] = FindRoot(parents, cell[0]);
+            }
+        }
+
+        vtkIdType cellId = polys->InsertNextCell(num, cell.data());
+
+        for (auto &arrays : cellArrays) {
+            arrays.first->InsertTuple(cellId, i, arrays.second);
+        }
+    }
+
+    // wie bei vtkPolyDataConnectivityFilter fortlaufend nummeriert
+
+    vtkIdType numPts = pts->GetNumberOfPoints();
+
+    std::vector<vtkIdType> labels(numPts, -1);
+
+    vtkIdTypeArray *regionIds = vtkIdTypeArray::New();
+    regionIds->SetName("RegionId");
+    regionIds->SetNumberOfValues(numPts);
+
+    vtkIdType numRegions = 0;
+
+    for (i = 0; i < numPts; i++) {
+        vtkIdType &label = labels[FindRoot(parents, i)];
+
+        if (label == -1) {
+            label = numRegions++;
+        }
+
+        regionIds->SetValue(i, label);
+    }
+
+    resultA->GetPointData()->SetScalars(regionIds);
+
+    regionIds->Delete();
+    polys->Delete();
+    pts->Delete();
+
+}
+
+int vtkPolyDataBooleanFilter::FillInputPortInformation (int port, vtkInformation *info) {
+    Superclass::FillInputPortInformation(port, info);
 
+    if (port == 1) {
+        info->Set(vtkAlgorithm::INPUT_IS_OPTIONAL(), 1);
     }
 
     return 1;
-
 }
 
-void vtkPolyDataBooleanFilter::GetStripPoints (vtkPolyData *pd, vtkIntArray *sources, PStrips &pStrips, IdsType &lines) {
+void vtkPolyDataBooleanFilter::GetStripPoints (vtkPolyData *pd, const SourcesType &sources, PStrips &pStrips, IdsType &lines) {
 
 #ifdef DEBUG
     std::cout << "GetStripPoints()" << std::endl;
@@ -469,14 +1126,13 @@ void vtkPolyDataBooleanFilter::GetStripPoints (vtkPolyData *pd, vtkIntArray *sou
 
     for (itr = lines.begin(); itr != lines.end(); itr++) {
 
-        vtkIdList *linePts = vtkIdList::New();
-        contLines->GetCellPoints(*itr, linePts);
+        const auto &linePts = contLines.GetLine(*itr);
 
         // diese punkte durchlaufen
 
         for (int i = 0; i < 2; i++) {
 
-            int realInd = linePts->GetId(i);
+            int realInd = linePts[i];
 
             if (pts.count(realInd) == 0) {
                 // lage analysieren
@@ -485,11 +1141,11 @@ void vtkPolyDataBooleanFilter::GetStripPoints (vtkPolyData *pd, vtkIntArray *sou
 
                 // die koordinaten
                 double pt[3];
-                contLines->GetPoint(realInd, pt);
+                contLines.GetPoint(realInd, pt);
 
                 Cpy(pts[realInd].pt, pt, 3);
 
-                int src = sources->GetComponent(*itr, i);
+                int src = sources[*itr][i];
 
                 pts[realInd].src = src;
 
@@ -580,8 +1236,6 @@ void vtkPolyDataBooleanFilter::GetStripPoints (vtkPolyData *pd, vtkIntArray *sou
             }
         }
 
-        linePts->Delete();
-
     }
 
     StripPtsType::iterator itr2;
@@ -624,7 +1278,7 @@ void vtkPolyDataBooleanFilter::GetStripPoints (vtkPolyData *pd, vtkIntArray *sou
 
 }
 
-bool vtkPolyDataBooleanFilter::GetPolyStrips (vtkPolyData *pd, vtkIntArray *conts, vtkIntArray *sources, PolyStripsType &polyStrips) {
+bool vtkPolyDataBooleanFilter::GetPolyStrips (vtkPolyData *pd, const ContsType &conts, const SourcesType &sources, PolyStripsType &polyStrips) {
 #ifdef DEBUG
     std::cout << "GetPolyStrips()" << std::endl;
 #endif
@@ -633,8 +1287,8 @@ bool vtkPolyDataBooleanFilter::GetPolyStrips (vtkPolyData *pd, vtkIntArray *cont
 
     std::map<int, IdsType> polyLines;
 
-    for (int i = 0; i < conts->GetNumberOfTuples(); i++) {
-        int poly = conts->GetValue(i);
+    for (int i = 0; i < static_cast<int>(conts.size()); i++) {
+        int poly = conts[i];
 
         // if (poly != 95) {
         //     continue;
@@ -737,24 +1391,17 @@ bool vtkPolyDataBooleanFilter::GetPolyStrips (vtkPolyData *pd, vtkIntArray *cont
 
             if (pt.capt == CAPT_NOT) {
 
-                vtkIdList *cells = vtkIdList::New(),
-                    *line = vtkIdList::New();
-
-                contLines->GetPointCells(pt.ind, cells);
-
-                int numCells = cells->GetNumberOfIds();
+                IdsType cells;
+                contLines.GetLines(pt.ind, cells);
 
                 std::set<int> ends;
 
-                for (int i = 0; i < numCells; i++) {
-                    contLines->GetCellPoints(cells->GetId(i), line);
+                for (int c : cells) {
+                    const auto &line = contLines.GetLine(c);
 
-                    ends.insert(pt.ind == line->GetId(0) ? line->GetId(1) : line->GetId(0));
+                    ends.insert(pt.ind == line[0] ? line[1] : line[0]);
                 }
 
-                line->Delete();
-                cells->Delete();
-
                 if (ends.size() > 2) {
                     return true;
                 }
@@ -770,11 +1417,10 @@ bool vtkPolyDataBooleanFilter::GetPolyStrips (vtkPolyData *pd, vtkIntArray *cont
         std::size_t i = 0;
 
         while (_lines.size() > 0) {
-            vtkIdList *linePts = vtkIdList::New();
-            contLines->GetCellPoints(_lines[i], linePts);
+            const auto &linePts = contLines.GetLine(_lines[i]);
 
-            int indA = linePts->GetId(0);
-            int indB = linePts->GetId(1);
+            int indA = linePts[0];
+            int indB = linePts[1];
 
             if (strip.empty()) {
                 strip.push_back(StripPtR(indA));
@@ -825,8 +1471,6 @@ bool vtkPolyDataBooleanFilter::GetPolyStrips (vtkPolyData *pd, vtkIntArray *cont
                 i = 0;
             }
 
-            linePts->Delete();
-
         }
 
         CompleteStrips(pStrips);
@@ -1006,21 +1650,18 @@ void vtkPolyDataBooleanFilter::RemoveDuplicates (IdsType &lines) {
 
     // die indexe der enden auf übereinstimmung prüfen
 
-    vtkIdList *linePtsA = vtkIdList::New();
-    vtkIdList *linePtsB = vtkIdList::New();
-
     std::size_t i, j, numLines = lines.size();
 
     for (i = 0; i < numLines-1; i++) {
         j = i+1;
 
-        contLines->GetCellPoints(lines[i], linePtsA);
+        const auto &linePtsA = contLines.GetLine(lines[i]);
 
         while (j < lines.size()) {
-            contLines->GetCellPoints(lines[j], linePtsB);
+            const auto &linePtsB = contLines.GetLine(lines[j]);
 
-            if ((linePtsA->GetId(0) == linePtsB->GetId(0) && linePtsA->GetId(1) == linePtsB->GetId(1)) ||
-                (linePtsA->GetId(0) == linePtsB->GetId(1) && linePtsA->GetId(1) == linePtsB->GetId(0))) {
+            if ((linePtsA[0] == linePtsB[0] && linePtsA[1] == linePtsB[1]) ||
+                (linePtsA[0] == linePtsB[1] && linePtsA[1] == linePtsB[0])) {
                 // stimmen überein
                 break;
             }
@@ -1036,9 +1677,6 @@ void vtkPolyDataBooleanFilter::RemoveDuplicates (IdsType &lines) {
 
     unique.push_back(lines.back());
 
-    linePtsA->Delete();
-    linePtsB->Delete();
-
     lines.swap(unique);
 
 }
@@ -1087,6 +1725,8 @@ void vtkPolyDataBooleanFilter::CutCells (vtkPolyData *pd, PolyStripsType &polySt
 
     vtkIntArray *origCellIds = vtkIntArray::SafeDownCast(pd->GetCellData()->GetScalars("OrigCellIds"));
 
+    std::vector<_Wrapper> wrappers;
+
     PolyStripsType::iterator itr;
 
     for (itr = polyStrips.begin(); itr != polyStrips.end(); ++itr) {
@@ -1722,23 +2362,62 @@ void vtkPolyDataBooleanFilter::CutCells (vtkPolyData *pd, PolyStripsType &polySt
 
         pd->DeleteCell(polyInd);
 
-        // holes verarbeiten
+        // holes werden erst nach allen polygonen verarbeitet
 
         if (!holes.empty()) {
-            _Wrapper w(pd, descIds, origId);
+            wrappers.emplace_back(pd, descIds, origId);
 
             for (auto& hole : holes) {
-                w.Add(hole);
+                wrappers.back().Add(hole);
             }
+        }
+
+    }
+
+    // die polygone sind voneinander unabhängig, eingefügt wird in der ursprünglichen reihenfolge
+
+    for (auto& w : wrappers) {
+        w.Prepare();
+    }
+
+    vtkIdType grain = Policy != nullptr ? Policy->GetPolygonGrain() : 0;
 
-            w.MergeAll();
+    vtkBooleanExecutionPolicy::For(0, static_cast<vtkIdType>(wrappers.size()), grain, [&wrappers](vtkIdType first, vtkIdType last) {
+        for (vtkIdType i = first; i < last; i++) {
+            wrappers[i].Merge();
         }
+    });
 
+    for (auto& w : wrappers) {
+        w.Check();
     }
 
+    // die ids der neuen punkte und polygone stehen beim reservieren fest, in pd kommen sie erst danach
+
+    PointBuffer newPts(pdPts);
+    CellBuffer newCells(pd);
+
+    if (Policy == nullptr || Policy->GetDeterministic()) {
+        for (auto& w : wrappers) {
+            w.Commit(newPts, newCells);
+        }
+    } else {
+        vtkBooleanExecutionPolicy::For(0, static_cast<vtkIdType>(wrappers.size()), grain, [&](vtkIdType first, vtkIdType last) {
+            for (vtkIdType i = first; i < last; i++) {
+                wrappers[i].Commit(newPts, newCells);
+            }
+        });
+    }
+
+    newPts.Compact(pdPts);
+    newCells.Compact(pd, origCellIds);
+
     pd->RemoveDeletedCells();
     pd->BuildCells();
 
+    // die links werden nur hier ganz aufgebaut, die stufen bis einschließlich MergePoints führen sie mit
+    pd->BuildLinks();
+
 }
 
 void vtkPolyDataBooleanFilter::CollapseCaptPoints (vtkPolyData *vtkNotUsed(pd), PolyStripsType &polyStrips) {
@@ -1781,7 +2460,7 @@ void vtkPolyDataBooleanFilter::CollapseCaptPoints (vtkPolyData *vtkNotUsed(pd),
         }
     }
 
-    vtkIdList *cells = vtkIdList::New();
+    IdsType cells;
 
     for (auto &s : test) {
         auto &pts = s.second;
@@ -1808,15 +2487,11 @@ void vtkPolyDataBooleanFilter::CollapseCaptPoints (vtkPolyData *vtkNotUsed(pd),
             std::cout << "collapsing " << b.ind << " -> " << a.ind << std::endl;
 #endif
 
-            contLines->GetPointCells(b.ind, cells);
+            contLines.GetLines(b.ind, cells);
 
-            for (int i = 0; i < cells->GetNumberOfIds(); i++) {
-                contLines->ReplaceCellPoint(cells->GetId(i), indB, indA);
-
-                // aktualisiert die links
-                contLines->RemoveReferenceToCell(indB, cells->GetId(i));
-                contLines->ResizeCellList(indA, 1);
-                contLines->AddReferenceToCell(indA, cells->GetId(i));
+            // die links der beiden punkte werden dabei mitgeführt
+            for (int c : cells) {
+                contLines.ReplacePoint(c, indB, indA);
             }
 
             std::set<Pair> pairs;
@@ -1824,29 +2499,24 @@ void vtkPolyDataBooleanFilter::CollapseCaptPoints (vtkPolyData *vtkNotUsed(pd),
             if (a.capt == CAPT_A && b.capt == CAPT_A) {
                 std::map<int, IdsType> shared;
 
-                vtkIdList *lines = vtkIdList::New(),
-                    *cell = vtkIdList::New();
-                contLines->GetPointCells(indA, lines);
+                IdsType lines;
+                contLines.GetLines(indA, lines);
 
-                for (int i = 0; i < lines->GetNumberOfIds(); i++) {
-                    contLines->GetCellPoints(lines->GetId(i), cell);
+                for (int l : lines) {
+                    const auto &cell = contLines.GetLine(l);
 
-                    int pA = cell->GetId(0),
-                        pB = cell->GetId(1);
+                    int pA = cell[0],
+                        pB = cell[1];
 
-                    shared[pA == indA ? pB : pA].push_back(lines->GetId(i));
+                    shared[pA == indA ? pB : pA].push_back(l);
                 }
 
-                cell->Delete();
-                lines->Delete();
-
                 for (auto &s : shared) {
                     if (s.second.size() > 1) {
                         assert(s.second.size() == 2);
 
                         for (int l : s.second) {
-                            contLines->DeleteCell(l);
-                            contLines->RemoveCellReference(l);
+                            contLines.DeleteLine(l);
 
                             pairs.insert({indA, s.first});
                             pairs.insert({s.first, indA});
@@ -1857,27 +2527,22 @@ void vtkPolyDataBooleanFilter::CollapseCaptPoints (vtkPolyData *vtkNotUsed(pd),
             }
 
             if (a.capt == CAPT_A && b.capt == CAPT_EDGE) {
-                vtkIdList *lines = vtkIdList::New(),
-                    *cell = vtkIdList::New();
-                contLines->GetPointCells(indA, lines);
+                IdsType lines;
+                contLines.GetLines(indA, lines);
 
-                for (int i = 0; i < lines->GetNumberOfIds(); i++) {
-                    if (contLines->GetCellType(lines->GetId(i)) != VTK_EMPTY_CELL) {
-                        contLines->GetCellPoints(lines->GetId(i), cell);
+                for (int l : lines) {
+                    if (!contLines.IsDeleted(l)) {
+                        const auto &cell = contLines.GetLine(l);
 
-                        int pA = cell->GetId(0),
-                            pB = cell->GetId(1);
+                        int pA = cell[0],
+                            pB = cell[1];
 
                         if (pA == indA && pB == indA) {
-                            contLines->DeleteCell(lines->GetId(i));
-                            contLines->RemoveCellReference(lines->GetId(i));
+                            contLines.DeleteLine(l);
                         }
                     }
 
                 }
-
-                cell->Delete();
-                lines->Delete();
             }
 
             auto Fct = [&](PolyStripsType &polyStrips_) -> void {
@@ -1924,18 +2589,18 @@ void vtkPolyDataBooleanFilter::CollapseCaptPoints (vtkPolyData *vtkNotUsed(pd),
         }
     }
 
-    cells->Delete();
-
 }
 
 
-void vtkPolyDataBooleanFilter::RestoreOrigPoints (vtkPolyData *pd, PolyStripsType &polyStrips) {
+void vtkPolyDataBooleanFilter::RestoreOrigPoints (vtkPolyData *pd, PolyStripsType &polyStrips, ContIdsType &contIds) {
 
 #ifdef DEBUG
     std::cout << "RestoreOrigPoints()" << std::endl;
 #endif
 
-    std::vector<StripPtL> ends;
+    // die punkte, die CutCells an den eingerasteten stellen eingefügt hat, sind über desc bekannt
+
+    vtkPoints *pdPts = pd->GetPoints();
 
     PolyStripsType::iterator itr;
     StripPtsType::iterator itr2;
@@ -1943,44 +2608,39 @@ void vtkPolyDataBooleanFilter::RestoreOrigPoints (vtkPolyData *pd, PolyStripsTyp
     for (itr = polyStrips.begin(); itr != polyStrips.end(); ++itr) {
         PStrips &pStrips = itr->second;
 
-        for (itr2 = pStrips.pts.begin(); itr2 != pStrips.pts.end(); ++itr2) {
-            StripPt &sp = itr2->second;
-            ends.push_back(sp);
-        }
-    }
-
-    vtkKdTreePointLocator *loc = vtkKdTreePointLocator::New();
-    loc->SetDataSet(pd);
-    loc->BuildLocator();
+        for (const StripType &strip : pStrips.strips) {
+            for (const StripPtR &sp : strip) {
+                const StripPt &_sp = pStrips.pts[sp.ind];
 
-    vtkIdList *pts = vtkIdList::New();
+                for (int i = 0; i < 2; i++) {
+                    if (sp.desc[i] != NO_USE) {
+                        pdPts->SetPoint(sp.desc[i], _sp.pt);
+                        contIds[sp.ind].insert(sp.desc[i]);
+                    }
+                }
+            }
+        }
 
-    std::vector<StripPtL>::const_iterator itr3;
+        // auf einen punkt des polygons eingerastet, der liegt genau auf dem cutPt
 
-    for (itr3 = ends.begin(); itr3 != ends.end(); ++itr3) {
-        FindPoints(loc, itr3->cutPt, pts);
-        int numPts = pts->GetNumberOfIds();
+        for (itr2 = pStrips.pts.begin(); itr2 != pStrips.pts.end(); ++itr2) {
+            StripPt &sp = itr2->second;
 
-        for (int i = 0; i < numPts; i++) {
-            pd->GetPoints()->SetPoint(pts->GetId(i), itr3->pt);
+            if (sp.capt == CAPT_A) {
+                pdPts->SetPoint(sp.edge[0], sp.pt);
+                contIds[sp.ind].insert(sp.edge[0]);
+            }
         }
     }
 
-    pts->Delete();
-
-    loc->FreeSearchStructure();
-    loc->Delete();
-
 }
 
-void vtkPolyDataBooleanFilter::DisjoinPolys (vtkPolyData *pd, PolyStripsType &polyStrips) {
+void vtkPolyDataBooleanFilter::DisjoinPolys (vtkPolyData *pd, PolyStripsType &polyStrips, ContIdsType &contIds) {
 
 #ifdef DEBUG
     std::cout << "DisjoinPolys()" << std::endl;
 #endif
 
-    pd->BuildLinks();
-
     std::set<StripPtL> ends;
 
     PolyStripsType::iterator itr;
@@ -1997,50 +2657,44 @@ void vtkPolyDataBooleanFilter::DisjoinPolys (vtkPolyData *pd, PolyStripsType &po
         }
     }
 
-    vtkKdTreePointLocator *loc = vtkKdTreePointLocator::New();
-    loc->SetDataSet(pd);
-    loc->BuildLocator();
-
-    vtkIdList *pts = vtkIdList::New();
     vtkIdList *cells = vtkIdList::New();
 
     std::set<StripPtL>::const_iterator itr3;
 
     for (itr3 = ends.begin(); itr3 != ends.end(); ++itr3) {
-        FindPoints(loc, itr3->pt, pts);
-        int numPts = pts->GetNumberOfIds();
+        // die neuen punkte kommen erst nach der schleife dazu
+        std::set<int> &ids = contIds[itr3->ind];
+        const std::set<int> pts(ids);
 
-        for (int i = 0; i < numPts; i++) {
-            pd->GetPointCells(pts->GetId(i), cells);
+        for (int id : pts) {
+            pd->GetPointCells(id, cells);
             int numCells = cells->GetNumberOfIds();
 
             if (numCells > 1) {
                 for (int j = 0; j < numCells; j++) {
-                    pd->ReplaceCellPoint(cells->GetId(j), pts->GetId(i), pd->GetPoints()->InsertNextPoint(itr3->pt));
+                    int newId = pd->InsertNextLinkedPoint(itr3->pt, 1);
+
+                    pd->ReplaceCellPoint(cells->GetId(j), id, newId);
+
+                    pd->RemoveReferenceToCell(id, cells->GetId(j));
+                    pd->AddReferenceToCell(newId, cells->GetId(j));
+
+                    ids.insert(newId);
                 }
             }
         }
     }
 
     cells->Delete();
-    pts->Delete();
-
-    loc->FreeSearchStructure();
-    loc->Delete();
 
 }
 
-void vtkPolyDataBooleanFilter::ResolveOverlaps (vtkPolyData *pd, vtkIntArray *conts, PolyStripsType &polyStrips) {
+void vtkPolyDataBooleanFilter::ResolveOverlaps (vtkPolyData *pd, const ContsType &conts, PolyStripsType &polyStrips, ContIdsType &contIds) {
 
 #ifdef DEBUG
     std::cout << "ResolveOverlaps()" << std::endl;
 #endif
 
-    pd->BuildCells();
-    pd->BuildLinks();
-
-    contLines->BuildLinks();
-
     std::vector<StripPtL2> ends;
 
     PolyStripsType::iterator itr;
@@ -2066,7 +2720,7 @@ void vtkPolyDataBooleanFilter::ResolveOverlaps (vtkPolyData *pd, vtkIntArray *co
 
     vtkIdList *cells = vtkIdList::New();
 
-    vtkIdList *links = vtkIdList::New();
+    IdsType links;
 
     typedef std::map<int, int> CountsType;
     std::map<Pair, CountsType> skipped;
@@ -2074,10 +2728,10 @@ void vtkPolyDataBooleanFilter::ResolveOverlaps (vtkPolyData *pd, vtkIntArray *co
     std::vector<StripPtL2>::const_iterator itr3;
 
     for (itr3 = ends.begin(); itr3 != ends.end(); ++itr3) {
-        contLines->GetPointCells(itr3->ind, links);
+        contLines.GetLines(itr3->ind, links);
 
-        if (links->GetNumberOfIds() == 2
-            && conts->GetValue(links->GetId(0)) != conts->GetValue(links->GetId(1))) {
+        if (links.size() == 2
+            && conts[links[0]] != conts[links[1]]) {
 
             // kein berührender schnitt
 
@@ -2166,10 +2820,8 @@ void vtkPolyDataBooleanFilter::ResolveOverlaps (vtkPolyData *pd, vtkIntArray *co
 
         }
 
-        links->Reset();
     }
 
-    links->Delete();
     cells->Delete();
 
     ptsB->Delete();
@@ -2194,23 +2846,28 @@ void vtkPolyDataBooleanFilter::ResolveOverlaps (vtkPolyData *pd, vtkIntArray *co
 #endif
 
         double pt[3];
-        contLines->GetPoint(pair.f, pt);
+        contLines.GetPoint(pair.f, pt);
 
         for (itr5 = c.begin(); itr5 != c.end(); ++itr5) {
             if (itr5->second == 2) {
-                int i = pd->GetPoints()->InsertNextPoint(pt);
+                int i = pd->InsertNextLinkedPoint(pt, 1);
 
 #ifdef DEBUG
                 std::cout << "repl " << itr5->first << " -> " << i << std::endl;
 #endif
 
                 pd->ReplaceCellPoint(pair.g, itr5->first, i);
+
+                pd->RemoveReferenceToCell(itr5->first, pair.g);
+                pd->AddReferenceToCell(i, pair.g);
+
+                contIds[pair.f].insert(i);
             }
         }
     }
 }
 
-void vtkPolyDataBooleanFilter::AddAdjacentPoints (vtkPolyData *pd, vtkIntArray *conts, PolyStripsType &polyStrips) {
+void vtkPolyDataBooleanFilter::AddAdjacentPoints (vtkPolyData *pd, const ContsType &conts, PolyStripsType &polyStrips, ContIdsType &contIds) {
 
 #ifdef DEBUG
     std::cout << "AddAdjacentPoints()" << std::endl;
@@ -2248,8 +2905,6 @@ void vtkPolyDataBooleanFilter::AddAdjacentPoints (vtkPolyData *pd, vtkIntArray *
     BType::iterator itr4;
     CType::iterator itr5;
 
-    pd->BuildLinks();
-
     vtkKdTreePointLocator *loc = vtkKdTreePointLocator::New();
     loc->SetDataSet(pd);
     loc->BuildLocator();
@@ -2290,13 +2945,13 @@ void vtkPolyDataBooleanFilter::AddAdjacentPoints (vtkPolyData *pd, vtkIntArray *
         voids.push_back(0);
 
         for (itr5 = pts.begin()+1; itr5 != pts.end()-1; ++itr5) {
-            contLines->GetPointCells(itr5->ind, cells);
-            int numCells = cells->GetNumberOfIds();
+            IdsType lines;
+            contLines.GetLines(itr5->ind, lines);
 
             std::set<int> seeds;
 
-            for (int i = 0; i < numCells; i++) {
-                seeds.insert(conts->GetValue(cells->GetId(i)));
+            for (int l : lines) {
+                seeds.insert(conts[l]);
             }
 
 #ifdef DEBUG
@@ -2376,7 +3031,10 @@ void vtkPolyDataBooleanFilter::AddAdjacentPoints (vtkPolyData *pd, vtkIntArray *
                                     // ursprüngliche kante
 
                                     for (itr5 = pts_.begin()+1; itr5 != pts_.end()-1; ++itr5) {
-                                        poly_->InsertNextId(pd->InsertNextLinkedPoint(itr5->pt, 1));
+                                        vtkIdType id = pd->InsertNextLinkedPoint(itr5->pt, 1);
+
+                                        poly_->InsertNextId(id);
+                                        contIds[itr5->ind].insert(id);
                                     }
 
                                 }
@@ -2411,22 +3069,23 @@ void vtkPolyDataBooleanFilter::AddAdjacentPoints (vtkPolyData *pd, vtkIntArray *
     loc->FreeSearchStructure();
     loc->Delete();
 
-    pd->RemoveDeletedCells();
+    // die gelöschten zellen bleiben bis nach MergePoints stehen, sonst wären die links ungültig
 
 }
 
-void vtkPolyDataBooleanFilter::MergePoints (vtkPolyData *pd, PolyStripsType &polyStrips) {
+void vtkPolyDataBooleanFilter::MergePoints (vtkPolyData *pd, PolyStripsType &polyStrips, const ContIdsType &contIds) {
 
 #ifdef DEBUG
     std::cout << "MergePoints()" << std::endl;
 #endif
 
-    vtkKdTreePointLocator *loc = vtkKdTreePointLocator::New();
-    loc->SetDataSet(pd);
-    loc->BuildLocator();
+    // die punkte auf einem kontaktpunkt sind seit RestoreOrigPoints bekannt
+    const std::set<int> none;
 
-    // essenziell
-    pd->BuildLinks();
+    auto GetIds = [&](int ind) -> const std::set<int>& {
+        auto itr = contIds.find(ind);
+        return itr != contIds.end() ? itr->second : none;
+    };
 
     PolyStripsType::iterator itr;
     StripsType::iterator itr2;
@@ -2436,8 +3095,6 @@ void vtkPolyDataBooleanFilter::MergePoints (vtkPolyData *pd, PolyStripsType &pol
 
     BType inds;
 
-    vtkIdList *pts = vtkIdList::New();
-
     for (itr = polyStrips.begin(); itr != polyStrips.end(); ++itr) {
         PStrips &pStrips = itr->second;
 
@@ -2447,19 +3104,11 @@ void vtkPolyDataBooleanFilter::MergePoints (vtkPolyData *pd, PolyStripsType &pol
             StripPtR &s = strip.front(),
                 &e = strip.back();
 
-            FindPoints(loc, pStrips.pts[(strip.begin()+1)->ind].pt, pts);
-            int numPts = pts->GetNumberOfIds();
-
-            for (int i = 0; i < numPts; i++) {
-                inds[s.ind].insert(pts->GetId(i));
-            }
-
-            FindPoints(loc, pStrips.pts[(strip.end()-2)->ind].pt, pts);
-            numPts = pts->GetNumberOfIds();
+            const std::set<int> &idsS = GetIds((strip.begin()+1)->ind),
+                &idsE = GetIds((strip.end()-2)->ind);
 
-            for (int i = 0; i < numPts; i++) {
-                inds[e.ind].insert(pts->GetId(i));
-            }
+            inds[s.ind].insert(idsS.begin(), idsS.end());
+            inds[e.ind].insert(idsE.begin(), idsE.end());
         }
     }
 
@@ -2491,18 +3140,13 @@ void vtkPolyDataBooleanFilter::MergePoints (vtkPolyData *pd, PolyStripsType &pol
 
         CType mergePts;
 
-        double pt[3];
-        contLines->GetPoint(itr3->first, pt);
-
-        FindPoints(loc, pt, pts);
-        int numPts = pts->GetNumberOfIds();
+        const std::set<int> &pts = GetIds(itr3->first);
 
-        assert(numPts > 0);
+        assert(!pts.empty());
 
 #ifdef DEBUG
         std::cout << "pts=[";
-        for (int i = 0; i < numPts; i++) {
-            int ind = pts->GetId(i);
+        for (int ind : pts) {
             pd->GetPointCells(ind, polys);
             if (polys->GetNumberOfIds() > 0) {
                 std::cout << ind << " -> " << polys->GetId(0) << ", ";
@@ -2511,9 +3155,7 @@ void vtkPolyDataBooleanFilter::MergePoints (vtkPolyData *pd, PolyStripsType &pol
         std::cout << "]" << std::endl;
 #endif
 
-        for (int i = 0; i < numPts; i++) {
-            int ind = pts->GetId(i);
-
+        for (int ind : pts) {
             pd->GetPointCells(ind, polys);
 
             if (polys->GetNumberOfIds() > 0) {
@@ -2535,12 +3177,12 @@ void vtkPolyDataBooleanFilter::MergePoints (vtkPolyData *pd, PolyStripsType &pol
 
                 double pt_[3];
 
-                if (std::count(bads.begin(), bads.end(), before) == 0) {
+                if (bads.count(before) == 0) {
                     pd->GetPoint(before, pt_);
                     mergePts.push_back(MergePt(polys->GetId(0), ind, pt_));
                 }
 
-                if (std::count(bads.begin(), bads.end(), after) == 0) {
+                if (bads.count(after) == 0) {
                     pd->GetPoint(after, pt_);
                     mergePts.push_back(MergePt(polys->GetId(0), ind, pt_));
                 }
@@ -2623,7 +3265,18 @@ void vtkPolyDataBooleanFilter::MergePoints (vtkPolyData *pd, PolyStripsType &pol
                     std::cout << "repl " <<  mergePts[*itr6].ind << " -> " << mergePts[group.front()].ind << std::endl;
 #endif
 
-                    pd->ReplaceCellPoint(mergePts[*itr6].polyInd, mergePts[*itr6].ind, mergePts[group.front()].ind);
+                    const MergePt &from = mergePts[*itr6];
+                    vtkIdType to = mergePts[group.front()].ind;
+
+                    // ein punkt kann mit beiden nachbarn in der gruppe stehen, ersetzt wird er nur einmal
+
+                    if (from.ind != to && pd->IsPointUsedByCell(from.ind, from.polyInd)) {
+                        pd->ReplaceCellPoint(from.polyInd, from.ind, to);
+
+                        pd->RemoveReferenceToCell(from.ind, from.polyInd);
+                        pd->ResizeCellList(to, 1);
+                        pd->AddReferenceToCell(to, from.polyInd);
+                    }
                 }
 
                 group.clear();
@@ -2634,12 +3287,11 @@ void vtkPolyDataBooleanFilter::MergePoints (vtkPolyData *pd, PolyStripsType &pol
 
     }
 
-    pts->Delete();
     poly->Delete();
     polys->Delete();
 
-    loc->FreeSearchStructure();
-    loc->Delete();
+    // erst jetzt, siehe AddAdjacentPoints
+    pd->RemoveDeletedCells();
 
 }
 
@@ -2888,6 +3540,32 @@ void vtkPolyDataBooleanFilter::CombineRegions () {
     FilterCells(filterdA, relsA);
     FilterCells(filterdB, relsB);
 
+    // die punkte der naht tragen die id ihres kontaktpunkts, damit sie nach dem anfügen wiederzufinden sind
+
+    auto AddContIds = [](vtkPolyData *pd, const ContIdsType &contIds) {
+        vtkIntArray *ids = vtkIntArray::New();
+        ids->SetName("ContIds");
+        ids->SetNumberOfValues(pd->GetNumberOfPoints());
+
+        for (vtkIdType i = 0; i < pd->GetNumberOfPoints(); i++) {
+            ids->SetValue(i, -1);
+        }
+
+        for (auto &cont : contIds) {
+            for (int id : cont.second) {
+                ids->SetValue(id, cont.first);
+            }
+        }
+
+        pd->GetPointData()->AddArray(ids);
+        ids->Delete();
+    };
+
+    if (SeamWelding && ResultSink == nullptr) {
+        AddContIds(filterdA, contIdsA);
+        AddContIds(filterdB, contIdsB);
+    }
+
     // ungenutzte punkte löschen
     vtkCleanPolyData *cleanA = vtkCleanPolyData::New();
     cleanA->PointMergingOff();
@@ -2937,8 +3615,6 @@ void vtkPolyDataBooleanFilter::CombineRegions () {
     vtkDataArray *scalarsA = pdA->GetPointData()->GetScalars();
     vtkDataArray *scalarsB = pdB->GetPointData()->GetScalars();
 
-    vtkIdList *line = vtkIdList::New();
-
     double ptA[3], ptB[3];
 
     vtkIdList *fptsA = vtkIdList::New();
@@ -2949,16 +3625,16 @@ void vtkPolyDataBooleanFilter::CombineRegions () {
 
     std::map<int, int> locsA, locsB;
 
-    for (int i = 0; i < contLines->GetNumberOfCells(); i++) {
+    for (int i = 0; i < contLines.GetNumberOfLines(); i++) {
 
-        if (contLines->GetCellType(i) == VTK_EMPTY_CELL) {
+        if (contLines.IsDeleted(i)) {
             continue;
         }
 
-        contLines->GetCellPoints(i, line);
+        const auto &line = contLines.GetLine(i);
 
-        contLines->GetPoint(line->GetId(0), ptA);
-        contLines->GetPoint(line->GetId(1), ptB);
+        contLines.GetPoint(line[0], ptA);
+        contLines.GetPoint(line[1], ptB);
 
         FindPoints(plA, ptA, fptsA);
         FindPoints(plB, ptA, fptsB);
@@ -3045,7 +3721,36 @@ void vtkPolyDataBooleanFilter::CombineRegions () {
     lptsA->Delete();
     fptsA->Delete();
 
-    line->Delete();
+    if (ComputeVolumes) {
+        // die schnittmenge besteht aus den regionen beider seiten, die innerhalb der jeweils anderen liegen,
+        // ihre orientierung ist noch die der eingaben und zeigt damit schon aus der schnittmenge heraus
+
+        double bnds[6], ref[3];
+        contLines.GetBounds(bnds);
+
+        ref[0] = (bnds[0]+bnds[1])/2;
+        ref[1] = (bnds[2]+bnds[3])/2;
+        ref[2] = (bnds[4]+bnds[5])/2;
+
+        std::vector<double> volsA, areasA, volsB, areasB;
+
+        AddVolumes(pdA, scalarsA, ref, volsA, areasA);
+        AddVolumes(pdB, scalarsB, ref, volsB, areasB);
+
+        std::map<int, int>::const_iterator itr;
+
+        for (itr = locsA.begin(); itr != locsA.end(); itr++) {
+            if (itr->second == LOC_INSIDE && static_cast<std::size_t>(itr->first) < volsA.size()) {
+                IntersectionVolume += volsA[itr->first];
+            }
+        }
+
+        for (itr = locsB.begin(); itr != locsB.end(); itr++) {
+            if (itr->second == LOC_INSIDE && static_cast<std::size_t>(itr->first) < volsB.size()) {
+                IntersectionVolume += volsB[itr->first];
+            }
+        }
+    }
 
     // reale kombination der ermittelten regionen
 
@@ -3173,41 +3878,63 @@ void vtkPolyDataBooleanFilter::CombineRegions () {
     newCellDataA->Delete();
     newCellDataB->Delete();
 
-    // zusammenführung
+    if (ResultSink != nullptr) {
+        StreamRegions(regsA, regsB, newOrigCellIdsA, newOrigCellIdsB);
 
-    vtkAppendPolyData *app = vtkAppendPolyData::New();
-    app->AddInputData(regsA);
-    app->AddInputData(regsB);
+    } else {
+        // zusammenführung
 
-    // entfernt ungenutzte punkte
-    vtkCleanPolyData *cleanApp = vtkCleanPolyData::New();
-    cleanApp->PointMergingOff();
-    cleanApp->SetInputConnection(app->GetOutputPort());
+        vtkAppendPolyData *app = vtkAppendPolyData::New();
+        app->AddInputData(regsA);
+        app->AddInputData(regsB);
+        app->Update();
 
-    // färbt die regionen nochmal neu ein, damit mehrere regionen nicht die gleiche farbe haben
+        vtkPolyData *appPd = app->GetOutput();
 
-    vtkPolyDataConnectivityFilter *cfApp = vtkPolyDataConnectivityFilter::New();
-    cfApp->SetExtractionModeToAllRegions();
-    cfApp->ColorRegionsOn();
-    cfApp->SetInputConnection(cleanApp->GetOutputPort());
+        if (SeamWelding) {
+            WeldSeam(appPd);
+        }
 
-    cfApp->Update();
+        // entfernt ungenutzte punkte, darunter die verschweißten von B
+        vtkCleanPolyData *cleanApp = vtkCleanPolyData::New();
+        cleanApp->PointMergingOff();
+        cleanApp->SetInputData(appPd);
 
-    vtkPolyData *cfPd = cfApp->GetOutput();
+        // färbt die regionen nochmal neu ein, damit mehrere regionen nicht die gleiche farbe haben
 
-    // resultA ist erster output des filters
-    resultA->ShallowCopy(cfPd);
+        vtkPolyDataConnectivityFilter *cfApp = vtkPolyDataConnectivityFilter::New();
+        cfApp->SetExtractionModeToAllRegions();
+        cfApp->ColorRegionsOn();
+        cfApp->SetInputConnection(cleanApp->GetOutputPort());
 
-    resultA->GetCellData()->AddArray(newOrigCellIdsA);
-    resultA->GetCellData()->AddArray(newOrigCellIdsB);
+        cfApp->Update();
 
-    resultB->ShallowCopy(contLines);
+        vtkPolyData *cfPd = cfApp->GetOutput();
 
-    // aufräumen
+        cfPd->GetPointData()->RemoveArray("ContIds");
 
-    cfApp->Delete();
-    cleanApp->Delete();
-    app->Delete();
+        cfPd->GetCellData()->AddArray(newOrigCellIdsA);
+        cfPd->GetCellData()->AddArray(newOrigCellIdsB);
+
+        if (ComputeVolumes) {
+            SumVolumes(cfPd, cfPd->GetPointData()->GetScalars());
+        }
+
+        // resultA ist erster output des filters
+        resultA->ShallowCopy(cfPd);
+
+        if (AttachIndex) {
+            MergeTrees(newOrigCellIdsA, newOrigCellIdsB);
+        }
+
+        cfApp->Delete();
+        cleanApp->Delete();
+        app->Delete();
+    }
+
+    contLines.Export(resultB);
+
+    // aufräumen
 
     newOrigCellIdsB->Delete();
     newOrigCellIdsA->Delete();
@@ -3230,6 +3957,194 @@ void vtkPolyDataBooleanFilter::CombineRegions () {
 }
 
 
+void vtkPolyDataBooleanFilter::StreamRegions (vtkPolyData *regsA, vtkPolyData *regsB, vtkIntArray *origCellIdsA, vtkIntArray *origCellIdsB) {
+    // die regionen gehen ohne anfügen, bereinigen und neu einfärben an den sink, das ganze ergebnis liegt also
+    // nie als ein netz im speicher; die OrigCellIds beider eingaben stehen hintereinander
+
+    vtkIdType numA = regsA->GetNumberOfCells();
+
+    auto AddOrigCellIds = [&](vtkPolyData *pd, vtkIdType first) {
+        vtkIntArray *idsA = vtkIntArray::New();
+        idsA->SetName("OrigCellIdsA");
+        idsA->SetNumberOfValues(pd->GetNumberOfCells());
+
+        vtkIntArray *idsB = vtkIntArray::New();
+        idsB->SetName("OrigCellIdsB");
+        idsB->SetNumberOfValues(pd->GetNumberOfCells());
+
+        for (vtkIdType i = 0; i < pd->GetNumberOfCells(); i++) {
+            idsA->SetValue(i, origCellIdsA->GetValue(first+i));
+            idsB->SetValue(i, origCellIdsB->GetValue(first+i));
+        }
+
+        pd->GetCellData()->AddArray(idsA);
+        pd->GetCellData()->AddArray(idsB);
+
+        idsB->Delete();
+        idsA->Delete();
+    };
+
+    AddOrigCellIds(regsA, 0);
+    AddOrigCellIds(regsB, numA);
+
+    if (ComputeVolumes) {
+        // ohne die naht sind die regionen einzeln offen, es gibt nur die summe über einen gemeinsamen bezugspunkt
+
+        double bndsA[6], bndsB[6], ref[3];
+
+        regsA->GetBounds(bndsA);
+        regsB->GetBounds(bndsB);
+
+        for (int i = 0; i < 3; i++) {
+            ref[i] = (std::min(bndsA[2*i], bndsB[2*i])+std::max(bndsA[2*i+1], bndsB[2*i+1]))/2;
+        }
+
+        AddVolumes(regsA, nullptr, ref, regionVolumes, regionAreas);
+        AddVolumes(regsB, nullptr, ref, regionVolumes, regionAreas);
+
+        Volume = std::accumulate(regionVolumes.begin(), regionVolumes.end(), 0.);
+        Area = std::accumulate(regionAreas.begin(), regionAreas.end(), 0.);
+    }
+
+    if (!ResultSink->Begin()
+        || !ResultSink->Add(regsA)
+        || !ResultSink->Add(regsB)
+        || !ResultSink->End()) {
+
+        vtkErrorMacro("Sink could not write the result.");
+    }
+
+    resultA->Initialize();
+}
+
+void vtkPolyDataBooleanFilter::WeldSeam (vtkPolyData *pd) {
+    // an einem kontaktpunkt stoßen genau eine genutzte kopie von A und eine von B aneinander, die von B wird durch
+    // die von A ersetzt; stellen mit mehr als zwei kopien (nicht-mannigfaltig) bleiben getrennt
+
+    vtkIntArray *contIds = vtkIntArray::SafeDownCast(pd->GetPointData()->GetArray("ContIds"));
+
+    if (contIds == nullptr) {
+        return;
+    }
+
+    vtkIdType i, j, num, numPts = pd->GetNumberOfPoints(), numCells = pd->GetNumberOfCells();
+    const vtkIdType *poly;
+
+    std::vector<char> used(numPts, 0);
+
+    for (i = 0; i < numCells; i++) {
+        pd->GetCellPoints(i, num, poly);
+
+        for (j = 0; j < num; j++) {
+            used[poly[j]] = 1;
+        }
+    }
+
+    std::map<int, std::vector<vtkIdType>> seam;
+
+    for (i = 0; i < numPts; i++) {
+        if (used[i] && contIds->GetValue(i) != -1) {
+            seam[contIds->GetValue(i)].push_back(i);
+        }
+    }
+
+    std::vector<vtkIdType> map(numPts);
+    std::iota(map.begin(), map.end(), 0);
+
+    double ptA[3], ptB[3];
+
+    bool welded = false;
+
+    for (auto &s : seam) {
+        const std::vector<vtkIdType> &ids = s.second;
+
+        if (ids.size() == 2) {
+            pd->GetPoint(ids[0], ptA);
+            pd->GetPoint(ids[1], ptB);
+
+            if (GetD(ptA, ptB) < 1e-10) {
+                map[ids[1]] = ids[0];
+                welded = true;
+            }
+        }
+    }
+
+    if (!welded) {
+        return;
+    }
+
+    vtkCellArray *polys = vtkCellArray::New();
+    polys->AllocateEstimate(numCells, 3);
+
+    std::vector<vtkIdType> newPoly;
+
+    for (i = 0; i < numCells; i++) {
+        pd->GetCellPoints(i, num, poly);
+
+        newPoly.resize(num);
+
+        for (j = 0; j < num; j++) {
+            newPoly[j] = map[poly[j]];
+        }
+
+        polys->InsertNextCell(num, newPoly.data());
+    }
+
+    pd->SetPolys(polys);
+    polys->Delete();
+}
+
+void vtkPolyDataBooleanFilter::MergeTrees (vtkIntArray *origCellIdsA, vtkIntArray *origCellIdsB) {
+    // mit PairSearchTileSize oder einem primitiv gibt es keine bäume über allen zellen der eingaben
+
+    RefitOBBTree *obbA = contFilter->GetTreeA(),
+        *obbB = contFilter->GetTreeB();
+
+    if (obbA == nullptr || obbB == nullptr || obbA->GetDataSet() == nullptr || obbB->GetDataSet() == nullptr) {
+        return;
+    }
+
+    // die zellen des ergebnisses gehen über die OrigCellIds an die blätter der ursprünglichen zellen
+
+    CellMapType mapA(obbA->GetDataSet()->GetNumberOfCells()),
+        mapB(obbB->GetDataSet()->GetNumberOfCells());
+
+    auto Add = [](CellMapType &map, int cellId, vtkIdType i) {
+        if (cellId >= 0 && static_cast<std::size_t>(cellId) < map.size()) {
+            map[cellId].push_back(i);
+        }
+    };
+
+    for (vtkIdType i = 0; i < resultA->GetNumberOfCells(); i++) {
+        Add(mapA, origCellIdsA->GetValue(i), i);
+        Add(mapB, origCellIdsB->GetValue(i), i);
+    }
+
+    RefitOBBTree *tree = RefitOBBTree::New();
+    tree->SetNumberOfCellsPerNode(1);
+    tree->Merge(resultA, obbA, mapA, obbB, mapB);
+
+    SpatialIndex::Attach(resultA, tree);
+
+    tree->Delete();
+}
+
+void vtkPolyDataBooleanFilter::SumVolumes (vtkPolyData *pd, vtkDataArray *regions) {
+    // jede region für sich ist geschlossen, als bezugspunkt dient die mitte der bounds
+
+    double bnds[6], ref[3];
+    pd->GetBounds(bnds);
+
+    ref[0] = (bnds[0]+bnds[1])/2;
+    ref[1] = (bnds[2]+bnds[3])/2;
+    ref[2] = (bnds[4]+bnds[5])/2;
+
+    AddVolumes(pd, regions, ref, regionVolumes, regionAreas);
+
+    Volume = std::accumulate(regionVolumes.begin(), regionVolumes.end(), 0.);
+    Area = std::accumulate(regionAreas.begin(), regionAreas.end(), 0.);
+}
+
 void vtkPolyDataBooleanFilter::MergeRegions () {
 
 #ifdef DEBUG
@@ -3307,8 +4222,20 @@ void vtkPolyDataBooleanFilter::MergeRegions () {
 
     vtkPolyData *cleanPd = clean->GetOutput();
 
-    resultA->ShallowCopy(cleanPd);
-    resultB->ShallowCopy(contLines);
+    if (ResultSink != nullptr) {
+        if (!ResultSink->Begin()
+            || !ResultSink->Add(cleanPd)
+            || !ResultSink->End()) {
+
+            vtkErrorMacro("Sink could not write the result.");
+        }
+
+        resultA->Initialize();
+    } else {
+        resultA->ShallowCopy(cleanPd);
+    }
+
+    contLines.Export(resultB);
 
     clean->Delete();
     app->Delete();
@@ -3319,16 +4246,24 @@ void vtkPolyDataBooleanFilter::MergeRegions () {
 }
 
 void _Wrapper::MergeAll () {
-    vtkPoints *pdPts = pd->GetPoints();
+    Prepare();
+    Merge();
+    Check();
 
-    vtkIntArray *origCellIds = vtkIntArray::SafeDownCast(pd->GetCellData()->GetScalars("OrigCellIds"));
+    PointBuffer newPts(pd->GetPoints());
+    CellBuffer newCells(pd);
+
+    Commit(newPts, newCells);
+
+    newPts.Compact(pd->GetPoints());
+    newCells.Compact(pd, vtkIntArray::SafeDownCast(pd->GetCellData()->GetScalars("OrigCellIds")));
+}
 
+void _Wrapper::Prepare () {
     vtkIdList *cell = vtkIdList::New();
 
     // descendants in holes einfügen
 
-    std::set<int> outerIds;
-
     for (auto& id : descIds) {
         pd->GetCellPoints(id, cell);
         IdsType hole;
@@ -3345,37 +4280,61 @@ void _Wrapper::MergeAll () {
         pd->DeleteCell(id);
     }
 
-    base = Base(pdPts, cell);
+    base = Base(pd->GetPoints(), cell);
 
-    Merger m;
+    cell->Delete();
+}
 
-    for (auto& hole : holes) {
-        PolyType casted;
+void _Wrapper::Merge () {
+    // liest nur von pd, ausnahmen werden erst in Commit weitergegeben
 
-        for (int id : hole) {
-            double pt[3];
-            pd->GetPoint(id, pt);
+    try {
+        Merger m;
 
-            double _pt[2];
-            Transform(pt, _pt, base);
+        for (auto& hole : holes) {
+            PolyType casted;
 
-            casted.push_back({_pt, id});
-        }
+            for (int id : hole) {
+                double pt[3];
+                pd->GetPoint(id, pt);
+
+                double _pt[2];
+                Transform(pt, _pt, base);
+
+                casted.push_back({_pt, id});
+            }
+
+            if (TestCW(casted)) {
+                std::reverse(casted.begin(), casted.end());
+            }
 
-        if (TestCW(casted)) {
-            std::reverse(casted.begin(), casted.end());
+            m.AddPoly(casted);
         }
 
-        m.AddPoly(casted);
+        m.GetMerged(merged);
+    } catch (...) {
+        error = std::current_exception();
     }
+}
+
+void _Wrapper::Check () {
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
 
-    PolysType merged;
-    m.GetMerged(merged);
+void _Wrapper::Commit (PointBuffer &newPts, CellBuffer &newCells) {
+    // pd wird nur gelesen, neue punkte und polygone gehen in die puffer
+
+    std::vector<vtkIdType> cell;
 
     std::set<int> usedIds;
 
+    // die polygone eines wrappers bekommen aufeinanderfolgende ids
+    vtkIdType cellId = newCells.Reserve(static_cast<vtkIdType>(merged.size()));
+
     for (auto& poly : merged) {
-        cell->Reset();
+        cell.clear();
 
         // poly ist immer ccw
 
@@ -3390,25 +4349,22 @@ void _Wrapper::MergeAll () {
 
                 pd->GetPoint(p.id, _pt);
 
-                repl[p.id] = pdPts->InsertNextPoint(_pt);
+                repl[p.id] = newPts.InsertNextPoint(_pt);
 
             }
         }
 
 
         for (auto& p : poly) {
-            cell->InsertNextId(repl[p.id]);
+            cell.push_back(repl[p.id]);
             usedIds.insert(p.id);
 
         }
 
-        pd->InsertNextCell(VTK_POLYGON, cell);
-        origCellIds->InsertNextValue(origId);
+        newCells.SetCell(cellId++, static_cast<vtkIdType>(cell.size()), cell.data(), origId);
 
     }
 
-    cell->Delete();
-
 }
 
 void vtkPolyDataBooleanFilter::DecPolys_ (vtkPolyData *pd, InvolvedType &involved, RelationsType &rels) {
@@ -20,17 +20,27 @@ limitations under the License.
 #include "vtkSlicerCombineModelsModuleLogicExport.h"
 
 #include <vector>
+#include <array>
 #include <deque>
 #include <map>
 #include <set>
 #include <utility>
 #include <iostream>
+#include <exception>
 
 #include <vtkPolyDataAlgorithm.h>
 #include <vtkKdTreePointLocator.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkBooleanPrimitive.h"
+#include "vtkBooleanExecutionPolicy.h"
+
+class vtkPolyDataContactFilter;
 
 #ifndef __VTK_WRAP__
 #include "Utilities.h"
+#include "Sink.h"
+#include "ContactGraph.h"
 #endif // __VTK_WRAP__
 
 #define LOC_NONE 0
@@ -126,6 +136,9 @@ public:
 
 typedef std::map<int, PStrips> PolyStripsType;
 
+// die punkte eines operanden, die auf einem kontaktpunkt liegen, wie sie ab RestoreOrigPoints entstehen
+typedef std::map<int, std::set<int>> ContIdsType;
+
 typedef std::vector<std::reference_wrapper<StripPtR>> RefsType;
 
 class StripPtL {
@@ -197,6 +210,9 @@ public:
 
 typedef std::vector<IdsType> HolesType;
 
+class PointBuffer;
+class CellBuffer;
+
 class _Wrapper {
     vtkPolyData *pd;
     IdsType descIds;
@@ -204,11 +220,22 @@ class _Wrapper {
 
     Base base;
     HolesType holes;
+    std::set<int> outerIds;
+    std::vector<PolyType> merged;
+    std::exception_ptr error;
 public:
     _Wrapper (vtkPolyData* _pd, IdsType& _descIds, int _origId)
         : pd(_pd), descIds(_descIds), origId(_origId) {}
 
     void MergeAll ();
+
+    // MergeAll in drei schritten, Prepare ist seriell, Merge und Commit dürfen parallel für mehrere polygone laufen;
+    // Check gibt davor eine ausnahme aus Merge weiter
+    void Prepare ();
+    void Merge ();
+    void Check ();
+    void Commit (PointBuffer &newPts, CellBuffer &newCells);
+
     void Add (IdsType &hole) {
         holes.push_back(hole);
     }
@@ -224,37 +251,93 @@ enum class Rel {
 typedef std::map<int, Rel> RelationsType;
 
 class VTK_SLICER_COMBINEMODELS_MODULE_LOGIC_EXPORT vtkPolyDataBooleanFilter : public vtkPolyDataAlgorithm {
-    vtkPolyData *resultA, *resultB, *contLines;
+    vtkPolyData *resultA, *resultB;
+    ContactGraph contLines;
     vtkPolyData *modPdA, *modPdB;
     vtkCellData *cellDataA, *cellDataB;
     vtkIntArray *cellIdsA, *cellIdsB;
 
+    // bleibt erhalten, damit die obb-trees der eingaben wiederverwendet werden können
+    vtkPolyDataContactFilter *contFilter;
+
     unsigned long timePdA, timePdB;
 
     PolyStripsType polyStripsA, polyStripsB;
 
+    // die punkte je kontaktpunkt, CombineRegions verschweißt darüber bei SeamWelding die naht
+    ContIdsType contIdsA, contIdsB;
+
     InvolvedType involvedA, involvedB;
 
     RelationsType relsA, relsB;
 
-    void GetStripPoints (vtkPolyData *pd, vtkIntArray *sources, PStrips &pStrips, IdsType &lines);
-    bool GetPolyStrips (vtkPolyData *pd, vtkIntArray *conts, vtkIntArray *sources, PolyStripsType &polyStrips);
+    void GetStripPoints (vtkPolyData *pd, const SourcesType &sources, PStrips &pStrips, IdsType &lines);
+    bool GetPolyStrips (vtkPolyData *pd, const ContsType &conts, const SourcesType &sources, PolyStripsType &polyStrips);
     void RemoveDuplicates (IdsType &lines);
     void CompleteStrips (PStrips &pStrips);
     bool HasArea (StripType &strip);
     void CollapseCaptPoints (vtkPolyData *pd, PolyStripsType &polyStrips);
     void CutCells (vtkPolyData *pd, PolyStripsType &polyStrips);
-    void RestoreOrigPoints (vtkPolyData *pd, PolyStripsType &polyStrips);
-    void DisjoinPolys (vtkPolyData *pd, PolyStripsType &polyStrips);
-    void ResolveOverlaps (vtkPolyData *pd, vtkIntArray *conts, PolyStripsType &polyStrips);
-    void AddAdjacentPoints (vtkPolyData *pd, vtkIntArray *conts, PolyStripsType &polyStrips);
-    void MergePoints (vtkPolyData *pd, PolyStripsType &polyStrips);
+    void RestoreOrigPoints (vtkPolyData *pd, PolyStripsType &polyStrips, ContIdsType &contIds);
+    void DisjoinPolys (vtkPolyData *pd, PolyStripsType &polyStrips, ContIdsType &contIds);
+    void ResolveOverlaps (vtkPolyData *pd, const ContsType &conts, PolyStripsType &polyStrips, ContIdsType &contIds);
+    void AddAdjacentPoints (vtkPolyData *pd, const ContsType &conts, PolyStripsType &polyStrips, ContIdsType &contIds);
+    void MergePoints (vtkPolyData *pd, PolyStripsType &polyStrips, const ContIdsType &contIds);
     void DecPolys_ (vtkPolyData *pd, InvolvedType &involved, RelationsType &rels);
     void CombineRegions ();
+    void StreamRegions (vtkPolyData *regsA, vtkPolyData *regsB, vtkIntArray *origCellIdsA, vtkIntArray *origCellIdsB);
+    void WeldSeam (vtkPolyData *pd);
     void MergeRegions ();
+    void SumVolumes (vtkPolyData *pd, vtkDataArray *regions);
+    void MergeTrees (vtkIntArray *origCellIdsA, vtkIntArray *origCellIdsB);
+    void SplitLocal (vtkPolyData *pd);
+    void ProcessLocalized (vtkPolyData *pdA, vtkPolyData *pdB);
+    void SpliceLocal (vtkPolyData *local);
+    bool CheckInputs (vtkPolyData *pdA, vtkPolyData *pdB);
+    double GetGridSpacing (vtkPolyData *pdA, vtkPolyData *pdB);
+    void SnapToGrid (vtkPolyData *pd, double spacing, vtkPolyData *snapped);
 
     int OperMode;
     bool MergeRegs, DecPolys;
+    double PairSearchTileSize;
+
+    std::vector<double> Timings;
+
+    vtkSmartPointer<vtkBooleanPrimitive> Primitive;
+    vtkPolyData *primPd;
+    vtkMTimeType timePrim;
+
+    bool Localized;
+    double LocalMargin;
+
+    vtkPolyDataBooleanFilter *localFilter;
+    vtkPolyData *cleanPdA, *localPd, *restPd;
+    vtkIdList *localIds;
+    double localBnds[6];
+    vtkMTimeType timeCleanA, timeValidA, timeValidB;
+
+    // punkte an der grenze zwischen localPd und restPd, nach koordinaten, und die zusammenhangskomponenten von restPd
+    std::map<std::array<double, 3>, vtkIdType> seamPts;
+    std::vector<vtkIdType> restRoots;
+
+    bool SnapRounding;
+    int SnapResolution;
+
+    double gridSpacing;
+
+    bool SeamWelding;
+    bool ComputeVolumes;
+    bool ValidateInputs;
+    bool AttachIndex;
+
+    vtkSmartPointer<vtkBooleanExecutionPolicy> Policy;
+
+    double Volume, Area, IntersectionVolume;
+    std::vector<double> regionVolumes, regionAreas;
+
+#ifndef __VTK_WRAP__
+    Sink *ResultSink;
+#endif
 
 public:
     vtkTypeMacro(vtkPolyDataBooleanFilter, vtkPolyDataAlgorithm);
@@ -276,11 +359,103 @@ public:
     vtkGetMacro(DecPolys, bool);
     vtkBooleanMacro(DecPolys, bool);
 
+    // wird an den vtkPolyDataContactFilter weitergereicht und betrifft nur die suche nach den zellpaaren, geschnitten
+    // und zusammengesetzt wird weiterhin über den ganzen netzen
+    vtkSetMacro(PairSearchTileSize, double);
+    vtkGetMacro(PairSearchTileSize, double);
+
+    // laufzeiten der einzelnen schritte des letzten durchlaufs in sekunden
+    int GetNumberOfTimings () { return static_cast<int>(Timings.size()); }
+    double GetTiming (int i) { return Timings.at(i); }
+
+    // ersetzt den zweiten eingang durch die vernetzung eines primitivs, siehe vtkBooleanPrimitive
+    void SetPrimitive (vtkBooleanPrimitive *prim) { Primitive = prim; Modified(); }
+    vtkBooleanPrimitive* GetPrimitive () { return Primitive; }
+
+    // A wird auf die umgebung von B zugeschnitten, nur dieser ausschnitt wird geschnitten und der rest unverändert
+    // angefügt
+    //
+    // vom vorherigen schnitt wird nichts übernommen, jeder durchlauf schneidet den ganzen ausschnitt neu; erhalten
+    // bleiben die bereinigte und geprüfte A sowie ihre aufteilung, solange B innerhalb des ausschnitts bleibt
+    //
+    // das ergebnis wird über die punkte an der grenze des ausschnitts an den rest angefügt, ganz A wird dabei nur noch
+    // kopiert; RegionId zählt wie sonst die zusammenhängenden teile
+    vtkSetMacro(Localized, bool);
+    vtkGetMacro(Localized, bool);
+    vtkBooleanMacro(Localized, bool);
+
+    // abstand, um den der bereich über die bounds von B hinausgeht, bei 0 ein viertel der größten ausdehnung von B
+    vtkSetClampMacro(LocalMargin, double, 0, VTK_DOUBLE_MAX);
+    vtkGetMacro(LocalMargin, double);
+
+    // rundet die punkte beider eingaben auf ein gemeinsames gitter, dessen abstand eine zweierpotenz ist
+    //
+    // die gerundeten koordinaten und ihre differenzen sind exakt darstellbar, gleiche punkte werden ohne toleranz
+    // zusammengeführt und das ergebnis hängt nicht mehr von kleinsten abweichungen der eingaben ab
+    vtkSetMacro(SnapRounding, bool);
+    vtkGetMacro(SnapRounding, bool);
+    vtkBooleanMacro(SnapRounding, bool);
+
+    // anzahl der gitterzellen entlang der größten ausdehnung der gemeinsamen bounds
+    vtkSetClampMacro(SnapResolution, int, 2, 1 << 30);
+    vtkGetMacro(SnapResolution, int);
+
+    // die teile von A und B teilen sich im ersten output die punkte der schnittlinien, das ergebnis ist dann auch
+    // topologisch geschlossen und jede RegionId steht für einen ganzen körper; ohne wirkung bei MergeRegs und einem sink
+    vtkSetMacro(SeamWelding, bool);
+    vtkGetMacro(SeamWelding, bool);
+    vtkBooleanMacro(SeamWelding, bool);
+
+    // volumen und fläche des ergebnisses werden beim zusammensetzen der regionen mitberechnet, dazu das volumen
+    // der schnittmenge aus den innen liegenden teilen beider eingaben (bei einer differenz das entfernte volumen);
+    // ohne wirkung bei MergeRegs
+    vtkSetMacro(ComputeVolumes, bool);
+    vtkGetMacro(ComputeVolumes, bool);
+    vtkBooleanMacro(ComputeVolumes, bool);
+
+    vtkGetMacro(Volume, double);
+    vtkGetMacro(Area, double);
+    vtkGetMacro(IntersectionVolume, double);
+
+    // je region des ersten outputs, wie sie durch die RegionId gegeben ist; mit einem sink nur eine über alles
+    int GetNumberOfRegions () { return static_cast<int>(regionVolumes.size()); }
+    double GetRegionVolume (int i) { return regionVolumes.at(i); }
+    double GetRegionArea (int i) { return regionAreas.at(i); }
+
+    // prüft die eingaben vor dem schneiden auf offene ränder, nicht-mannigfaltige kanten und selbstschnitte
+    // und bricht beim ersten fehler mit einer meldung ab, statt erst tief in der verarbeitung zu scheitern
+    vtkSetMacro(ValidateInputs, bool);
+    vtkGetMacro(ValidateInputs, bool);
+    vtkBooleanMacro(ValidateInputs, bool);
+
+    // hängt einen obb-tree über den zellen des ersten outputs an dessen information, den ein nachfolgender
+    // vtkPolyDataBooleanFilter oder vtkPolyDataContactFilter übernimmt, statt selbst einen aufzubauen
+    //
+    // der baum entsteht aus den bäumen beider eingaben, neu geteilt werden nur die blätter geschnittener zellen;
+    // ohne wirkung bei MergeRegs, Localized, PairSearchTileSize, einem primitiv oder einem sink
+    vtkSetMacro(AttachIndex, bool);
+    vtkGetMacro(AttachIndex, bool);
+    vtkBooleanMacro(AttachIndex, bool);
+
+    // threads, backend und körnung der parallelen schritte, geht auch an den vtkPolyDataContactFilter;
+    // nullptr nimmt die globalen einstellungen von vtkSMPTools
+    void SetPolicy (vtkBooleanExecutionPolicy *policy) { Policy = policy; Modified(); }
+    vtkBooleanExecutionPolicy* GetPolicy () { return Policy; }
+
+#ifndef __VTK_WRAP__
+    // ist ein sink gesetzt, gehen die regionen von A und B an ihn, sobald sie feststehen, und der erste output bleibt
+    // leer; sie werden dafür weder angefügt noch neu eingefärbt, ihre punkte an der naht sind also getrennt
+    void SetResultSink (Sink *s) { ResultSink = s; Modified(); }
+    Sink* GetResultSink () { return ResultSink; }
+#endif
+
 protected:
     vtkPolyDataBooleanFilter ();
     ~vtkPolyDataBooleanFilter ();
 
     int ProcessRequest (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector);
+    int ExecuteRequest (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector);
+    int FillInputPortInformation (int port, vtkInformation *info) override;
 
 private:
     vtkPolyDataBooleanFilter (const vtkPolyDataBooleanFilter&) = delete;
@@ -0,0 +1,428 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <map>
+#include <array>
+#include <utility>
+
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPolyData.h>
+#include <vtkPointData.h>
+#include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkSMPTools.h>
+
+#include "vtkPolyDataClearanceFilter.h"
+#include "RefitOBBTree.h"
+#include "ClosestPoints.h"
+#include "Utilities.h"
+
+// B in einer form, die von mehreren threads gleichzeitig gelesen werden kann
+class ClearanceData {
+    class Node {
+    public:
+        Node (const vtkOBBNode *node) : box(node), kids{-1, -1}, first(0), num(0) {}
+
+        Box box;
+        int kids[2];
+        std::size_t first, num;
+    };
+
+    typedef std::array<double, 3> NormalType;
+
+    std::vector<Node> nodes;
+    std::vector<vtkIdType> leafCells;
+
+    std::vector<double> pts;
+    std::vector<vtkIdType> tris;
+
+    std::vector<NormalType> faceNormals, vertNormals;
+    std::map<std::pair<vtkIdType, vtkIdType>, NormalType> edgeNormals;
+
+    int Flatten (const vtkOBBNode *node);
+    const double* GetNormal (vtkIdType tri, int feat) const;
+
+public:
+    ClearanceData () : inputB(nullptr), timeB(0), obbB(nullptr) {}
+
+    CachedTree tree;
+
+    // der zweite eingang beim letzten aufbereiten, nur zum vergleich
+    const vtkPolyData *inputB;
+    vtkMTimeType timeB;
+
+    // der baum aus tree, für InsideOrOutside
+    RefitOBBTree *obbB;
+
+    double bnds[6];
+
+    void Update (vtkPolyData *pd, RefitOBBTree *obb);
+
+    // liefert maxDist, wenn innerhalb davon nichts gefunden wurde, found ist dann false
+    double Distance (const double *p, double maxDist, bool &found) const;
+};
+
+int ClearanceData::Flatten (const vtkOBBNode *node) {
+    int ind = static_cast<int>(nodes.size());
+
+    nodes.emplace_back(node);
+
+    if (node->Kids != nullptr) {
+        int kidA = Flatten(node->Kids[0]),
+            kidB = Flatten(node->Kids[1]);
+
+        nodes[ind].kids[0] = kidA;
+        nodes[ind].kids[1] = kidB;
+
+    } else if (node->Cells != nullptr) {
+        nodes[ind].first = leafCells.size();
+        nodes[ind].num = node->Cells->GetNumberOfIds();
+
+        for (vtkIdType i = 0; i < node->Cells->GetNumberOfIds(); i++) {
+            leafCells.push_back(node->Cells->GetId(i));
+        }
+    }
+
+    return ind;
+}
+
+void ClearanceData::Update (vtkPolyData *pd, RefitOBBTree *obb) {
+    obbB = obb;
+
+    nodes.clear();
+    leafCells.clear();
+
+    if (obb->GetRoot() != nullptr) {
+        Flatten(obb->GetRoot());
+    }
+
+    vtkIdType i, numPts = pd->GetNumberOfPoints(), numTris = pd->GetNumberOfPolys();
+
+    pts.resize(3*numPts);
+
+    for (i = 0; i < numPts; i++) {
+        pd->GetPoint(i, pts.data()+3*i);
+    }
+
+    pd->GetBounds(bnds);
+
+    tris.resize(3*numTris);
+
+    vtkIdType num;
+    const vtkIdType *poly;
+
+    vtkCellArray *polys = pd->GetPolys();
+
+    for (i = 0; i < numTris; i++) {
+        polys->GetCellAtId(i, num, poly);
+        std::copy_n(poly, 3, tris.data()+3*i);
+    }
+
+    // pseudonormalen (nach bærentzen und aanæs)
+
+    faceNormals.assign(numTris, NormalType{0, 0, 0});
+    vertNormals.assign(numPts, NormalType{0, 0, 0});
+
+    edgeNormals.clear();
+
+    int j;
+
+    for (i = 0; i < numTris; i++) {
+        const vtkIdType *tri = tris.data()+3*i;
+
+        double *n = faceNormals[i].data(), e[3][3];
+
+        for (j = 0; j < 3; j++) {
+            vtkMath::Subtract(pts.data()+3*tri[(j+1)%3], pts.data()+3*tri[j], e[j]);
+        }
+
+        vtkMath::Cross(e[0], e[1], n);
+
+        if (vtkMath::Normalize(n) == 0) {
+            continue;
+        }
+
+        for (j = 0; j < 3; j++) {
+            // winkel an der ecke j zwischen den kanten j und j-1
+
+            double a[3], b[3];
+
+            std::copy_n(e[j], 3, a);
+
+            b[0] = -e[(j+2)%3][0];
+            b[1] = -e[(j+2)%3][1];
+            b[2] = -e[(j+2)%3][2];
+
+            double w = vtkMath::AngleBetweenVectors(a, b);
+
+            NormalType &vn = vertNormals[tri[j]];
+
+            vn[0] += w*n[0];
+            vn[1] += w*n[1];
+            vn[2] += w*n[2];
+
+            NormalType &en = edgeNormals[std::minmax(tri[j], tri[(j+1)%3])];
+
+            en[0] += n[0];
+            en[1] += n[1];
+            en[2] += n[2];
+        }
+    }
+}
+
+const double* ClearanceData::GetNormal (vtkIdType tri, int feat) const {
+    const vtkIdType *poly = tris.data()+3*tri;
+
+    if (feat == FEAT_A || feat == FEAT_B || feat == FEAT_C) {
+        return vertNormals[poly[feat-FEAT_A]].data();
+    }
+
+    if (feat != FEAT_FACE) {
+        int j = feat-FEAT_AB;
+
+        auto itr = edgeNormals.find(std::minmax(poly[j], poly[(j+1)%3]));
+
+        if (itr != edgeNormals.end()) {
+            return itr->second.data();
+        }
+    }
+
+    return faceNormals[tri].data();
+}
+
+double ClearanceData::Distance (const double *p, double maxDist, bool &found) const {
+    double best = maxDist, q[3], bestQ[3];
+
+    vtkIdType bestTri = -1;
+    int bestFeat = FEAT_FACE;
+
+    found = false;
+
+    if (nodes.empty()) {
+        return best;
+    }
+
+    std::vector<std::pair<double, int>> stack;
+    stack.emplace_back(LowerBound(p, nodes[0].box), 0);
+
+    while (!stack.empty()) {
+        std::pair<double, int> top = stack.back();
+        stack.pop_back();
+
+        if (top.first >= best) {
+            continue;
+        }
+
+        const Node &node = nodes[top.second];
+
+        if (node.kids[0] == -1) {
+            for (std::size_t i = node.first; i < node.first+node.num; i++) {
+                vtkIdType t = leafCells[i];
+
+                const vtkIdType *tri = tris.data()+3*t;
+
+                int feat = ClosestPtTri(p, pts.data()+3*tri[0], pts.data()+3*tri[1], pts.data()+3*tri[2], q);
+
+                double d = std::sqrt(vtkMath::Distance2BetweenPoints(p, q));
+
+                if (d < best) {
+                    best = d;
+                    bestTri = t;
+                    bestFeat = feat;
+
+                    std::copy_n(q, 3, bestQ);
+                }
+            }
+
+        } else {
+            double lbA = LowerBound(p, nodes[node.kids[0]].box),
+                lbB = LowerBound(p, nodes[node.kids[1]].box);
+
+            // der nähere knoten kommt zuerst dran
+
+            int near = lbA < lbB ? 0 : 1;
+
+            double lbs[] = {lbA, lbB};
+
+            for (int k : {1-near, near}) {
+                if (lbs[k] < best) {
+                    stack.emplace_back(lbs[k], node.kids[k]);
+                }
+            }
+        }
+    }
+
+    if (bestTri == -1) {
+        return best;
+    }
+
+    found = true;
+
+    double v[3];
+    vtkMath::Subtract(p, bestQ, v);
+
+    return vtkMath::Dot(v, GetNormal(bestTri, bestFeat)) < 0 ? -best : best;
+}
+
+vtkStandardNewMacro(vtkPolyDataClearanceFilter);
+
+vtkPolyDataClearanceFilter::vtkPolyDataClearanceFilter () {
+
+    SetNumberOfInputPorts(2);
+    SetNumberOfOutputPorts(1);
+
+    MaximumDistance = VTK_DOUBLE_MAX;
+    RefitThreshold = 1.5;
+
+    data = new ClearanceData;
+
+}
+
+vtkPolyDataClearanceFilter::~vtkPolyDataClearanceFilter () {
+    delete data;
+}
+
+void vtkPolyDataClearanceFilter::SetMatrixB (vtkMatrix4x4 *matrix) {
+    if (matrix == nullptr) {
+        MatrixB = nullptr;
+    } else {
+        MatrixB = vtkSmartPointer<vtkMatrix4x4>::New();
+        MatrixB->DeepCopy(matrix);
+    }
+
+    Modified();
+}
+
+int vtkPolyDataClearanceFilter::RequestData (vtkInformation *vtkNotUsed(request), vtkInformationVector **inputVector, vtkInformationVector *outputVector) {
+
+    vtkInformation *inInfoA = inputVector[0]->GetInformationObject(0);
+    vtkInformation *inInfoB = inputVector[1]->GetInformationObject(0);
+
+    vtkPolyData *pdA = vtkPolyData::SafeDownCast(inInfoA->Get(vtkDataObject::DATA_OBJECT()));
+    vtkPolyData *pdB = vtkPolyData::SafeDownCast(inInfoB->Get(vtkDataObject::DATA_OBJECT()));
+
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData *output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    // B wird nur aufbereitet, wenn es sich selbst geändert hat oder ein anderer datensatz ist
+
+    if (pdB != data->inputB || pdB->GetMTime() > data->timeB) {
+        vtkPolyData *trisB = vtkPolyData::New();
+        Triangulate(pdB, trisB);
+
+        if (trisB->GetNumberOfCells() == 0) {
+            trisB->Delete();
+
+            vtkErrorMacro("Second input does not contain any polygons.");
+
+            return 1;
+        }
+
+        RefitOBBTree *obb = data->tree.Get(trisB, std::max(pdB->GetPolys()->GetMTime(), pdB->GetStrips()->GetMTime()), RefitThreshold);
+
+        data->Update(trisB, obb);
+
+        data->inputB = pdB;
+        data->timeB = pdB->GetMTime();
+
+        trisB->Delete();
+    }
+
+    // die punkte von A werden in die koordinaten von B gebracht
+
+    double inv[16];
+
+    vtkMatrix4x4 *mat = vtkMatrix4x4::New();
+
+    if (MatrixB != nullptr) {
+        vtkMatrix4x4::Invert(MatrixB, mat);
+    }
+
+    std::copy_n(mat->GetData(), 16, inv);
+
+    mat->Delete();
+
+    vtkIdType numPts = pdA->GetNumberOfPoints();
+
+    vtkDoubleArray *dists = vtkDoubleArray::New();
+    dists->SetName("Distance");
+    dists->SetNumberOfValues(numPts);
+
+    double *d = dists->GetPointer(0);
+
+    const ClearanceData *_data = data;
+    double maxDist = MaximumDistance;
+
+    vtkPoints *ptsA = pdA->GetPoints();
+
+    auto Transform = [&](vtkIdType i, double *p) {
+        double pt[3];
+        ptsA->GetPoint(i, pt);
+
+        for (int j = 0; j < 3; j++) {
+            p[j] = inv[4*j]*pt[0]+inv[4*j+1]*pt[1]+inv[4*j+2]*pt[2]+inv[4*j+3];
+        }
+    };
+
+    // punkte innerhalb der bounds von B, aber weiter als maxDist entfernt, deren vorzeichen noch fehlt
+    std::vector<char> undecided(numPts, 0);
+
+    vtkSMPTools::For(0, numPts, [&](vtkIdType first, vtkIdType last) {
+        double p[3];
+        bool found;
+
+        for (vtkIdType i = first; i < last; i++) {
+            Transform(i, p);
+
+            d[i] = _data->Distance(p, maxDist, found);
+
+            if (!found) {
+                // außerhalb der bounds von B ist der punkt sicher außen
+
+                const double *bnds = _data->bnds;
+
+                undecided[i] = p[0] >= bnds[0] && p[0] <= bnds[1] && p[1] >= bnds[2] && p[1] <= bnds[3] && p[2] >= bnds[4] && p[2] <= bnds[5];
+            }
+        }
+    });
+
+    // InsideOrOutside ist nicht threadsicher, die strahltests sind aber deutlich billiger als eine unbegrenzte suche
+
+    double p[3];
+
+    for (vtkIdType i = 0; i < numPts; i++) {
+        if (undecided[i]) {
+            Transform(i, p);
+
+            if (data->obbB->InsideOrOutside(p) == -1) {
+                d[i] = -maxDist;
+            }
+        }
+    }
+
+    output->ShallowCopy(pdA);
+    output->GetPointData()->SetScalars(dists);
+
+    dists->Delete();
+
+    return 1;
+
+}
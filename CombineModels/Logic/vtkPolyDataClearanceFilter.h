@@ -0,0 +1,74 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __vtkPolyDataClearanceFilter_h
+#define __vtkPolyDataClearanceFilter_h
+
+#include "vtkSlicerCombineModelsModuleLogicExport.h"
+
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+#include <vtkMatrix4x4.h>
+
+class ClearanceData;
+
+// vorzeichenbehafteter abstand jedes punkts von A zur oberfläche von B, als punkt-array Distance
+//
+// die punkte werden parallel gegen den obb-tree von B gesucht, das vorzeichen ergibt sich aus der
+// winkelgewichteten pseudonormale des nächsten elements (negativ innerhalb von B); B muss dafür
+// geschlossen und einheitlich nach außen orientiert sein
+//
+// der baum und die normalen von B beziehen sich auf seine eigenen koordinaten, eine starre lage von B
+// wird über MatrixB gesetzt, beim verschieben von B wird dann nichts neu aufgebaut
+
+class VTK_SLICER_COMBINEMODELS_MODULE_LOGIC_EXPORT vtkPolyDataClearanceFilter : public vtkPolyDataAlgorithm {
+    double MaximumDistance;
+    double RefitThreshold;
+
+    vtkSmartPointer<vtkMatrix4x4> MatrixB;
+
+    ClearanceData *data;
+
+public:
+    vtkTypeMacro(vtkPolyDataClearanceFilter, vtkPolyDataAlgorithm);
+    static vtkPolyDataClearanceFilter* New ();
+
+    // weiter entfernte punkte bekommen diesen betrag, die suche wird damit früh beendet; das vorzeichen solcher
+    // punkte innerhalb der bounds von B ergibt sich aus einem strahltest
+    vtkSetClampMacro(MaximumDistance, double, 0, VTK_DOUBLE_MAX);
+    vtkGetMacro(MaximumDistance, double);
+
+    // wie beim vtkPolyDataContactFilter
+    vtkSetClampMacro(RefitThreshold, double, 0, VTK_DOUBLE_MAX);
+    vtkGetMacro(RefitThreshold, double);
+
+    // lage von B in den koordinaten von A, die matrix wird kopiert; nullptr entspricht der einheitsmatrix
+    void SetMatrixB (vtkMatrix4x4 *matrix);
+    vtkMatrix4x4* GetMatrixB () { return MatrixB; }
+
+protected:
+    vtkPolyDataClearanceFilter ();
+    ~vtkPolyDataClearanceFilter ();
+
+    int RequestData (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector) override;
+
+    void PrintSelf (ostream&, vtkIndent) override {};
+
+private:
+    vtkPolyDataClearanceFilter (const vtkPolyDataClearanceFilter&) = delete;
+    void operator= (const vtkPolyDataClearanceFilter&) = delete;
+
+};
+
+#endif
@@ -38,14 +38,21 @@ limitations under the License.
 #include <vtkTriangleStrip.h>
 #include <vtkDoubleArray.h>
 #include <vtkSmartPointer.h>
+#include <vtkSMPThreadLocal.h>
 
 #include <vtkCellArray.h>
 
 #include "vtkPolyDataContactFilter.h"
+#include "vtkBooleanPrimitive.h"
 #include "Utilities.h"
+#include "Predicates.h"
+#include "RefitOBBTree.h"
 
 #undef DEBUG
 
+// obergrenze für die anzahl der bricks bei PairSearchTileSize
+#define MAX_TILES 262144
+
 vtkStandardNewMacro(vtkPolyDataContactFilter);
 
 vtkPolyDataContactFilter::vtkPolyDataContactFilter () {
@@ -72,6 +79,25 @@ vtkPolyDataContactFilter::vtkPolyDataContactFilter () {
     sourcesA->SetName("sourcesA");
     sourcesB->SetName("sourcesB");
 
+    tileIdsA = nullptr;
+    tileIdsB = nullptr;
+
+    PairSearchTileSize = 0;
+
+    Primitive = nullptr;
+
+    PolyLines = false;
+
+    RefitThreshold = 1.5;
+
+    treeA = new CachedTree;
+    treeB = new CachedTree;
+
+    usedA = nullptr;
+    usedB = nullptr;
+
+    batchSize = VTK_ID_MAX;
+
     SetNumberOfInputPorts(2);
     SetNumberOfOutputPorts(3);
 
@@ -79,6 +105,9 @@ vtkPolyDataContactFilter::vtkPolyDataContactFilter () {
 
 vtkPolyDataContactFilter::~vtkPolyDataContactFilter () {
 
+    delete treeB;
+    delete treeA;
+
     sourcesB->Delete();
     sourcesA->Delete();
 
@@ -91,6 +120,18 @@ vtkPolyDataContactFilter::~vtkPolyDataContactFilter () {
 }
 
 int vtkPolyDataContactFilter::ProcessRequest (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector) {
+    if (Policy != nullptr && request->Has(vtkDemandDrivenPipeline::REQUEST_DATA())) {
+        int ret = 1;
+
+        Policy->Execute([&]() { ret = ExecuteRequest(request, inputVector, outputVector); });
+
+        return ret;
+    }
+
+    return ExecuteRequest(request, inputVector, outputVector);
+}
+
+int vtkPolyDataContactFilter::ExecuteRequest (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector) {
 
     if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA())) {
 
@@ -108,6 +149,30 @@ int vtkPolyDataContactFilter::ProcessRequest (vtkInformation *request, vtkInform
         vtkPolyData *resultB = vtkPolyData::SafeDownCast(outInfoB->Get(vtkDataObject::DATA_OBJECT()));
         vtkPolyData *resultC = vtkPolyData::SafeDownCast(outInfoC->Get(vtkDataObject::DATA_OBJECT()));
 
+        // ergebnisse eines vorherigen durchlaufs verwerfen
+
+        contPts->Reset();
+
+        contLines->Initialize();
+        contLines->SetPoints(contPts);
+        contLines->Allocate(1000);
+
+        contA->Reset();
+        contB->Reset();
+
+        sourcesA->Reset();
+        sourcesB->Reset();
+
+        usedA = nullptr;
+        usedB = nullptr;
+
+        batchSize = VTK_ID_MAX;
+
+        if (Policy != nullptr) {
+            // ein paar mit seinen überlappungen und den schnittpunkten, aus denen sie entstehen
+            batchSize = Policy->GetBatchSize(sizeof(PairType)+sizeof(OverlapsType)+4*sizeof(InterPt), VTK_ID_MAX);
+        }
+
         // durchführung der aufgabe
 
         pdA = vtkPolyData::New();
@@ -125,21 +190,83 @@ int vtkPolyDataContactFilter::ProcessRequest (vtkInformation *request, vtkInform
             return 1;
         }
 
-        // anlegen der obb-trees
+        if (PairSearchTileSize > 0) {
+            InterTiles();
 
-        vtkOBBTree *obbA = vtkOBBTree::New();
-        obbA->SetDataSet(pdA);
-        obbA->SetNumberOfCellsPerNode(1);
-        obbA->BuildLocator();
+        } else {
+            vtkPolyData *nearA = nullptr;
 
-        vtkOBBTree *obbB = vtkOBBTree::New();
-        obbB->SetDataSet(pdB);
-        obbB->SetNumberOfCellsPerNode(1);
-        obbB->BuildLocator();
+            if (Primitive != nullptr) {
+                IdsType ids;
 
-        vtkMatrix4x4 *mat = vtkMatrix4x4::New();
+                vtkIdType i, numCells = pdA->GetNumberOfCells();
 
-        obbA->IntersectWithOBBTree(obbB, mat, InterOBBNodes, this);
+                for (i = 0; i < numCells; i++) {
+                    if (IsNear(i)) {
+                        ids.push_back(static_cast<int>(i));
+                    }
+                }
+
+                tileIdsA = vtkIdList::New();
+                nearA = GetSubset(pdA, ids, tileIdsA);
+            }
+
+            if (nearA == nullptr || nearA->GetNumberOfCells() > 0) {
+                // anlegen der obb-trees
+
+                auto GetTree = [&](CachedTree *cached, vtkPolyData *in, vtkPolyData *pd, RefitOBBTree *&used) {
+                    vtkMTimeType time = std::max(in->GetPolys()->GetMTime(), in->GetStrips()->GetMTime());
+
+                    bool same = SameCells(in, pd);
+
+                    // ein baum, den z.b. ein vorheriger vtkPolyDataBooleanFilter an die eingabe gehängt hat
+                    RefitOBBTree *index = same ? SpatialIndex::Find(in) : nullptr;
+
+                    if (index != nullptr) {
+                        cached->Adopt(index, pd, time);
+                    }
+
+                    RefitOBBTree *obb = cached->Get(pd, time, RefitThreshold);
+
+                    if (same) {
+                        used = obb;
+                    }
+
+                    return obb;
+                };
+
+                vtkSmartPointer<vtkOBBTree> nearTree;
+
+                vtkOBBTree *obbA;
+
+                if (nearA != nullptr) {
+                    nearTree = vtkSmartPointer<vtkOBBTree>::New();
+                    nearTree->SetDataSet(nearA);
+                    nearTree->SetNumberOfCellsPerNode(1);
+                    nearTree->BuildLocator();
+
+                    obbA = nearTree;
+                } else {
+                    obbA = GetTree(treeA, _pdA, pdA, usedA);
+                }
+
+                vtkOBBTree *obbB = GetTree(treeB, _pdB, pdB, usedB);
+
+                vtkMatrix4x4 *mat = vtkMatrix4x4::New();
+
+                obbA->IntersectWithOBBTree(obbB, mat, InterOBBNodes, this);
+                InterPairs();
+
+                mat->Delete();
+            }
+
+            if (nearA != nullptr) {
+                nearA->Delete();
+
+                tileIdsA->Delete();
+                tileIdsA = nullptr;
+            }
+        }
 
         contLines->GetCellData()->AddArray(contA);
         contLines->GetCellData()->AddArray(contB);
@@ -168,12 +295,20 @@ int vtkPolyDataContactFilter::ProcessRequest (vtkInformation *request, vtkInform
         AddMissingLines(resultA);
 
         clean->Delete();
-        mat->Delete();
-        obbB->Delete();
-        obbA->Delete();
 
-        resultB->DeepCopy(pdA);
-        resultC->DeepCopy(pdB);
+        if (PolyLines) {
+            vtkPolyData *polyLines = vtkPolyData::New();
+
+            StitchLines(resultA, polyLines);
+
+            resultA->ShallowCopy(polyLines);
+
+            polyLines->Delete();
+
+        } else {
+            resultB->DeepCopy(pdA);
+            resultC->DeepCopy(pdB);
+        }
 
         pdB->Delete();
         pdA->Delete();
@@ -184,6 +319,206 @@ int vtkPolyDataContactFilter::ProcessRequest (vtkInformation *request, vtkInform
 
 }
 
+bool vtkPolyDataContactFilter::IsNear (vtkIdType idA) {
+    // die bounding-sphere der zelle muss die oberfläche berühren
+
+    double bnds[6], c[3], r = 0;
+
+    pdA->GetCellBounds(idA, bnds);
+
+    for (int i = 0; i < 3; i++) {
+        c[i] = (bnds[2*i]+bnds[2*i+1])/2;
+        r += (bnds[2*i+1]-bnds[2*i])*(bnds[2*i+1]-bnds[2*i]);
+    }
+
+    r = std::sqrt(r)/2;
+
+    return std::abs(Primitive->SignedDistance(c)) <= r+Primitive->GetTolerance()+1e-6;
+}
+
+vtkPolyData* vtkPolyDataContactFilter::GetSubset (vtkPolyData *pd, const IdsType &ids, vtkIdList *map) {
+    // das teilnetz teilt sich die punkte mit der eingabe
+
+    vtkPolyData *sub = vtkPolyData::New();
+    sub->SetPoints(pd->GetPoints());
+    sub->Allocate(ids.size());
+
+    vtkIdType num;
+    const vtkIdType *poly;
+
+    for (int id : ids) {
+        pd->GetCellPoints(id, num, poly);
+        sub->InsertNextCell(pd->GetCellType(id), num, poly);
+        map->InsertNextId(id);
+    }
+
+    return sub;
+}
+
+int vtkPolyDataContactFilter::GetTile (const double *pt) {
+    int i, ind[3];
+
+    for (i = 0; i < 3; i++) {
+        ind[i] = static_cast<int>(std::floor((pt[i]-tileOrigin[i])/tileSize));
+        ind[i] = std::max(0, std::min(ind[i], tileDims[i]-1));
+    }
+
+    return ind[0]+tileDims[0]*(ind[1]+tileDims[1]*ind[2]);
+}
+
+void vtkPolyDataContactFilter::AssignTiles (vtkPolyData *pd, const double *bnds, std::vector<IdsType> &tiles) {
+    vtkIdType i, numCells = pd->GetNumberOfCells();
+
+    double cellBnds[6], lo[3], hi[3];
+
+    int j, x, y, z, a[3], b[3];
+
+    for (i = 0; i < numCells; i++) {
+        pd->GetCellBounds(i, cellBnds);
+
+        bool outside = false;
+
+        for (j = 0; j < 3; j++) {
+            if (cellBnds[2*j] > bnds[2*j+1] || cellBnds[2*j+1] < bnds[2*j]) {
+                outside = true;
+                break;
+            }
+
+            lo[j] = std::max(cellBnds[2*j], bnds[2*j]);
+            hi[j] = std::min(cellBnds[2*j+1], bnds[2*j+1]);
+        }
+
+        // zellen außerhalb der überlappung können keinen kontakt haben
+
+        if (outside || (pd == pdA && Primitive != nullptr && !IsNear(i))) {
+            continue;
+        }
+
+        for (j = 0; j < 3; j++) {
+            a[j] = std::max(0, static_cast<int>(std::floor((lo[j]-tileOrigin[j])/tileSize)));
+            b[j] = std::min(tileDims[j]-1, static_cast<int>(std::floor((hi[j]-tileOrigin[j])/tileSize)));
+        }
+
+        for (z = a[2]; z <= b[2]; z++) {
+            for (y = a[1]; y <= b[1]; y++) {
+                for (x = a[0]; x <= b[0]; x++) {
+                    tiles[x+tileDims[0]*(y+tileDims[1]*z)].push_back(static_cast<int>(i));
+                }
+            }
+        }
+    }
+}
+
+void vtkPolyDataContactFilter::InterTiles () {
+    // der überlappungsbereich der beiden bounding-boxes wird in bricks zerlegt und diese werden einzeln abgearbeitet,
+    // die obb-trees umfassen dadurch immer nur die zellen eines bricks
+
+    double bndsA[6], bndsB[6], bnds[6];
+
+    pdA->GetBounds(bndsA);
+    pdB->GetBounds(bndsB);
+
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        bnds[2*i] = std::max(bndsA[2*i], bndsB[2*i])-1e-6;
+        bnds[2*i+1] = std::min(bndsA[2*i+1], bndsB[2*i+1])+1e-6;
+
+        if (bnds[2*i] > bnds[2*i+1]) {
+            return;
+        }
+
+        tileOrigin[i] = bnds[2*i];
+    }
+
+    // zu kleine bricks würden die anzahl über int hinaus treiben bzw. die listen nicht mehr in den speicher passen,
+    // die kantenlänge wird dann so lange verdoppelt, bis die obergrenze eingehalten ist
+
+    auto GetNumTiles = [&](double size) {
+        double num = 1;
+
+        for (int j = 0; j < 3; j++) {
+            num *= std::max(1., std::ceil((bnds[2*j+1]-bnds[2*j])/size));
+        }
+
+        return num;
+    };
+
+    tileSize = PairSearchTileSize;
+
+    while (GetNumTiles(tileSize) > MAX_TILES) {
+        tileSize *= 2;
+    }
+
+    if (tileSize != PairSearchTileSize) {
+        vtkWarningMacro("PairSearchTileSize " << PairSearchTileSize << " gives more than " << MAX_TILES << " tiles, using " << tileSize << " instead.");
+    }
+
+    for (i = 0; i < 3; i++) {
+        tileDims[i] = std::max(1, static_cast<int>(std::ceil((bnds[2*i+1]-bnds[2*i])/tileSize)));
+    }
+
+    std::size_t numTiles = static_cast<std::size_t>(tileDims[0])*tileDims[1]*tileDims[2];
+
+    std::vector<IdsType> tilesA(numTiles), tilesB(numTiles);
+
+    AssignTiles(pdA, bnds, tilesA);
+    AssignTiles(pdB, bnds, tilesB);
+
+    vtkMatrix4x4 *mat = vtkMatrix4x4::New();
+
+    for (std::size_t t = 0; t < numTiles; t++) {
+        IdsType &idsA = tilesA[t],
+            &idsB = tilesB[t];
+
+        if (!idsA.empty() && !idsB.empty()) {
+            tile = static_cast<int>(t);
+
+            tileIdsA = vtkIdList::New();
+            tileIdsB = vtkIdList::New();
+
+            vtkPolyData *tileA = GetSubset(pdA, idsA, tileIdsA);
+            vtkPolyData *tileB = GetSubset(pdB, idsB, tileIdsB);
+
+            vtkOBBTree *obbA = vtkOBBTree::New();
+            obbA->SetDataSet(tileA);
+            obbA->SetNumberOfCellsPerNode(1);
+            obbA->BuildLocator();
+
+            vtkOBBTree *obbB = vtkOBBTree::New();
+            obbB->SetDataSet(tileB);
+            obbB->SetNumberOfCellsPerNode(1);
+            obbB->BuildLocator();
+
+            obbA->IntersectWithOBBTree(obbB, mat, InterOBBNodes, this);
+            InterPairs();
+
+            obbB->Delete();
+            obbA->Delete();
+
+            tileIdsB->Delete();
+            tileIdsA->Delete();
+
+            tileB->Delete();
+            tileA->Delete();
+
+            tileIdsA = nullptr;
+            tileIdsB = nullptr;
+        }
+
+        IdsType().swap(idsA);
+        IdsType().swap(idsB);
+    }
+
+    mat->Delete();
+
+}
+
+bool vtkPolyDataContactFilter::SameCells (vtkPolyData *pd, vtkPolyData *prepared) {
+    // ohne strips und andere zellen bleiben die ids bei PreparePolyData erhalten
+    return pd->GetNumberOfPolys() == pd->GetNumberOfCells() && prepared->GetNumberOfCells() == pd->GetNumberOfCells();
+}
+
 void vtkPolyDataContactFilter::PreparePolyData (vtkPolyData *pd) {
 
     pd->GetCellData()->Initialize();
@@ -252,83 +587,51 @@ void vtkPolyDataContactFilter::PreparePolyData (vtkPolyData *pd) {
 
 }
 
-void vtkPolyDataContactFilter::InterEdgeLine (InterPtsType &interPts, const double *eA, const double *eB, const double *r, const double *ptA) {
-
-    double ptB[3];
-    vtkMath::Add(ptA, r, ptB);
-
-    // richtungsvektor der kante bestimmen
-
-    double e[3];
-    vtkMath::Subtract(eB, eA, e);
-    double l = vtkMath::Normalize(e);
-
-    double p[3];
-    vtkMath::Subtract(eA, ptA, p);
-
-    double w = std::abs(vtkMath::Determinant3x3(r, e, p));
+void vtkPolyDataContactFilter::InterEdgeLine (InterPtsType &interPts, const double *eA, const double *eB, double dA, double dB, const double *r, const double *pt) {
 
-    if (w < 1e-4) { // ~89.995deg
-        // schnittpunkt ermitteln
+    // dA und dB sind die abstände der endpunkte von der geraden, 0 bedeutet auf der geraden
 
-        double v[3];
-        vtkMath::Cross(r, e, v);
+    double p[3], t;
 
-        double n = vtkMath::Norm(v);
+    if (dA == 0 && dB == 0) {
+        // kollinear
 
-        if (n > 1e-4) { // ~0.0057deg
-
-            double s = vtkMath::Determinant3x3(p, r, v)/(n*n);
-
-            if (s > -1e-6 && s < l+1e-6) {
-                double t = vtkMath::Determinant3x3(p, e, v)/(n*n);
+#ifdef DEBUG
+        std::cout << "congruent lines" << std::endl;
+#endif
 
-                vtkIdType end {NO_USE};
+        vtkMath::Subtract(eA, pt, p);
+        t = vtkMath::Dot(p, r);
 
-                if (s > -1e-6 && s < 1e-6) {
-                    end = 0;
-                } else if (s > l-1e-6 && s < l+1e-6) {
-                    end = 1;
-                }
+        interPts.emplace_back(t, 0, pt[0]+t*r[0], pt[1]+t*r[1], pt[2]+t*r[2]);
 
-                interPts.emplace_back(t, end, ptA[0]+t*r[0], ptA[1]+t*r[1], ptA[2]+t*r[2]);
+        vtkMath::Subtract(eB, pt, p);
+        t = vtkMath::Dot(p, r);
 
-            }
+        interPts.emplace_back(t, 1, pt[0]+t*r[0], pt[1]+t*r[1], pt[2]+t*r[2]);
 
-        } else {
-            // parallel
+    } else if (dA == 0 || dB == 0) {
+        // ein endpunkt liegt auf der geraden
 
-            double vA[3], vB[3], cA[3], cB[3], dA, dB;
+        vtkIdType end = dA == 0 ? 0 : 1;
 
-            vtkMath::Subtract(eA, ptA, vA);
-            vtkMath::Subtract(eA, ptB, vB);
-            vtkMath::Cross(vA, vB, cA);
+        vtkMath::Subtract(end == 0 ? eA : eB, pt, p);
+        t = vtkMath::Dot(p, r);
 
-            double dotA = vtkMath::Dot(vA, r);
+        interPts.emplace_back(t, end, pt[0]+t*r[0], pt[1]+t*r[1], pt[2]+t*r[2]);
 
-            vtkMath::Subtract(eB, ptA, vA);
-            vtkMath::Subtract(eB, ptB, vB);
-            vtkMath::Cross(vA, vB, cB);
+    } else if (std::signbit(dA) != std::signbit(dB)) {
+        // echter schnitt
 
-            double dotB = vtkMath::Dot(vA, r);
+        double s = dA/(dA-dB);
 
-            dA = vtkMath::Norm(cA);
-            dB = vtkMath::Norm(cB);
+        double q[] = {eA[0]+s*(eB[0]-eA[0]), eA[1]+s*(eB[1]-eA[1]), eA[2]+s*(eB[2]-eA[2])};
 
-            if (dA < 1e-4 || dB < 1e-4) {
-#ifdef DEBUG
-                std::cout << "congruent lines with d (" << dA << ", " << dB << ") and t (" << dotA << ", " << dotB << ") and l " << l << std::endl;
-#endif
+        vtkMath::Subtract(q, pt, p);
+        t = vtkMath::Dot(p, r);
 
-                interPts.emplace_back(dotA, 0, ptA[0]+dotA*r[0], ptA[1]+dotA*r[1], ptA[2]+dotA*r[2]);
-                interPts.emplace_back(dotB, 1, ptA[0]+dotB*r[0], ptA[1]+dotB*r[1], ptA[2]+dotB*r[2]);
+        interPts.emplace_back(t, NO_USE, pt[0]+t*r[0], pt[1]+t*r[1], pt[2]+t*r[2]);
 
-            }
-
-        }
-
-    } else {
-        // windschief
     }
 
 }
@@ -341,15 +644,57 @@ void vtkPolyDataContactFilter::InterPolyLine (InterPtsType &interPts, vtkPolyDat
 
     InterPtsType interPtsA;
 
-    // durchläuft die kanten und ermittelt die schnittpunkte
-
     double ptA[3],
         ptB[3],
         dA,
         dB;
 
+    // die seite jedes punkts wird genau einmal bestimmt, benachbarte kanten sehen ihren gemeinsamen punkt daher immer auf derselben seite
+    //
+    // das vorzeichen kommt von Orient3d und ist exakt, der betrag ist der abstand von der geraden in der ebene des polygons
+
+    double ptR[3], ptN[3], m[3], v[3];
+    vtkMath::Add(pt, r, ptR);
+    vtkMath::Add(pt, n, ptN);
+    vtkMath::Cross(r, n, m);
+
+    std::vector<double> dists(num), sides(num);
+
     vtkIdType i, j;
 
+    for (i = 0; i < num; i++) {
+        pd->GetPoint(poly[i], ptA);
+
+        double o = Orient3d(pt, ptR, ptN, ptA);
+
+        vtkMath::Subtract(ptA, pt, v);
+        double d = std::abs(vtkMath::Dot(v, m));
+
+        dists[i] = o > 0 ? d : -d;
+
+        // liegt exakt auf der geraden, oder wird unabhängig davon auf sie gezogen
+        sides[i] = o == 0 || d < SNAP_TOL ? 0 : dists[i];
+    }
+
+    // beide punkte einer nahezu parallelen kante, die näher als 1e-4 an der geraden liegt, kommen ebenfalls auf die
+    // gerade, wie zuvor bei den kongruenten geraden
+
+    for (i = 0; i < num; i++) {
+        j = i == num-1 ? 0 : i+1;
+
+        pd->GetPoint(poly[i], ptA);
+        pd->GetPoint(poly[j], ptB);
+
+        if (std::abs(dists[i]) < 1e-4 && std::abs(dists[j]) < 1e-4
+            && std::abs(dists[i]-dists[j]) < 1e-4*std::sqrt(vtkMath::Distance2BetweenPoints(ptA, ptB))) {
+
+            sides[i] = 0;
+            sides[j] = 0;
+        }
+    }
+
+    // durchläuft die kanten und ermittelt die schnittpunkte
+
     for (i = 0; i < num; i++) {
         j = i == num-1 ? 0 : i+1;
 
@@ -364,7 +709,7 @@ void vtkPolyDataContactFilter::InterPolyLine (InterPtsType &interPts, vtkPolyDat
         // schnittpunkt
 
         InterPtsType interPtsB;
-        vtkPolyDataContactFilter::InterEdgeLine(interPtsB, ptA, ptB, r, pt);
+        vtkPolyDataContactFilter::InterEdgeLine(interPtsB, ptA, ptB, sides[i], sides[j], r, pt);
 
         for (InterPt &p : interPtsB) {
             p.src = src;
@@ -531,17 +876,19 @@ void vtkPolyDataContactFilter::InterPolyLine (InterPtsType &interPts, vtkPolyDat
 
 }
 
-void vtkPolyDataContactFilter::InterPolys (vtkIdType idA, vtkIdType idB) {
+void vtkPolyDataContactFilter::InterPolys (vtkIdType idA, vtkIdType idB, OverlapsType &overlaps, vtkIdList *cellA, vtkIdList *cellB) {
 
 #ifdef DEBUG
     std::cout << "InterPolys() -> idA " << idA << ", idB " << idB << std::endl;
 #endif
 
+    // läuft in mehreren threads gleichzeitig, daher die variante mit den eigenen listen
+
     vtkIdType numA, numB;
     const vtkIdType *polyA, *polyB;
 
-    pdA->GetCellPoints(idA, numA, polyA);
-    pdB->GetCellPoints(idB, numB, polyB);
+    pdA->GetCellPoints(idA, numA, polyA, cellA);
+    pdB->GetCellPoints(idB, numB, polyB, cellB);
 
     // ebenen aufstellen
 
@@ -616,42 +963,106 @@ void vtkPolyDataContactFilter::InterPolys (vtkIdType idA, vtkIdType idB) {
         if (intersA.size() != 0 && intersB.size() != 0
             && intersA.size()%2 == 0 && intersB.size()%2 == 0) {
 
-            OverlapsType overlaps;
             vtkPolyDataContactFilter::OverlapLines(overlaps, intersA, intersB);
 
-            OverlapsType::const_iterator itr;
+        }
+
+    }
+
+}
+
+void vtkPolyDataContactFilter::AddLines (vtkIdType idA, vtkIdType idB, const OverlapsType &overlaps) {
 
-            for (itr = overlaps.begin(); itr != overlaps.end(); ++itr) {
+    OverlapsType::const_iterator itr;
 
-                auto &f = itr->first,
-                    &s = itr->second;
+    for (itr = overlaps.begin(); itr != overlaps.end(); ++itr) {
+
+        auto &f = itr->first,
+            &s = itr->second;
 
 #ifdef DEBUG
-                std::cout << "f " << f << std::endl;
-                std::cout << "s " << s << std::endl;
+        std::cout << "f " << f << std::endl;
+        std::cout << "s " << s << std::endl;
 #endif
 
-                vtkIdList *linePts = vtkIdList::New();
+        vtkIdList *linePts = vtkIdList::New();
+
+        linePts->InsertNextId(contPts->InsertNextPoint(f.pt));
+        linePts->InsertNextId(contPts->InsertNextPoint(s.pt));
+
+        contLines->InsertNextCell(VTK_LINE, linePts);
+
+        sourcesA->InsertNextTuple2(f.srcA, s.srcA);
+        sourcesB->InsertNextTuple2(f.srcB, s.srcB);
+
+        linePts->Delete();
+
+        contA->InsertNextValue(idA);
+        contB->InsertNextValue(idB);
+
+    }
+
+}
+
+void vtkPolyDataContactFilter::InterPairs () {
+    vtkIdType numPairs = static_cast<vtkIdType>(pairs.size());
 
-                linePts->InsertNextId(contPts->InsertNextPoint(f.pt));
-                linePts->InsertNextId(contPts->InsertNextPoint(s.pt));
+    if (numPairs == 0) {
+        return;
+    }
 
-                contLines->InsertNextCell(VTK_LINE, linePts);
+    vtkIdType grain = Policy != nullptr ? Policy->GetPairGrain() : 0;
 
-                sourcesA->InsertNextTuple2(f.srcA, s.srcA);
-                sourcesB->InsertNextTuple2(f.srcB, s.srcB);
+    if (Policy == nullptr || Policy->GetDeterministic()) {
+        // jedes paar hat seinen platz, übernommen wird in der reihenfolge, in der die paare gefunden wurden
 
-                linePts->Delete();
+        std::vector<OverlapsType> results(numPairs);
 
-                contA->InsertNextValue(idA);
-                contB->InsertNextValue(idB);
+        vtkBooleanExecutionPolicy::For(0, numPairs, grain, [&](vtkIdType first, vtkIdType last) {
+            vtkSmartPointer<vtkIdList> cellA = vtkSmartPointer<vtkIdList>::New(),
+                cellB = vtkSmartPointer<vtkIdList>::New();
 
+            for (vtkIdType i = first; i < last; i++) {
+                InterPolys(pairs[i].first, pairs[i].second, results[i], cellA, cellB);
             }
+        });
 
+        for (vtkIdType i = 0; i < numPairs; i++) {
+            AddLines(pairs[i].first, pairs[i].second, results[i]);
         }
 
+    } else {
+        typedef std::vector<std::pair<PairType, OverlapsType>> ResultsType;
+
+        vtkSMPThreadLocal<ResultsType> results;
+
+        vtkBooleanExecutionPolicy::For(0, numPairs, grain, [&](vtkIdType first, vtkIdType last) {
+            vtkSmartPointer<vtkIdList> cellA = vtkSmartPointer<vtkIdList>::New(),
+                cellB = vtkSmartPointer<vtkIdList>::New();
+
+            ResultsType &local = results.Local();
+
+            OverlapsType overlaps;
+
+            for (vtkIdType i = first; i < last; i++) {
+                InterPolys(pairs[i].first, pairs[i].second, overlaps, cellA, cellB);
+
+                if (!overlaps.empty()) {
+                    local.emplace_back(pairs[i], std::move(overlaps));
+                    overlaps.clear();
+                }
+            }
+        });
+
+        for (ResultsType &local : results) {
+            for (auto &res : local) {
+                AddLines(res.first.first, res.first.second, res.second);
+            }
+        }
     }
 
+    PairsType().swap(pairs);
+
 }
 
 void vtkPolyDataContactFilter::OverlapLines (OverlapsType &ols, InterPtsType &intersA, InterPtsType &intersB) {
@@ -851,6 +1262,144 @@ void vtkPolyDataContactFilter::AddMissingLines (vtkPolyData *lines) {
     // wenn es jetzt noch punkte ohne mind. zwei linien gibt, dann wird der fehler im boolean-filter abgefangen
 }
 
+void vtkPolyDataContactFilter::StitchLines (vtkPolyData *lines, vtkPolyData *polyLines) {
+    vtkIntArray *_contA = vtkIntArray::SafeDownCast(lines->GetCellData()->GetScalars("cA"));
+    vtkIntArray *_contB = vtkIntArray::SafeDownCast(lines->GetCellData()->GetScalars("cB"));
+
+    vtkDataArray *origCellIdsA = pdA->GetCellData()->GetScalars("OrigCellIds");
+    vtkDataArray *origCellIdsB = pdB->GetCellData()->GetScalars("OrigCellIds");
+
+    vtkIdType i, numLines = lines->GetNumberOfCells(),
+        numPts = lines->GetNumberOfPoints();
+
+    // nachbarschaft selbst aufbauen, die links sind nach AddMissingLines nicht mehr aktuell
+
+    std::vector<std::vector<vtkIdType>> neighs(numPts);
+    std::vector<std::pair<vtkIdType, vtkIdType>> ends(numLines, {NO_USE, NO_USE});
+
+    vtkIdType num;
+    const vtkIdType *line;
+
+    for (i = 0; i < numLines; i++) {
+        if (lines->GetCellType(i) != VTK_LINE) {
+            continue;
+        }
+
+        lines->GetCellPoints(i, num, line);
+
+        ends[i] = {line[0], line[1]};
+
+        neighs[line[0]].push_back(i);
+        neighs[line[1]].push_back(i);
+    }
+
+    vtkPoints *pts = vtkPoints::New();
+    pts->SetDataTypeToDouble();
+
+    vtkCellArray *cells = vtkCellArray::New();
+
+    vtkIntArray *newIdsA = vtkIntArray::New();
+    newIdsA->SetName("OrigCellIdsA");
+
+    vtkIntArray *newIdsB = vtkIntArray::New();
+    newIdsB->SetName("OrigCellIdsB");
+
+    vtkIntArray *closed = vtkIntArray::New();
+    closed->SetName("Closed");
+
+    std::vector<bool> visited(numLines, false);
+
+    std::vector<vtkIdType> chain, segs;
+
+    auto Walk = [&] (vtkIdType start, vtkIdType lineId) {
+        chain.clear();
+        segs.clear();
+
+        chain.push_back(start);
+
+        vtkIdType pt = start;
+
+        for (;;) {
+            visited[lineId] = true;
+            segs.push_back(lineId);
+
+            pt = ends[lineId].first == pt ? ends[lineId].second : ends[lineId].first;
+            chain.push_back(pt);
+
+            if (pt == start || neighs[pt].size() != 2) {
+                break;
+            }
+
+            lineId = neighs[pt][0] == lineId ? neighs[pt][1] : neighs[pt][0];
+
+            if (visited[lineId]) {
+                break;
+            }
+        }
+
+        bool isClosed = chain.size() > 2 && chain.back() == chain.front();
+
+        std::size_t j, numChain = chain.size()-(isClosed ? 1 : 0);
+
+        vtkIdType first = pts->GetNumberOfPoints();
+
+        cells->InsertNextCell(static_cast<int>(chain.size()));
+
+        for (j = 0; j < numChain; j++) {
+            pts->InsertNextPoint(lines->GetPoint(chain[j]));
+
+            // der letzte punkt eines offenen zugs übernimmt die zellen des letzten segments
+            vtkIdType seg = segs[std::min(j, segs.size()-1)];
+
+            newIdsA->InsertNextValue(static_cast<int>(origCellIdsA->GetTuple1(_contA->GetValue(seg))));
+            newIdsB->InsertNextValue(static_cast<int>(origCellIdsB->GetTuple1(_contB->GetValue(seg))));
+
+            cells->InsertCellPoint(first+j);
+        }
+
+        if (isClosed) {
+            cells->InsertCellPoint(first);
+        }
+
+        closed->InsertNextValue(isClosed ? 1 : 0);
+    };
+
+    // zuerst die offenen züge, sie beginnen an enden oder verzweigungen
+
+    for (i = 0; i < numPts; i++) {
+        if (neighs[i].size() != 2) {
+            for (vtkIdType lineId : neighs[i]) {
+                if (!visited[lineId]) {
+                    Walk(i, lineId);
+                }
+            }
+        }
+    }
+
+    // übrig sind geschlossene schleifen
+
+    for (i = 0; i < numLines; i++) {
+        if (!visited[i] && ends[i].first != NO_USE) {
+            Walk(ends[i].first, i);
+        }
+    }
+
+    polyLines->SetPoints(pts);
+    polyLines->SetLines(cells);
+
+    polyLines->GetPointData()->AddArray(newIdsA);
+    polyLines->GetPointData()->AddArray(newIdsB);
+
+    polyLines->GetCellData()->AddArray(closed);
+
+    closed->Delete();
+    newIdsB->Delete();
+    newIdsA->Delete();
+    cells->Delete();
+    pts->Delete();
+
+}
+
 int vtkPolyDataContactFilter::InterOBBNodes (vtkOBBNode *nodeA, vtkOBBNode *nodeB, vtkMatrix4x4 *vtkNotUsed(mat), void *caller) {
     vtkPolyDataContactFilter *self = reinterpret_cast<vtkPolyDataContactFilter*>(caller);
 
@@ -862,15 +1411,45 @@ int vtkPolyDataContactFilter::InterOBBNodes (vtkOBBNode *nodeA, vtkOBBNode *node
 
     vtkIdType i, j, ci, cj;
 
+    double bndsA[6], bndsB[6], pt[3];
+
+    int k;
+
     for (i = 0; i < numCellsA; i++) {
         ci = cellsA->GetId(i);
 
+        if (self->tileIdsA != nullptr) {
+            ci = self->tileIdsA->GetId(ci);
+            self->pdA->GetCellBounds(ci, bndsA);
+        }
+
         for (j = 0; j < numCellsB; j++) {
             cj = cellsB->GetId(j);
 
-            self->InterPolys(ci, cj);
+            if (self->tileIdsB != nullptr) {
+                cj = self->tileIdsB->GetId(cj);
+                self->pdB->GetCellBounds(cj, bndsB);
+
+                // ein paar, das in mehreren bricks liegt, wird nur in dem brick geschnitten, der die untere ecke der gemeinsamen bounding-box enthält
+
+                for (k = 0; k < 3; k++) {
+                    pt[k] = std::max(bndsA[2*k], bndsB[2*k]);
+                }
+
+                if (self->GetTile(pt) != self->tile) {
+                    continue;
+                }
+            }
+
+            self->pairs.emplace_back(ci, cj);
         }
     }
 
+    // die paare werden gesammelt und gemeinsam geschnitten, mit einem budget in runden
+
+    if (static_cast<vtkIdType>(self->pairs.size()) >= self->batchSize) {
+        self->InterPairs();
+    }
+
     return 0;
 }
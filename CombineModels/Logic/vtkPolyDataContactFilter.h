@@ -18,15 +18,21 @@ limitations under the License.
 #define __vtkPolyDataContactFilter_h
 
 #include <map>
+#include <vector>
 
 #include "vtkSlicerCombineModelsModuleLogicExport.h"
 
 #include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
 
 #include "Utilities.h"
+#include "vtkBooleanExecutionPolicy.h"
 
 class vtkOBBNode;
+class CachedTree;
+class RefitOBBTree;
 class vtkMatrix4x4;
+class vtkBooleanPrimitive;
 
 enum class Src {
     A = 1,
@@ -97,16 +103,31 @@ public:
 
 typedef std::map<Pair, std::vector<LonePt>> LonePtsType;
 
-class VTK_EXPORT vtkPolyDataContactFilter : public vtkPolyDataAlgorithm {
+class VTK_SLICER_COMBINEMODELS_MODULE_LOGIC_EXPORT vtkPolyDataContactFilter : public vtkPolyDataAlgorithm {
 
     void PreparePolyData (vtkPolyData *pd);
+    static bool SameCells (vtkPolyData *pd, vtkPolyData *prepared);
 
-    static void InterEdgeLine (InterPtsType &interPts, const double *eA, const double *eB, const double *r, const double *pt);
+    static void InterEdgeLine (InterPtsType &interPts, const double *eA, const double *eB, double dA, double dB, const double *r, const double *pt);
     static void InterPolyLine (InterPtsType &interPts, vtkPolyData *pd, vtkIdType num, const vtkIdType *poly, const double *r, const double *pt, Src src, const double *n);
-    void InterPolys (vtkIdType idA, vtkIdType idB);
+    void InterPolys (vtkIdType idA, vtkIdType idB, OverlapsType &overlaps, vtkIdList *cellA, vtkIdList *cellB);
+    void AddLines (vtkIdType idA, vtkIdType idB, const OverlapsType &overlaps);
+    void InterPairs ();
     static void OverlapLines (OverlapsType &ols, InterPtsType &intersA, InterPtsType &intersB);
 
     void AddMissingLines (vtkPolyData *lines);
+    void StitchLines (vtkPolyData *lines, vtkPolyData *polyLines);
+
+    void InterTiles ();
+    void AssignTiles (vtkPolyData *pd, const double *bnds, std::vector<IdsType> &tiles);
+    int GetTile (const double *pt);
+
+    vtkPolyData* GetSubset (vtkPolyData *pd, const IdsType &ids, vtkIdList *map);
+    bool IsNear (vtkIdType idA);
+
+    vtkIdList *tileIdsA, *tileIdsB;
+    int tileDims[3], tile;
+    double tileOrigin[3], tileSize;
 
     vtkIntArray *contA, *contB;
 
@@ -117,18 +138,75 @@ class VTK_EXPORT vtkPolyDataContactFilter : public vtkPolyDataAlgorithm {
 
     vtkIntArray *sourcesA, *sourcesB;
 
+    double PairSearchTileSize;
+
+    vtkBooleanPrimitive *Primitive;
+
+    bool PolyLines;
+
+    double RefitThreshold;
+
+    CachedTree *treeA, *treeB;
+
+    RefitOBBTree *usedA, *usedB;
+
+    vtkSmartPointer<vtkBooleanExecutionPolicy> Policy;
+
+    typedef std::pair<vtkIdType, vtkIdType> PairType;
+    typedef std::vector<PairType> PairsType;
+
+    PairsType pairs;
+    vtkIdType batchSize;
+
 public:
     vtkTypeMacro(vtkPolyDataContactFilter, vtkPolyDataAlgorithm);
 
     static vtkPolyDataContactFilter* New();
 
+    // kantenlänge der bricks, in die der überlappungsbereich für die suche nach zellpaaren zerlegt wird; 0 schaltet das aus
+    //
+    // zerlegt wird nur die paarsuche, die obb-trees umfassen dann jeweils die zellen eines bricks; die eingaben und
+    // die outputs liegen weiterhin vollständig im speicher, dazu kommen die kopien der zellen des aktuellen bricks,
+    // der speicherbedarf sinkt also nicht; ergäbe die kantenlänge mehr als 262144 bricks, wird sie verdoppelt, bis es passt
+    vtkSetMacro(PairSearchTileSize, double);
+    vtkGetMacro(PairSearchTileSize, double);
+
+    // ist B ein primitiv, werden nur die zellen von A untersucht, die seiner oberfläche nahe kommen; geschnitten wird
+    // weiterhin mit der vernetzung in B
+    void SetPrimitive (vtkBooleanPrimitive *prim) { Primitive = prim; Modified(); }
+
+    // liefert statt einzelner linien geordnete polylinien mit den OrigCellIds beider eingaben je punkt,
+    // die outputs 1 und 2 bleiben dann leer
+    vtkSetMacro(PolyLines, bool);
+    vtkGetMacro(PolyLines, bool);
+    vtkBooleanMacro(PolyLines, bool);
+
+    // die obb-trees bleiben zwischen den durchläufen erhalten, ändern sich nur die koordinaten der punkte,
+    // werden sie angepasst statt neu aufgebaut; wachsen ihre knoten dabei um mehr als diesen faktor, wird neu aufgebaut,
+    // 0 baut immer neu auf
+    vtkSetClampMacro(RefitThreshold, double, 0, VTK_DOUBLE_MAX);
+    vtkGetMacro(RefitThreshold, double);
+
+    // threads, backend und körnung der parallelen schritte, nullptr nimmt die globalen einstellungen von vtkSMPTools
+    void SetPolicy (vtkBooleanExecutionPolicy *policy) { Policy = policy; Modified(); }
+    vtkBooleanExecutionPolicy* GetPolicy () { return Policy; }
+
     static int InterOBBNodes (vtkOBBNode *nodeA, vtkOBBNode *nodeB, vtkMatrix4x4 *mat, void *caller);
 
+#ifndef __VTK_WRAP__
+    // die bäume des letzten durchlaufs über den zellen der eingaben, nullptr bei PairSearchTileSize oder für A neben einem primitiv
+    //
+    // hat eine eingabe einen baum über SpatialIndex, wird er übernommen statt neu aufgebaut
+    RefitOBBTree* GetTreeA () { return usedA; }
+    RefitOBBTree* GetTreeB () { return usedB; }
+#endif
+
 protected:
     vtkPolyDataContactFilter ();
     ~vtkPolyDataContactFilter ();
 
     int ProcessRequest (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector);
+    int ExecuteRequest (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector);
 
     void PrintSelf (ostream&, vtkIndent) override {};
 
@@ -0,0 +1,293 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cmath>
+#include <algorithm>
+#include <queue>
+
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPolyData.h>
+#include <vtkCellArray.h>
+#include <vtkPoints.h>
+#include <vtkIdList.h>
+#include <vtkMath.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkPolyDataProximityFilter.h"
+#include "RefitOBBTree.h"
+#include "ClosestPoints.h"
+#include "Utilities.h"
+
+namespace {
+
+void GetTri (vtkPolyData *pd, vtkIdType cellId, TriType &tri) {
+    vtkIdType num;
+    const vtkIdType *poly;
+
+    pd->GetCellPoints(cellId, num, poly);
+
+    for (int i = 0; i < 3; i++) {
+        pd->GetPoint(poly[i], tri[i]);
+    }
+}
+
+class NodePair {
+public:
+    NodePair (double _lb, vtkOBBNode *_a, vtkOBBNode *_b) : lb(_lb), a(_a), b(_b) {}
+
+    double lb;
+    vtkOBBNode *a, *b;
+
+    // kleinste schranke zuerst
+    bool operator< (const NodePair &other) const { return lb > other.lb; }
+};
+
+double Closest (vtkPolyData *pdA, vtkOBBNode *rootA, vtkPolyData *pdB, vtkOBBNode *rootB, double stop, double *ptA, double *ptB) {
+    double best = VTK_DOUBLE_MAX;
+
+    std::priority_queue<NodePair> queue;
+    queue.emplace(LowerBound(Box(rootA), Box(rootB)), rootA, rootB);
+
+    TriType triA, triB;
+
+    double cA[3], cB[3];
+
+    vtkIdType i, j;
+
+    while (!queue.empty()) {
+        NodePair pair = queue.top();
+        queue.pop();
+
+        if (pair.lb >= best) {
+            // alle übrigen paare sind mindestens so weit entfernt
+            break;
+        }
+
+        bool leafA = pair.a->Kids == nullptr,
+            leafB = pair.b->Kids == nullptr;
+
+        if (leafA && leafB) {
+            if (pair.a->Cells == nullptr || pair.b->Cells == nullptr) {
+                continue;
+            }
+
+            for (i = 0; i < pair.a->Cells->GetNumberOfIds(); i++) {
+                GetTri(pdA, pair.a->Cells->GetId(i), triA);
+
+                for (j = 0; j < pair.b->Cells->GetNumberOfIds(); j++) {
+                    GetTri(pdB, pair.b->Cells->GetId(j), triB);
+
+                    double d = TriTriDistance(triA, triB, cA, cB);
+
+                    if (d < best) {
+                        best = d;
+
+                        std::copy_n(cA, 3, ptA);
+                        std::copy_n(cB, 3, ptB);
+
+                        if (best <= stop) {
+                            return best;
+                        }
+                    }
+                }
+            }
+
+        } else if (leafB || (!leafA && NodeSize(pair.a) >= NodeSize(pair.b))) {
+            Box b(pair.b);
+
+            for (int k = 0; k < 2; k++) {
+                double lb = LowerBound(Box(pair.a->Kids[k]), b);
+
+                if (lb < best) {
+                    queue.emplace(lb, pair.a->Kids[k], pair.b);
+                }
+            }
+
+        } else {
+            Box a(pair.a);
+
+            for (int k = 0; k < 2; k++) {
+                double lb = LowerBound(a, Box(pair.b->Kids[k]));
+
+                if (lb < best) {
+                    queue.emplace(lb, pair.a, pair.b->Kids[k]);
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+double ClosestToPoint (vtkPolyData *pd, vtkOBBNode *root, const double *p, double *q) {
+    double best = VTK_DOUBLE_MAX;
+
+    std::priority_queue<NodePair> queue;
+    queue.emplace(LowerBound(p, Box(root)), root, nullptr);
+
+    TriType tri;
+
+    double c[3];
+
+    while (!queue.empty()) {
+        NodePair pair = queue.top();
+        queue.pop();
+
+        if (pair.lb >= best) {
+            break;
+        }
+
+        if (pair.a->Kids == nullptr) {
+            if (pair.a->Cells == nullptr) {
+                continue;
+            }
+
+            for (vtkIdType i = 0; i < pair.a->Cells->GetNumberOfIds(); i++) {
+                GetTri(pd, pair.a->Cells->GetId(i), tri);
+
+                ClosestPtTri(p, tri[0], tri[1], tri[2], c);
+
+                double d = std::sqrt(vtkMath::Distance2BetweenPoints(p, c));
+
+                if (d < best) {
+                    best = d;
+                    std::copy_n(c, 3, q);
+                }
+            }
+
+        } else {
+            for (int k = 0; k < 2; k++) {
+                double lb = LowerBound(p, Box(pair.a->Kids[k]));
+
+                if (lb < best) {
+                    queue.emplace(lb, pair.a->Kids[k], nullptr);
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+
+}
+
+vtkStandardNewMacro(vtkPolyDataProximityFilter);
+
+vtkPolyDataProximityFilter::vtkPolyDataProximityFilter () {
+
+    SetNumberOfInputPorts(2);
+    SetNumberOfOutputPorts(1);
+
+    Distance = 0;
+
+    PointA[0] = PointA[1] = PointA[2] = 0;
+    PointB[0] = PointB[1] = PointB[2] = 0;
+
+    StopDistance = 0;
+    RefitThreshold = 1.5;
+
+    treeA = new CachedTree;
+    treeB = new CachedTree;
+
+}
+
+vtkPolyDataProximityFilter::~vtkPolyDataProximityFilter () {
+    delete treeB;
+    delete treeA;
+}
+
+int vtkPolyDataProximityFilter::RequestData (vtkInformation *vtkNotUsed(request), vtkInformationVector **inputVector, vtkInformationVector *outputVector) {
+
+    vtkInformation *inInfoA = inputVector[0]->GetInformationObject(0);
+    vtkInformation *inInfoB = inputVector[1]->GetInformationObject(0);
+
+    vtkPolyData *pdA = vtkPolyData::SafeDownCast(inInfoA->Get(vtkDataObject::DATA_OBJECT()));
+    vtkPolyData *pdB = vtkPolyData::SafeDownCast(inInfoB->Get(vtkDataObject::DATA_OBJECT()));
+
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData *output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    vtkSmartPointer<vtkPolyData> trisA = vtkSmartPointer<vtkPolyData>::New(),
+        trisB = vtkSmartPointer<vtkPolyData>::New();
+
+    Triangulate(pdA, trisA);
+    Triangulate(pdB, trisB);
+
+    if (trisA->GetNumberOfCells() == 0 || trisB->GetNumberOfCells() == 0) {
+        vtkErrorMacro("One of the inputs does not contain any polygons.");
+
+        return 1;
+    }
+
+    RefitOBBTree *obbA = treeA->Get(trisA, std::max(pdA->GetPolys()->GetMTime(), pdA->GetStrips()->GetMTime()), RefitThreshold);
+    RefitOBBTree *obbB = treeB->Get(trisB, std::max(pdB->GetPolys()->GetMTime(), pdB->GetStrips()->GetMTime()), RefitThreshold);
+
+    Distance = Closest(trisA, obbA->GetRoot(), trisB, obbB->GetRoot(), StopDistance, PointA, PointB);
+
+    if (Distance == 0) {
+        // die oberflächen schneiden sich, gesucht ist der am tiefsten in der anderen oberfläche liegende knoten; die
+        // tiefste stelle einer durchdringung kann auch auf einer kante liegen, das bleibt unberücksichtigt
+
+        double vertexDepth = 0, pt[3], q[3], bnds[6];
+
+        auto Penetrate = [&](vtkPolyData *pd, vtkPolyData *other, RefitOBBTree *obb, double *ptSelf, double *ptOther) {
+            other->GetBounds(bnds);
+
+            for (vtkIdType i = 0; i < pd->GetNumberOfPoints(); i++) {
+                pd->GetPoint(i, pt);
+
+                if (pt[0] < bnds[0] || pt[0] > bnds[1] || pt[1] < bnds[2] || pt[1] > bnds[3] || pt[2] < bnds[4] || pt[2] > bnds[5]) {
+                    continue;
+                }
+
+                if (obb->InsideOrOutside(pt) != -1) {
+                    continue;
+                }
+
+                double d = ClosestToPoint(other, obb->GetRoot(), pt, q);
+
+                if (d > vertexDepth) {
+                    vertexDepth = d;
+
+                    std::copy_n(pt, 3, ptSelf);
+                    std::copy_n(q, 3, ptOther);
+                }
+            }
+        };
+
+        Penetrate(trisA, trisB, obbB, PointA, PointB);
+        Penetrate(trisB, trisA, obbA, PointB, PointA);
+
+        Distance = -vertexDepth;
+    }
+
+    vtkPoints *pts = vtkPoints::New();
+    pts->SetDataTypeToDouble();
+    pts->InsertNextPoint(PointA);
+    pts->InsertNextPoint(PointB);
+
+    vtkIdType line[] = {0, 1};
+
+    output->Allocate(1);
+    output->SetPoints(pts);
+    output->InsertNextCell(VTK_LINE, 2, line);
+
+    pts->Delete();
+
+    return 1;
+
+}
@@ -0,0 +1,82 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __vtkPolyDataProximityFilter_h
+#define __vtkPolyDataProximityFilter_h
+
+#include "vtkSlicerCombineModelsModuleLogicExport.h"
+
+#include <vtkPolyDataAlgorithm.h>
+
+class CachedTree;
+
+// kleinster abstand zweier oberflächen, bzw. die größte tiefe eines knotens in der anderen oberfläche, wenn sie sich
+// schneiden
+//
+// die knotenpaare der obb-trees beider eingaben werden nach ihrer unteren schranke abgearbeitet, paare,
+// deren schranke nicht unter dem bisher besten abstand liegt, entfallen
+//
+// schneiden sich die oberflächen, ist das keine echte eindringtiefe: gemessen wird nur der größte abstand eines
+// innen liegenden knotens von der anderen oberfläche; durchdringen sich nur kanten, ohne dass ein knoten innen
+// liegt, bleibt der wert 0
+//
+// der output enthält die linie zwischen den beiden zeugenpunkten
+
+class VTK_SLICER_COMBINEMODELS_MODULE_LOGIC_EXPORT vtkPolyDataProximityFilter : public vtkPolyDataAlgorithm {
+    double Distance;
+    double PointA[3], PointB[3];
+
+    double StopDistance;
+    double RefitThreshold;
+
+    CachedTree *treeA, *treeB;
+
+public:
+    vtkTypeMacro(vtkPolyDataProximityFilter, vtkPolyDataAlgorithm);
+    static vtkPolyDataProximityFilter* New ();
+
+    // abstand der oberflächen, negativ ist er die größte knotentiefe (siehe oben), 0 bei berührung oder sich nur
+    // durchdringenden kanten
+    vtkGetMacro(Distance, double);
+
+    // bei einem abstand die beiden nächsten punkte, sonst der tiefste knoten und sein nächster punkt auf der anderen
+    // oberfläche
+
+    vtkGetVector3Macro(PointA, double);
+    vtkGetVector3Macro(PointB, double);
+
+    // die suche endet, sobald ein abstand nicht größer als dieser gefunden ist, bei 0 also mit der ersten berührung;
+    // für eine prüfung gegen einen sicherheitsabstand genügt das, Distance ist dann nur eine obere schranke
+    vtkSetClampMacro(StopDistance, double, 0, VTK_DOUBLE_MAX);
+    vtkGetMacro(StopDistance, double);
+
+    // wie beim vtkPolyDataContactFilter
+    vtkSetClampMacro(RefitThreshold, double, 0, VTK_DOUBLE_MAX);
+    vtkGetMacro(RefitThreshold, double);
+
+protected:
+    vtkPolyDataProximityFilter ();
+    ~vtkPolyDataProximityFilter ();
+
+    int RequestData (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector) override;
+
+    void PrintSelf (ostream&, vtkIndent) override {};
+
+private:
+    vtkPolyDataProximityFilter (const vtkPolyDataProximityFilter&) = delete;
+    void operator= (const vtkPolyDataProximityFilter&) = delete;
+
+};
+
+#endif
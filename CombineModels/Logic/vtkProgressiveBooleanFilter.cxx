@@ -0,0 +1,269 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkObjectFactory.h>
+#include <vtkPolyData.h>
+#include <vtkTriangleFilter.h>
+#include <vtkQuadricDecimation.h>
+#include <vtkCallbackCommand.h>
+#include <vtkCommand.h>
+
+#include "vtkProgressiveBooleanFilter.h"
+
+vtkStandardNewMacro(vtkProgressiveBooleanFilter);
+
+vtkProgressiveBooleanFilter::vtkProgressiveBooleanFilter () {
+
+    SetNumberOfInputPorts(2);
+    SetNumberOfOutputPorts(1);
+
+    OperMode = OPER_UNION;
+    TargetReduction = .9;
+    MinimumNumberOfCells = 5000;
+
+    Level = 0;
+
+    timeDecA = 0;
+    timeDecB = 0;
+
+    reductionA = 0;
+    reductionB = 0;
+
+    quit = false;
+
+}
+
+vtkProgressiveBooleanFilter::~vtkProgressiveBooleanFilter () {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+
+    CancelJobs();
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void vtkProgressiveBooleanFilter::CancelJobs () {
+    // der wartende auftrag entfällt, der laufende endet nach seinem aktuellen schritt
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        pending.reset();
+
+        if (running != nullptr) {
+            running->canceled = true;
+        }
+    }
+
+    cond.notify_all();
+}
+
+void vtkProgressiveBooleanFilter::Work () {
+    for (;;) {
+        std::shared_ptr<Job> current;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            cond.wait(lock, [this]() { return quit || pending != nullptr; });
+
+            if (quit) {
+                return;
+            }
+
+            current.swap(pending);
+            running = current;
+        }
+
+        vtkSmartPointer<vtkPolyDataBooleanFilter> bf = vtkSmartPointer<vtkPolyDataBooleanFilter>::New();
+        bf->SetInputData(0, current->a);
+        bf->SetInputData(1, current->b);
+        bf->SetOperMode(current->operMode);
+
+        // der filter meldet seinen fortschritt zwischen den schritten, dort wird ein abgebrochener auftrag beendet
+
+        vtkSmartPointer<vtkCallbackCommand> abort = vtkSmartPointer<vtkCallbackCommand>::New();
+        abort->SetClientData(current.get());
+        abort->SetCallback([](vtkObject *caller, unsigned long, void *clientData, void*) {
+            if (static_cast<Job*>(clientData)->canceled) {
+                static_cast<vtkAlgorithm*>(caller)->AbortExecuteOn();
+            }
+        });
+
+        bf->AddObserver(vtkCommand::ProgressEvent, abort);
+        bf->Update();
+
+        if (!current->canceled) {
+            current->result = vtkSmartPointer<vtkPolyData>::New();
+            current->result->ShallowCopy(bf->GetOutput());
+        }
+
+        current->a = nullptr;
+        current->b = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running.reset();
+        }
+
+        if (!current->canceled) {
+            current->done = true;
+        }
+    }
+}
+
+void vtkProgressiveBooleanFilter::Decimate (vtkPolyData *pd, vtkSmartPointer<vtkPolyData> &dec, vtkMTimeType &time, double &reduction) {
+    if (dec != nullptr && time >= pd->GetMTime() && reduction == TargetReduction) {
+        return;
+    }
+
+    time = pd->GetMTime();
+    reduction = TargetReduction;
+
+    if (pd->GetNumberOfPolys() < MinimumNumberOfCells) {
+        dec = pd;
+        return;
+    }
+
+    vtkSmartPointer<vtkTriangleFilter> tf = vtkSmartPointer<vtkTriangleFilter>::New();
+    tf->SetInputData(pd);
+    tf->PassLinesOff();
+    tf->PassVertsOff();
+
+    vtkSmartPointer<vtkQuadricDecimation> qd = vtkSmartPointer<vtkQuadricDecimation>::New();
+    qd->SetInputConnection(tf->GetOutputPort());
+    qd->SetTargetReduction(TargetReduction);
+    qd->VolumePreservationOn();
+    qd->Update();
+
+    dec = vtkSmartPointer<vtkPolyData>::New();
+    dec->ShallowCopy(qd->GetOutput());
+}
+
+void vtkProgressiveBooleanFilter::StartJob (vtkPolyData *pdA, vtkPolyData *pdB) {
+    // der worker arbeitet auf eigenen kopien, die pipeline darf die eingaben inzwischen verändern
+
+    job->a = vtkSmartPointer<vtkPolyData>::New();
+    job->a->DeepCopy(pdA);
+
+    job->b = vtkSmartPointer<vtkPolyData>::New();
+    job->b->DeepCopy(pdB);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // ein noch wartender auftrag wird samt seinen kopien verworfen
+        pending = job;
+
+        if (running != nullptr) {
+            running->canceled = true;
+        }
+
+        if (!worker.joinable()) {
+            worker = std::thread(&vtkProgressiveBooleanFilter::Work, this);
+        }
+    }
+
+    cond.notify_one();
+}
+
+bool vtkProgressiveBooleanFilter::Poll () {
+    if (job != nullptr && job->done && Level == 0) {
+        Modified();
+        return true;
+    }
+
+    return false;
+}
+
+int vtkProgressiveBooleanFilter::RequestData (vtkInformation *vtkNotUsed(request), vtkInformationVector **inputVector, vtkInformationVector *outputVector) {
+
+    vtkInformation *inInfoA = inputVector[0]->GetInformationObject(0);
+    vtkInformation *inInfoB = inputVector[1]->GetInformationObject(0);
+
+    vtkPolyData *pdA = vtkPolyData::SafeDownCast(inInfoA->Get(vtkDataObject::DATA_OBJECT()));
+    vtkPolyData *pdB = vtkPolyData::SafeDownCast(inInfoB->Get(vtkDataObject::DATA_OBJECT()));
+
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData *output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+    if (job != nullptr && job->timeA == pdA->GetMTime() && job->timeB == pdB->GetMTime() && job->operMode == OperMode) {
+        if (job->done) {
+            output->ShallowCopy(job->result);
+            Level = 1;
+
+            return 1;
+        }
+
+        if (job->coarse != nullptr) {
+            output->ShallowCopy(job->coarse);
+            Level = 0;
+
+            return 1;
+        }
+    }
+
+    // ein älterer auftrag wird beim start des neuen abgebrochen oder verworfen
+
+    job = std::make_shared<Job>();
+    job->timeA = pdA->GetMTime();
+    job->timeB = pdB->GetMTime();
+    job->operMode = OperMode;
+    job->done = false;
+    job->canceled = false;
+
+    vtkSmartPointer<vtkPolyDataBooleanFilter> bf = vtkSmartPointer<vtkPolyDataBooleanFilter>::New();
+    bf->SetOperMode(OperMode);
+
+    if (pdA->GetNumberOfPolys() < MinimumNumberOfCells && pdB->GetNumberOfPolys() < MinimumNumberOfCells) {
+        CancelJobs();
+
+        bf->SetInputData(0, pdA);
+        bf->SetInputData(1, pdB);
+        bf->Update();
+
+        job->result = vtkSmartPointer<vtkPolyData>::New();
+        job->result->ShallowCopy(bf->GetOutput());
+        job->done = true;
+
+        output->ShallowCopy(job->result);
+        Level = 1;
+
+        return 1;
+    }
+
+    Decimate(pdA, decA, timeDecA, reductionA);
+    Decimate(pdB, decB, timeDecB, reductionB);
+
+    bf->SetInputData(0, decA);
+    bf->SetInputData(1, decB);
+    bf->Update();
+
+    job->coarse = vtkSmartPointer<vtkPolyData>::New();
+    job->coarse->ShallowCopy(bf->GetOutput());
+
+    output->ShallowCopy(job->coarse);
+    Level = 0;
+
+    StartJob(pdA, pdB);
+
+    return 1;
+
+}
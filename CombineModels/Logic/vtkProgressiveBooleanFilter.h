@@ -0,0 +1,122 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef __vtkProgressiveBooleanFilter_h
+#define __vtkProgressiveBooleanFilter_h
+
+#include "vtkSlicerCombineModelsModuleLogicExport.h"
+
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSmartPointer.h>
+
+#include "vtkPolyDataBooleanFilter.h"
+
+#ifndef __VTK_WRAP__
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+// boolesche operation in zwei stufen
+//
+// zuerst wird der vtkPolyDataBooleanFilter auf vereinfachten kopien beider eingaben ausgeführt und sofort ausgegeben,
+// die volle auflösung wird in einem eigenen thread berechnet
+//
+// Poll() muss regelmäßig aus dem hauptthread aufgerufen werden, ist das ergebnis fertig, wird der filter als
+// verändert markiert und das nächste Update() gibt es aus
+//
+// es gibt höchstens einen laufenden und einen wartenden auftrag; ein neuer auftrag ersetzt den wartenden und bricht
+// den laufenden nach dessen aktuellem schritt ab
+//
+// die vereinfachten kopien bleiben erhalten, solange sich die eingaben nicht ändern
+
+class VTK_SLICER_COMBINEMODELS_MODULE_LOGIC_EXPORT vtkProgressiveBooleanFilter : public vtkPolyDataAlgorithm {
+    int OperMode;
+    double TargetReduction;
+    int MinimumNumberOfCells;
+
+    int Level;
+
+    vtkSmartPointer<vtkPolyData> decA, decB;
+    vtkMTimeType timeDecA, timeDecB;
+    double reductionA, reductionB;
+
+#ifndef __VTK_WRAP__
+    struct Job {
+        vtkMTimeType timeA, timeB;
+        int operMode;
+        std::atomic<bool> done, canceled;
+        vtkSmartPointer<vtkPolyData> a, b, coarse, result;
+    };
+
+    std::shared_ptr<Job> job;
+
+    // gehören dem worker, geschützt durch mutex
+    std::shared_ptr<Job> pending, running;
+    bool quit;
+
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    void Decimate (vtkPolyData *pd, vtkSmartPointer<vtkPolyData> &dec, vtkMTimeType &time, double &reduction);
+    void StartJob (vtkPolyData *pdA, vtkPolyData *pdB);
+    void CancelJobs ();
+    void Work ();
+#endif
+
+public:
+    vtkTypeMacro(vtkProgressiveBooleanFilter, vtkPolyDataAlgorithm);
+    static vtkProgressiveBooleanFilter* New ();
+
+    vtkSetClampMacro(OperMode, int, OPER_UNION, OPER_DIFFERENCE2);
+    vtkGetMacro(OperMode, int);
+
+    void SetOperModeToUnion () { SetOperMode(OPER_UNION); }
+    void SetOperModeToIntersection () { SetOperMode(OPER_INTERSECTION); }
+    void SetOperModeToDifference () { SetOperMode(OPER_DIFFERENCE); }
+    void SetOperModeToDifference2 () { SetOperMode(OPER_DIFFERENCE2); }
+
+    // anteil der dreiecke, der bei der vereinfachung entfernt wird
+    vtkSetClampMacro(TargetReduction, double, 0, .99);
+    vtkGetMacro(TargetReduction, double);
+
+    // kleinere eingaben werden nicht vereinfacht, sind beide klein, wird sofort in voller auflösung gerechnet
+    vtkSetClampMacro(MinimumNumberOfCells, int, 0, VTK_INT_MAX);
+    vtkGetMacro(MinimumNumberOfCells, int);
+
+    // 0 für das vorläufige, 1 für das vollständige ergebnis
+    vtkGetMacro(Level, int);
+
+    // true, wenn das vollständige ergebnis fertig, aber noch nicht ausgegeben ist
+    bool Poll ();
+
+protected:
+    vtkProgressiveBooleanFilter ();
+    ~vtkProgressiveBooleanFilter ();
+
+    int RequestData (vtkInformation *request, vtkInformationVector **inputVector, vtkInformationVector *outputVector) override;
+
+    void PrintSelf (ostream&, vtkIndent) override {};
+
+private:
+    vtkProgressiveBooleanFilter (const vtkProgressiveBooleanFilter&) = delete;
+    void operator= (const vtkProgressiveBooleanFilter&) = delete;
+
+};
+
+#endif
@@ -0,0 +1,73 @@
+# Runs CombineModelsBatch on two overlapping cubes and on a job with an
+# unsupported input, then checks the exit code, the output file and the report.
+
+string(REPLACE "|" ";" LAUNCH_COMMAND "${LAUNCH_COMMAND}")
+
+file(REMOVE_RECURSE ${WORKING_DIR})
+file(MAKE_DIRECTORY ${WORKING_DIR})
+
+function(write_cube file_name offset)
+  set(points "")
+  foreach(z 0 10)
+    foreach(y 0 10)
+      foreach(x 0 10)
+        math(EXPR px "${x}+${offset}")
+        math(EXPR py "${y}+${offset}")
+        math(EXPR pz "${z}+${offset}")
+        string(APPEND points "${px} ${py} ${pz}\n")
+      endforeach()
+    endforeach()
+  endforeach()
+  file(WRITE ${file_name}
+    "# vtk DataFile Version 3.0\ncube\nASCII\nDATASET POLYDATA\n"
+    "POINTS 8 double\n${points}"
+    "POLYGONS 6 30\n"
+    "4 0 2 3 1\n4 4 5 7 6\n4 0 1 5 4\n4 2 6 7 3\n4 0 4 6 2\n4 1 3 7 5\n"
+    )
+endfunction()
+
+write_cube(${WORKING_DIR}/a.vtk 0)
+write_cube(${WORKING_DIR}/b.vtk 5)
+
+file(WRITE ${WORKING_DIR}/manifest.txt
+  "# overlapping cubes\n"
+  "a.vtk b.vtk difference result.vtk\n"
+  "\n"
+  "a.vtk b.xyz union unsupported.vtk\n"
+  )
+
+execute_process(
+  COMMAND ${LAUNCH_COMMAND} ${BATCH_EXECUTABLE} -j 2 -o report.json manifest.txt
+  WORKING_DIRECTORY ${WORKING_DIR}
+  RESULT_VARIABLE result
+  )
+
+# one job fails, so does the tool
+if(result EQUAL 0)
+  message(FATAL_ERROR "CombineModelsBatch succeeded although a job has an unsupported input")
+endif()
+
+if(NOT EXISTS ${WORKING_DIR}/result.vtk)
+  message(FATAL_ERROR "CombineModelsBatch did not write result.vtk")
+endif()
+
+file(READ ${WORKING_DIR}/report.json report)
+
+# the jobs are reported in the order of the manifest
+string(FIND "${report}" "\"output\": \"result.vtk\"" first)
+string(FIND "${report}" "\"output\": \"unsupported.vtk\"" second)
+
+if(first EQUAL -1 OR second EQUAL -1 OR first GREATER second)
+  message(FATAL_ERROR "Unexpected jobs in the report:\n${report}")
+endif()
+
+string(SUBSTRING "${report}" ${first} -1 first_job)
+string(SUBSTRING "${report}" ${second} -1 second_job)
+
+if(NOT first_job MATCHES "\"status\": \"ok\"[^}]*\"contactLines\": [1-9][0-9]*,[^}]*\"cells\": [1-9]")
+  message(FATAL_ERROR "The difference of the cubes was not reported as successful:\n${report}")
+endif()
+
+if(NOT second_job MATCHES "\"status\": \"failed\",[^}]*\"message\": \"Unsupported input format.\"")
+  message(FATAL_ERROR "The job with the unsupported input was not reported as failed:\n${report}")
+endif()
@@ -0,0 +1,206 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// schreibt das ergebnis einer differenz über jeden sink, liest es wieder ein und vergleicht es mit dem ersten output;
+// der sink bekommt die regionen von A und B einzeln, ihre punkte an der naht sind getrennt
+//
+// CombineModelsSinkTest directory
+
+#include <iostream>
+#include <string>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include <vtkSmartPointer.h>
+#include <vtkPolyData.h>
+#include <vtkCellData.h>
+#include <vtkIntArray.h>
+#include <vtkSphereSource.h>
+#include <vtkCylinderSource.h>
+#include <vtkTriangleFilter.h>
+#include <vtkMassProperties.h>
+#include <vtkFeatureEdges.h>
+#include <vtkCleanPolyData.h>
+#include <vtkPLYReader.h>
+#include <vtkSTLReader.h>
+#include <vtkXMLPolyDataReader.h>
+
+#include "vtkPolyDataBooleanFilter.h"
+#include "Sink.h"
+
+namespace {
+
+double GetVolume (vtkPolyData *pd) {
+    auto tris = vtkSmartPointer<vtkTriangleFilter>::New();
+    tris->SetInputData(pd);
+
+    auto mp = vtkSmartPointer<vtkMassProperties>::New();
+    mp->SetInputConnection(tris->GetOutputPort());
+    mp->Update();
+
+    return mp->GetVolume();
+}
+
+// gleiche punkte werden vorher zusammengeführt, die naht zählt also nicht als rand
+vtkIdType GetNumberOfOpenEdges (vtkPolyData *pd) {
+    auto clean = vtkSmartPointer<vtkCleanPolyData>::New();
+    clean->SetInputData(pd);
+    clean->SetTolerance(0);
+
+    auto edges = vtkSmartPointer<vtkFeatureEdges>::New();
+    edges->SetInputConnection(clean->GetOutputPort());
+    edges->BoundaryEdgesOn();
+    edges->NonManifoldEdgesOn();
+    edges->FeatureEdgesOff();
+    edges->ManifoldEdgesOff();
+    edges->Update();
+
+    return edges->GetOutput()->GetNumberOfCells();
+}
+
+bool Check (bool ok, const std::string &what) {
+    if (!ok) {
+        std::cerr << "Failed: " << what << std::endl;
+    }
+
+    return ok;
+}
+
+// der erste output ist nach regionen umsortiert, verglichen werden daher die paare beider OrigCellIds ohne reihenfolge
+bool SameOrigCellIds (vtkPolyData *a, vtkPolyData *b) {
+    auto GetPairs = [](vtkPolyData *pd, std::vector<std::pair<int, int>> &pairs) {
+        vtkIntArray *idsA = vtkIntArray::SafeDownCast(pd->GetCellData()->GetArray("OrigCellIdsA")),
+            *idsB = vtkIntArray::SafeDownCast(pd->GetCellData()->GetArray("OrigCellIdsB"));
+
+        if (idsA == nullptr || idsB == nullptr) {
+            return false;
+        }
+
+        for (vtkIdType i = 0; i < idsA->GetNumberOfTuples(); i++) {
+            pairs.emplace_back(idsA->GetValue(i), idsB->GetValue(i));
+        }
+
+        std::sort(pairs.begin(), pairs.end());
+
+        return true;
+    };
+
+    std::vector<std::pair<int, int>> pairsA, pairsB;
+
+    return GetPairs(a, pairsA) && GetPairs(b, pairsB) && pairsA == pairsB;
+}
+
+}
+
+int main (int argc, char *argv[]) {
+
+    if (argc < 2) {
+        std::cerr << "Usage: CombineModelsSinkTest directory" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string dir = argv[1];
+
+    auto sphere = vtkSmartPointer<vtkSphereSource>::New();
+    sphere->SetRadius(30);
+    sphere->SetThetaResolution(32);
+    sphere->SetPhiResolution(32);
+
+    auto cylinder = vtkSmartPointer<vtkCylinderSource>::New();
+    cylinder->SetRadius(20);
+    cylinder->SetHeight(75);
+    cylinder->SetResolution(24);
+
+    auto bf = vtkSmartPointer<vtkPolyDataBooleanFilter>::New();
+    bf->SetInputConnection(0, sphere->GetOutputPort());
+    bf->SetInputConnection(1, cylinder->GetOutputPort());
+    bf->SetOperModeToDifference();
+    bf->Update();
+
+    auto ref = vtkSmartPointer<vtkPolyData>::New();
+    ref->DeepCopy(bf->GetOutput(0));
+
+    const double vol = GetVolume(ref);
+
+    bool ok = Check(ref->GetNumberOfCells() > 0, "the difference is not empty")
+        && Check(GetNumberOfOpenEdges(ref) == 0, "the difference is closed");
+
+    if (!ok) {
+        return EXIT_FAILURE;
+    }
+
+    // ply und vtp behalten punkte und polygone, wie sie sind
+
+    {
+        PlySink sink(dir + "/CombineModelsSinkTest.ply");
+        bf->SetResultSink(&sink);
+        bf->Update();
+
+        ok &= Check(bf->GetOutput(0)->GetNumberOfCells() == 0, "the first output is empty with a sink");
+        ok &= Check(sink.GetNumberOfCells() == ref->GetNumberOfCells(), "the ply sink counts the cells of the output");
+
+        auto reader = vtkSmartPointer<vtkPLYReader>::New();
+        reader->SetFileName((dir + "/CombineModelsSinkTest.ply").c_str());
+        reader->Update();
+
+        vtkPolyData *pd = reader->GetOutput();
+
+        ok &= Check(pd->GetNumberOfPoints() == sink.GetNumberOfPoints() && pd->GetNumberOfCells() == ref->GetNumberOfCells(), "the ply has the points of the sink and the cells of the output");
+        ok &= Check(GetNumberOfOpenEdges(pd) == 0, "the ply is closed");
+        ok &= Check(std::abs(GetVolume(pd)-vol) < 1e-6*vol, "the ply has the volume of the output");
+    }
+
+    {
+        VtpSink sink(dir + "/CombineModelsSinkTest.vtp");
+        bf->SetResultSink(&sink);
+        bf->Update();
+
+        auto reader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
+        reader->SetFileName((dir + "/CombineModelsSinkTest.vtp").c_str());
+        reader->Update();
+
+        vtkPolyData *pd = reader->GetOutput();
+
+        ok &= Check(pd->GetNumberOfPoints() == sink.GetNumberOfPoints() && pd->GetNumberOfCells() == ref->GetNumberOfCells(), "the vtp has the points of the sink and the cells of the output");
+        ok &= Check(SameOrigCellIds(pd, ref), "the vtp has the OrigCellIds of the output");
+        ok &= Check(GetNumberOfOpenEdges(pd) == 0, "the vtp is closed");
+        ok &= Check(std::abs(GetVolume(pd)-vol) < 1e-6*vol, "the vtp has the volume of the output");
+    }
+
+    // die stl ist trianguliert und in float, der vtkSTLReader verschweißt gleiche punkte
+
+    {
+        StlSink sink(dir + "/CombineModelsSinkTest.stl");
+        bf->SetResultSink(&sink);
+        bf->Update();
+
+        auto reader = vtkSmartPointer<vtkSTLReader>::New();
+        reader->SetFileName((dir + "/CombineModelsSinkTest.stl").c_str());
+        reader->Update();
+
+        vtkPolyData *pd = reader->GetOutput();
+
+        ok &= Check(pd->GetNumberOfCells() == sink.GetNumberOfCells() && pd->GetNumberOfCells() >= ref->GetNumberOfCells(), "the stl has all triangles");
+        ok &= Check(GetNumberOfOpenEdges(pd) == 0, "the stl is closed");
+        ok &= Check(std::abs(GetVolume(pd)-vol) < 1e-4*vol, "the stl has the volume of the output");
+    }
+
+    bf->SetResultSink(nullptr);
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}